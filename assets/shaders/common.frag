@@ -1,12 +1,7 @@
-#ifdef VERNA_DESKTOP
-#define DRAW_ID int(v.MESH_IDX)
-#endif
-#ifdef VERNA_ANDROID
-uniform int DRAW_ID;
-#endif
+#define DRAW_ID v.MESH_IDX
 
 in VS_OUT {
-    float MESH_IDX;
+    flat int MESH_IDX;
     vec3 position;
     vec2 tex_coords;
     vec3 normal;
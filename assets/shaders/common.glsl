@@ -3,7 +3,9 @@ precision highp float;
 precision highp int;
 #endif
 
+#ifndef VERNA_BINDLESS
 uniform sampler2D material_textures[MAX_MATERIAL_TEXTURES];
+#endif
 uniform sampler2D dirlight_depthmap;
 
 struct MeshData {
@@ -43,17 +45,32 @@ layout(std140) uniform FrameData {
     CameraData camera;
     DirectionLightData direction_light;
 };
-layout(std140) uniform DrawData {
-    MeshData draw_data[MAX_MESHES];
+#ifdef VERNA_DESKTOP
+layout(std430, binding = DRAW_DATA_BINDING) readonly buffer DrawData {
+    MeshData draw_data[];
+};
+#else
+// vertex shader storage blocks are optional in OpenGL ES
+layout(std140, binding = DRAW_DATA_BINDING) uniform DrawData {
+    MeshData draw_data[MAX_UNIFORM_INSTANCES];
 };
-#define TEXTURE0 material_textures[draw_data[DRAW_ID].texture_idx0]
-#define TEXTURE1 material_textures[draw_data[DRAW_ID].texture_idx1]
-#define TEXTURE2 material_textures[draw_data[DRAW_ID].texture_idx2]
-#define TEXTURE3 material_textures[draw_data[DRAW_ID].texture_idx3]
-#define TEXTURE4 material_textures[draw_data[DRAW_ID].texture_idx4]
-#define TEXTURE5 material_textures[draw_data[DRAW_ID].texture_idx5]
-#define TEXTURE6 material_textures[draw_data[DRAW_ID].texture_idx6]
-#define TEXTURE7 material_textures[draw_data[DRAW_ID].texture_idx7]
+#endif
+#ifdef VERNA_BINDLESS
+layout(std430, binding = TEXTURE_TABLE_BINDING) readonly buffer TextureTable {
+    uvec2 texture_handles[];
+};
+#define MATERIAL_TEXTURE(idx) sampler2D(texture_handles[idx])
+#else
+#define MATERIAL_TEXTURE(idx) material_textures[idx]
+#endif
+#define TEXTURE0 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx0)
+#define TEXTURE1 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx1)
+#define TEXTURE2 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx2)
+#define TEXTURE3 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx3)
+#define TEXTURE4 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx4)
+#define TEXTURE5 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx5)
+#define TEXTURE6 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx6)
+#define TEXTURE7 MATERIAL_TEXTURE(draw_data[DRAW_ID].texture_idx7)
 #define MATERIAL_PARAM0 draw_data[DRAW_ID].param0
 #define MATERIAL_PARAM1 draw_data[DRAW_ID].param1
 #define MATERIAL_PARAM2 draw_data[DRAW_ID].param2
@@ -1,8 +1,9 @@
 #ifdef VERNA_DESKTOP
-#define DRAW_ID gl_DrawID
+#define DRAW_ID (gl_BaseInstance + gl_InstanceID)
 #endif
 #ifdef VERNA_ANDROID
-layout(location = 0) uniform int DRAW_ID;
+layout(location = 0) uniform int BASE_INSTANCE;
+#define DRAW_ID (BASE_INSTANCE + gl_InstanceID)
 #endif
 
 layout(location = 0) in vec3 in_position;
@@ -10,7 +11,7 @@ layout(location = 1) in vec2 in_tex_coords;
 layout(location = 2) in vec3 in_normal;
 
 out VS_OUT {
-    float MESH_IDX;
+    flat int MESH_IDX;
     vec3 position;
     vec2 tex_coords;
     vec3 normal;
@@ -18,5 +19,5 @@ out VS_OUT {
 v;
 
 void SetMeshIdx() {
-    v.MESH_IDX = float(DRAW_ID);
+    v.MESH_IDX = DRAW_ID;
 }
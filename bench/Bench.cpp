@@ -0,0 +1,343 @@
+#include "Bench.hpp"
+#include <viverna/core/Debug.hpp>
+#include <viverna/core/VivernaInitializer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+#include <thread>
+
+#ifndef VERNA_BENCH_ASSETS
+#error VERNA_BENCH_ASSETS must point to the assets folder of the build
+#endif
+
+namespace verna::bench {
+
+State::State(uint64_t max_iterations_) : max_iterations(max_iterations_) {}
+
+bool State::KeepRunning() {
+    if (!error.empty())
+        return false;
+    if (iteration == 0)
+        ResumeTiming();
+    if (iteration < max_iterations) {
+        iteration++;
+        return true;
+    }
+    PauseTiming();
+    return false;
+}
+
+void State::PauseTiming() {
+    if (!running)
+        return;
+    elapsed += std::chrono::duration_cast<Nanoseconds>(Clock::now() - start);
+    cpu_elapsed += std::clock() - cpu_start;
+    running = false;
+}
+
+void State::ResumeTiming() {
+    running = true;
+    cpu_start = std::clock();
+    start = Clock::now();
+}
+
+void State::SkipWithError(std::string message) {
+    error = std::move(message);
+    running = false;
+}
+
+void State::SetCounter(std::string name, double value) {
+    counters.emplace_back(std::move(name), value);
+}
+
+Nanoseconds State::CpuTime() const {
+    return Nanoseconds(static_cast<int64_t>(
+        static_cast<double>(cpu_elapsed) * 1e9 / CLOCKS_PER_SEC));
+}
+
+const std::string& AssetsPath() {
+    static const std::string path = VERNA_BENCH_ASSETS;
+    return path;
+}
+
+namespace {
+struct Options {
+    std::string_view filter;
+    std::string_view json_path;
+    double min_time = 0.5;
+    uint32_t repetitions = 3;
+    bool list = false;
+};
+
+struct Run {
+    const Benchmark* benchmark;
+    uint32_t repetition;
+    uint64_t iterations;
+    double real_ns;
+    double cpu_ns;
+    double items_per_second;
+    double bytes_per_second;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time = std::atof(argv[++i]);
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            std::printf(
+                "Usage: viverna_bench [--filter substring] [--json file]\n"
+                "                     [--min-time seconds] "
+                "[--repetitions n] [--list]\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+Run ToRun(const Benchmark& benchmark,
+          uint32_t repetition,
+          const State& state) {
+    Run run;
+    run.benchmark = &benchmark;
+    run.repetition = repetition;
+    run.iterations = state.Iterations();
+    double iterations = static_cast<double>(state.Iterations());
+    double seconds = static_cast<double>(state.Elapsed().count()) * 1e-9;
+    run.real_ns = static_cast<double>(state.Elapsed().count()) / iterations;
+    run.cpu_ns = static_cast<double>(state.CpuTime().count()) / iterations;
+    run.items_per_second =
+        seconds > 0.0 ? static_cast<double>(state.ItemsProcessed()) / seconds
+                      : 0.0;
+    run.bytes_per_second =
+        seconds > 0.0 ? static_cast<double>(state.BytesProcessed()) / seconds
+                      : 0.0;
+    run.counters = state.Counters();
+    return run;
+}
+
+// Grows the iteration count until a run lasts at least min_time
+uint64_t Calibrate(const Benchmark& benchmark,
+                   double min_time,
+                   std::string& error) {
+    constexpr uint64_t MAX_ITERATIONS = 1'000'000'000;
+    uint64_t iterations = 1;
+    for (;;) {
+        State state(iterations);
+        benchmark.func(state);
+        if (!state.Error().empty()) {
+            error = state.Error();
+            return 0;
+        }
+        double seconds = static_cast<double>(state.Elapsed().count()) * 1e-9;
+        if (seconds >= min_time || iterations >= MAX_ITERATIONS)
+            return iterations;
+        // aims a bit over min_time, at most 10 times more iterations
+        double factor = seconds > 0.0 ? 1.4 * min_time / seconds : 10.0;
+        factor = std::clamp(factor, 2.0, 10.0);
+        iterations = std::min(
+            MAX_ITERATIONS,
+            static_cast<uint64_t>(static_cast<double>(iterations) * factor));
+    }
+}
+
+void PrintRun(const Run& run) {
+    double ns = run.real_ns;
+    const char* unit = "ns";
+    if (ns >= 1e6) {
+        ns *= 1e-6;
+        unit = "ms";
+    } else if (ns >= 1e3) {
+        ns *= 1e-3;
+        unit = "us";
+    }
+    std::printf("%-48s %10.3f %s %12llu", run.benchmark->name.c_str(), ns,
+                unit, static_cast<unsigned long long>(run.iterations));
+    if (run.items_per_second > 0.0)
+        std::printf("  %10.3fM items/s", run.items_per_second * 1e-6);
+    if (run.bytes_per_second > 0.0)
+        std::printf("  %10.3f MB/s", run.bytes_per_second * 1e-6);
+    for (const auto& [name, value] : run.counters)
+        std::printf("  %s=%g", name.c_str(), value);
+    std::printf("\n");
+}
+
+void WriteJsonString(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+void WriteJsonRun(std::ostream& out,
+                  const Run& run,
+                  uint32_t repetitions,
+                  std::string_view aggregate) {
+    std::string name = run.benchmark->name;
+    if (!aggregate.empty())
+        name += "_" + std::string(aggregate);
+    out << "    {\n      \"name\": ";
+    WriteJsonString(out, name);
+    out << ",\n      \"run_name\": ";
+    WriteJsonString(out, run.benchmark->name);
+    if (aggregate.empty()) {
+        out << ",\n      \"run_type\": \"iteration\"";
+    } else {
+        out << ",\n      \"run_type\": \"aggregate\""
+            << ",\n      \"aggregate_name\": ";
+        WriteJsonString(out, aggregate);
+    }
+    out << ",\n      \"repetitions\": " << repetitions
+        << ",\n      \"repetition_index\": " << run.repetition
+        << ",\n      \"threads\": 1"
+        << ",\n      \"iterations\": " << run.iterations
+        << ",\n      \"real_time\": " << run.real_ns
+        << ",\n      \"cpu_time\": " << run.cpu_ns
+        << ",\n      \"time_unit\": \"ns\"";
+    if (run.items_per_second > 0.0)
+        out << ",\n      \"items_per_second\": " << run.items_per_second;
+    if (run.bytes_per_second > 0.0)
+        out << ",\n      \"bytes_per_second\": " << run.bytes_per_second;
+    for (const auto& [counter, value] : run.counters) {
+        out << ",\n      ";
+        WriteJsonString(out, counter);
+        out << ": " << value;
+    }
+    out << "\n    }";
+}
+
+bool WriteJson(std::string_view path,
+               const std::vector<Run>& runs,
+               const std::vector<Run>& medians,
+               uint32_t repetitions) {
+    std::ofstream out{std::string(path)};
+    if (!out)
+        return false;
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+                  std::localtime(&now));
+    out.precision(10);
+    out << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n"
+        << "    \"executable\": \"viverna_bench\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ",\n"
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\"\n"
+#else
+        << "    \"library_build_type\": \"debug\"\n"
+#endif
+        << "  },\n  \"benchmarks\": [\n";
+    const char* separator = "";
+    // Google Benchmark lists the aggregates after the repetitions of each
+    // benchmark
+    size_t median = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        out << separator;
+        WriteJsonRun(out, runs[i], repetitions, {});
+        separator = ",\n";
+        bool last_repetition = i + 1 == runs.size()
+                               || runs[i + 1].benchmark != runs[i].benchmark;
+        if (last_repetition && repetitions > 1) {
+            out << separator;
+            WriteJsonRun(out, medians[median++], repetitions, "median");
+        }
+    }
+    out << "\n  ]\n}\n";
+    return out.good();
+}
+
+Run Median(std::vector<Run> repetitions) {
+    auto by_time = [](const Run& a, const Run& b) {
+        return a.real_ns < b.real_ns;
+    };
+    auto middle = repetitions.begin() + repetitions.size() / 2;
+    std::nth_element(repetitions.begin(), middle, repetitions.end(), by_time);
+    return *middle;
+}
+}  // namespace
+
+}  // namespace verna::bench
+
+int main(int argc, char** argv) {
+    using namespace verna::bench;
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 1;
+
+    std::vector<Benchmark> benchmarks;
+    RegisterEcsBenchmarks(benchmarks);
+    RegisterMathBenchmarks(benchmarks);
+    RegisterLoaderBenchmarks(benchmarks);
+    RegisterRendererBenchmarks(benchmarks);
+    auto filtered = [&options](const Benchmark& benchmark) {
+        return benchmark.name.find(options.filter) == std::string::npos;
+    };
+    benchmarks.erase(
+        std::remove_if(benchmarks.begin(), benchmarks.end(), filtered),
+        benchmarks.end());
+    if (options.list) {
+        for (const Benchmark& benchmark : benchmarks)
+            std::printf("%s\n", benchmark.name.c_str());
+        return 0;
+    }
+
+    // engine messages would get mixed with the results
+    verna::SetLogLevel(verna::LogLevel::Warning);
+    verna::VivernaState viverna_state;
+    verna::InitializeViverna(viverna_state);
+    if (viverna_state.GetFlag(verna::VivernaState::ERROR_FLAG)) {
+        std::printf("Could not initialize the engine\n");
+        return 1;
+    }
+
+    std::vector<Run> runs;
+    std::vector<Run> medians;
+    bool failed = false;
+    for (const Benchmark& benchmark : benchmarks) {
+        std::string error;
+        uint64_t iterations = Calibrate(benchmark, options.min_time, error);
+        if (!error.empty()) {
+            verna::FlushLog();
+            std::printf("%-48s ERROR: %s\n", benchmark.name.c_str(),
+                        error.c_str());
+            failed = true;
+            continue;
+        }
+        std::vector<Run> repetitions;
+        for (uint32_t r = 0; r < options.repetitions; r++) {
+            State state(iterations);
+            benchmark.func(state);
+            repetitions.push_back(ToRun(benchmark, r, state));
+        }
+        runs.insert(runs.end(), repetitions.begin(), repetitions.end());
+        medians.push_back(Median(std::move(repetitions)));
+        verna::FlushLog();
+        PrintRun(medians.back());
+    }
+
+    verna::TerminateViverna(viverna_state);
+    if (!options.json_path.empty()
+        && !WriteJson(options.json_path, runs, medians, options.repetitions)) {
+        std::printf("Could not write %s\n",
+                    std::string(options.json_path).c_str());
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+#ifndef VERNA_BENCH_HPP
+#define VERNA_BENCH_HPP
+
+/**
+ * @file Bench.hpp
+ * @brief Minimal microbenchmark harness of viverna_bench. A benchmark does its
+ * setup, then loops on KeepRunning():
+ * void BenchFoo(verna::bench::State& state) {
+ *     std::vector<Foo> foos = MakeFoos(1024);
+ *     while (state.KeepRunning()) {
+ *         for (const Foo& foo : foos)
+ *             verna::bench::DoNotOptimize(foo.Compute());
+ *     }
+ *     state.SetItemsProcessed(state.Iterations() * foos.size());
+ * }
+ * Results are printed as a table and written as JSON with --json, in the
+ * format of Google Benchmark (so its compare.py works on them).
+ *
+ */
+
+#include <viverna/core/Time.hpp>
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace verna::bench {
+
+class State {
+   public:
+    explicit State(uint64_t max_iterations_);
+    // true while the timed loop must go on, the first call starts the clock
+    bool KeepRunning();
+    // excludes per-iteration setup from the measure
+    void PauseTiming();
+    void ResumeTiming();
+    // Ends the benchmark without results (e.g. its data failed to load)
+    void SkipWithError(std::string message);
+    uint64_t Iterations() const { return max_iterations; }
+    void SetItemsProcessed(uint64_t items) { items_processed = items; }
+    void SetBytesProcessed(uint64_t bytes) { bytes_processed = bytes; }
+    // Extra value reported as is (e.g. batches of a frame)
+    void SetCounter(std::string name, double value);
+
+    // wall time of the timed loop
+    Nanoseconds Elapsed() const { return elapsed; }
+    // process CPU time of the timed loop (worker threads included)
+    Nanoseconds CpuTime() const;
+    uint64_t ItemsProcessed() const { return items_processed; }
+    uint64_t BytesProcessed() const { return bytes_processed; }
+    const std::vector<std::pair<std::string, double>>& Counters() const {
+        return counters;
+    }
+    const std::string& Error() const { return error; }
+
+   private:
+    uint64_t iteration = 0;
+    uint64_t max_iterations;
+    bool running = false;
+    TimePoint start;
+    std::clock_t cpu_start = 0;
+    Nanoseconds elapsed = Nanoseconds(0);
+    std::clock_t cpu_elapsed = 0;
+    uint64_t items_processed = 0;
+    uint64_t bytes_processed = 0;
+    std::vector<std::pair<std::string, double>> counters;
+    std::string error;
+};
+
+using BenchmarkFunc = void (*)(State& state);
+
+struct Benchmark {
+    std::string name;
+    BenchmarkFunc func;
+};
+
+// Keeps the compiler from optimizing away value or the code computing it
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile void* sink;
+    sink = &value;
+#endif
+}
+
+// Folder of the assets used by the engine, generated files go there
+const std::string& AssetsPath();
+
+// Benchmarks of each suite, in the order they run
+void RegisterEcsBenchmarks(std::vector<Benchmark>& benchmarks);
+void RegisterMathBenchmarks(std::vector<Benchmark>& benchmarks);
+void RegisterLoaderBenchmarks(std::vector<Benchmark>& benchmarks);
+void RegisterRendererBenchmarks(std::vector<Benchmark>& benchmarks);
+
+}  // namespace verna::bench
+
+#endif
@@ -0,0 +1,100 @@
+#include "Bench.hpp"
+#include <viverna/core/Transform.hpp>
+#include <viverna/ecs/EntityEvent.hpp>
+#include <viverna/ecs/Family.hpp>
+#include <viverna/ecs/System.hpp>
+#include <viverna/ecs/World.hpp>
+#include <viverna/maths/Vec3f.hpp>
+
+#include <vector>
+
+namespace verna::bench {
+
+namespace {
+constexpr size_t NUM_ENTITIES = 10000;
+
+struct Velocity {
+    Vec3f linear;
+};
+
+std::vector<Entity> FillWorld(World& world) {
+    std::vector<Entity> entities;
+    entities.reserve(NUM_ENTITIES);
+    for (size_t i = 0; i < NUM_ENTITIES; i++) {
+        // half of the entities move
+        Entity e = i % 2 == 0 ? world.NewEntity<Transform, Velocity>()
+                              : world.NewEntity<Transform>();
+        entities.push_back(e);
+    }
+    return entities;
+}
+
+template <WorldStorage storage>
+void BenchSetComponent(State& state) {
+    World world(storage);
+    std::vector<Entity> entities = FillWorld(world);
+    Transform transform;
+    while (state.KeepRunning()) {
+        for (Entity e : entities) {
+            transform.position.x += 1.0f;
+            world.SetComponent(e, transform);
+        }
+    }
+    state.SetItemsProcessed(state.Iterations() * entities.size());
+}
+
+template <WorldStorage storage>
+void BenchGetEntitiesInFamily(State& state) {
+    World world(storage);
+    FillWorld(world);
+    auto family = Family::From<Transform, Velocity>();
+    size_t found = 0;
+    while (state.KeepRunning()) {
+        auto entities = world.GetEntitiesInFamily(family);
+        found = entities.size();
+        DoNotOptimize(entities.data());
+    }
+    state.SetItemsProcessed(state.Iterations() * NUM_ENTITIES);
+    state.SetCounter("entities", static_cast<double>(found));
+}
+
+void NoUpdate([[maybe_unused]] World& world,
+              std::vector<Entity>& entities) {
+    DoNotOptimize(entities.data());
+}
+
+// Every entity joins then leaves the system, which resolves the events on
+// its next run
+void BenchResolveEvents(State& state) {
+    World world;
+    std::vector<Entity> entities = FillWorld(world);
+    System system = System::FromFamilyOf<Transform>(NoUpdate);
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        for (Entity e : entities)
+            system.Notify(EntityEvent(e, EntityEvent::ADD));
+        state.ResumeTiming();
+        system.Run(world);
+        state.PauseTiming();
+        for (Entity e : entities)
+            system.Notify(EntityEvent(e, EntityEvent::REMOVE));
+        state.ResumeTiming();
+        system.Run(world);
+    }
+    state.SetItemsProcessed(state.Iterations() * 2 * entities.size());
+}
+}  // namespace
+
+void RegisterEcsBenchmarks(std::vector<Benchmark>& benchmarks) {
+    benchmarks.push_back({"World/SetComponent/SparseSet",
+                          BenchSetComponent<WorldStorage::SparseSet>});
+    benchmarks.push_back({"World/SetComponent/Archetype",
+                          BenchSetComponent<WorldStorage::Archetype>});
+    benchmarks.push_back({"World/GetEntitiesInFamily/SparseSet",
+                          BenchGetEntitiesInFamily<WorldStorage::SparseSet>});
+    benchmarks.push_back({"World/GetEntitiesInFamily/Archetype",
+                          BenchGetEntitiesInFamily<WorldStorage::Archetype>});
+    benchmarks.push_back({"System/ResolveEvents", BenchResolveEvents});
+}
+
+}  // namespace verna::bench
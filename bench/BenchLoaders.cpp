@@ -0,0 +1,303 @@
+#include "Bench.hpp"
+#include <viverna/core/Scene.hpp>
+#include <viverna/core/Transform.hpp>
+#include <viverna/ecs/EntityName.hpp>
+#include <viverna/graphics/Image.hpp>
+#include <viverna/graphics/Material.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/graphics/Shader.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace verna::bench {
+
+namespace {
+constexpr size_t SCENE_ENTITIES = 1000;
+
+std::filesystem::path AssetFile(const std::string& folder,
+                                const std::string& name) {
+    std::filesystem::path dir = std::filesystem::path(AssetsPath()) / folder;
+    std::filesystem::create_directories(dir);
+    return dir / name;
+}
+
+// true the first time in this run: generated files are written again by
+// every run, in case the generator changed
+bool FirstUse(const std::string& name) {
+    static std::vector<std::string> used;
+    if (std::find(used.begin(), used.end(), name) != used.end())
+        return false;
+    used.push_back(name);
+    return true;
+}
+
+// Grid of size * size quads with positions, texture coordinates and normals
+std::string GenerateObj(int size) {
+    std::string name = "bench_grid_" + std::to_string(size) + ".obj";
+    if (!FirstUse(name))
+        return name;
+    std::ofstream out(AssetFile("meshes", name));
+    out << "o grid\n";
+    const int verts = size + 1;
+    for (int y = 0; y < verts; y++)
+        for (int x = 0; x < verts; x++)
+            out << "v " << x << ' ' << 0.01f * static_cast<float>(x ^ y)
+                << ' ' << y << '\n';
+    for (int y = 0; y < verts; y++)
+        for (int x = 0; x < verts; x++)
+            out << "vt " << static_cast<float>(x) / size << ' '
+                << static_cast<float>(y) / size << '\n';
+    out << "vn 0 1 0\n";
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int i = y * verts + x + 1;
+            int corners[4] = {i, i + verts, i + verts + 1, i + 1};
+            out << 'f';
+            for (int c : corners)
+                out << ' ' << c << '/' << c << "/1";
+            out << '\n';
+        }
+    }
+    return name;
+}
+
+template <int size>
+void BenchLoadMeshesOBJ(State& state) {
+    std::string name = GenerateObj(size);
+    auto bytes = std::filesystem::file_size(AssetFile("meshes", name));
+    size_t triangles = 0;
+    while (state.KeepRunning()) {
+        std::vector<Mesh> meshes = LoadMeshesOBJ(name);
+        if (meshes.empty()) {
+            state.SkipWithError("LoadMeshesOBJ failed");
+            return;
+        }
+        triangles = meshes[0].indices.size() / 3;
+    }
+    state.SetItemsProcessed(state.Iterations() * triangles);
+    state.SetBytesProcessed(state.Iterations() * bytes);
+}
+
+template <int size>
+void BenchGenerateLods(State& state) {
+    std::vector<Mesh> meshes = LoadMeshesOBJ(GenerateObj(size));
+    if (meshes.empty()) {
+        state.SkipWithError("LoadMeshesOBJ failed");
+        return;
+    }
+    Mesh& mesh = meshes[0];
+    while (state.KeepRunning())
+        mesh.GenerateLods();
+    state.SetItemsProcessed(state.Iterations() * mesh.indices.size() / 3);
+}
+
+std::vector<uint8_t> MakePixels(int size) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            uint8_t* p = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+            p[0] = static_cast<uint8_t>(x);
+            p[1] = static_cast<uint8_t>(y);
+            p[2] = static_cast<uint8_t>(x ^ y);
+            p[3] = 255;
+        }
+    }
+    return pixels;
+}
+
+// Uncompressed 32 bit TGA
+void WriteTga(const std::filesystem::path& path,
+              int size,
+              const std::vector<uint8_t>& rgba) {
+    std::array<uint8_t, 18> header = {};
+    header[2] = 2;
+    header[12] = static_cast<uint8_t>(size & 0xFF);
+    header[13] = static_cast<uint8_t>(size >> 8);
+    header[14] = header[12];
+    header[15] = header[13];
+    header[16] = 32;
+    // top-left origin, 8 alpha bits
+    header[17] = 0x28;
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+    std::vector<uint8_t> bgra(rgba);
+    for (size_t i = 0; i < bgra.size(); i += 4)
+        std::swap(bgra[i], bgra[i + 2]);
+    out.write(reinterpret_cast<const char*>(bgra.data()), bgra.size());
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void PutBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void PutChunk(std::vector<uint8_t>& out,
+              const char* type,
+              const std::vector<uint8_t>& data) {
+    PutBigEndian(out, static_cast<uint32_t>(data.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBigEndian(out, Crc32(&out[start], out.size() - start));
+}
+
+// RGBA PNG with stored (not deflated) zlib blocks: the decoder still
+// inflates, unfilters and converts every row
+void WritePng(const std::filesystem::path& path,
+              int size,
+              const std::vector<uint8_t>& rgba) {
+    std::vector<uint8_t> rows;
+    const size_t row_bytes = static_cast<size_t>(size) * 4;
+    for (int y = 0; y < size; y++) {
+        rows.push_back(0);
+        auto row = rgba.begin() + static_cast<ptrdiff_t>(y * row_bytes);
+        rows.insert(rows.end(), row, row + static_cast<ptrdiff_t>(row_bytes));
+    }
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : rows) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t offset = 0; offset < rows.size(); offset += 65535) {
+        size_t length = std::min<size_t>(65535, rows.size() - offset);
+        zlib.push_back(offset + length == rows.size() ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(length & 0xFF));
+        zlib.push_back(static_cast<uint8_t>(length >> 8));
+        zlib.push_back(static_cast<uint8_t>(~length & 0xFF));
+        zlib.push_back(static_cast<uint8_t>((~length >> 8) & 0xFF));
+        zlib.insert(zlib.end(), rows.begin() + offset,
+                    rows.begin() + offset + length);
+    }
+    PutBigEndian(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> ihdr;
+    PutBigEndian(ihdr, static_cast<uint32_t>(size));
+    PutBigEndian(ihdr, static_cast<uint32_t>(size));
+    // 8 bits, RGBA, deflate, adaptive filtering, no interlace
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});
+    PutChunk(png, "IHDR", ihdr);
+    PutChunk(png, "IDAT", zlib);
+    PutChunk(png, "IEND", {});
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(png.data()), png.size());
+}
+
+// Image::Load is LoadRawAsset followed by Image::LoadFromBuffer
+template <bool png>
+void BenchImageLoad(State& state) {
+    constexpr int size = 1024;
+    std::string name = std::string("bench_") + std::to_string(size)
+                       + (png ? ".png" : ".tga");
+    std::filesystem::path path = AssetFile("textures", name);
+    if (FirstUse(name)) {
+        if constexpr (png)
+            WritePng(path, size, MakePixels(size));
+        else
+            WriteTga(path, size, MakePixels(size));
+    }
+    auto bytes = std::filesystem::file_size(path);
+    while (state.KeepRunning()) {
+        Image image = Image::Load(std::filesystem::path("textures") / name);
+        if (!image.IsValid()) {
+            state.SkipWithError("Image::Load failed");
+            return;
+        }
+        DoNotOptimize(image.Pixels());
+    }
+    state.SetItemsProcessed(state.Iterations() * size * size);
+    state.SetBytesProcessed(state.Iterations() * bytes);
+}
+
+void FillScene(Scene& scene) {
+    ShaderId shader = scene.shader_manager.LoadShader("unlit");
+    Mesh cube = LoadPrimitiveMesh(PrimitiveMeshType::Cube);
+    Material material;
+    Transform transform;
+    for (size_t i = 0; i < SCENE_ENTITIES; i++) {
+        transform.position = Vec3f(static_cast<float>(i % 32),
+                                   static_cast<float>(i / 32), 0.0f);
+        Entity e = scene.world.NewEntity<EntityName, Material, Mesh, ShaderId,
+                                         Transform>();
+        scene.world.SetComponents(e, EntityName("entity_" + std::to_string(i)),
+                                  material, cube, shader, transform);
+    }
+}
+
+// the scene loaded by BenchSceneLoad
+std::filesystem::path SceneFile() {
+    return AssetFile("scenes", "bench_scene.viv");
+}
+
+void BenchSceneSave(State& state) {
+    Scene scene;
+    FillScene(scene);
+    std::filesystem::path path = SceneFile();
+    FirstUse(path.filename().string());
+    while (state.KeepRunning())
+        scene.SaveFile(path);
+    scene.ReleaseResources();
+    state.SetItemsProcessed(state.Iterations() * SCENE_ENTITIES);
+    state.SetBytesProcessed(state.Iterations()
+                            * std::filesystem::file_size(path));
+}
+
+void BenchSceneLoad(State& state) {
+    std::filesystem::path path = SceneFile();
+    if (FirstUse(path.filename().string())) {
+        Scene scene;
+        FillScene(scene);
+        scene.SaveFile(path);
+        scene.ReleaseResources();
+    }
+    Scene scene;
+    while (state.KeepRunning()) {
+        if (!scene.LoadFile("bench_scene")) {
+            state.SkipWithError("Scene::LoadFile failed");
+            break;
+        }
+    }
+    scene.ReleaseResources();
+    state.SetItemsProcessed(state.Iterations() * SCENE_ENTITIES);
+    state.SetBytesProcessed(state.Iterations()
+                            * std::filesystem::file_size(path));
+}
+}  // namespace
+
+void RegisterLoaderBenchmarks(std::vector<Benchmark>& benchmarks) {
+    benchmarks.push_back({"LoadMeshesOBJ/Grid64", BenchLoadMeshesOBJ<64>});
+    benchmarks.push_back({"LoadMeshesOBJ/Grid256", BenchLoadMeshesOBJ<256>});
+    benchmarks.push_back({"Mesh/GenerateLods/Grid256", BenchGenerateLods<256>});
+    benchmarks.push_back({"Image/Load/TGA1024", BenchImageLoad<false>});
+    benchmarks.push_back({"Image/Load/PNG1024", BenchImageLoad<true>});
+    benchmarks.push_back({"Scene/SaveFile", BenchSceneSave});
+    benchmarks.push_back({"Scene/LoadFile", BenchSceneLoad});
+}
+
+}  // namespace verna::bench
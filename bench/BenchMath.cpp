@@ -0,0 +1,99 @@
+#include "Bench.hpp"
+#include <viverna/core/Transform.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include <viverna/maths/Quaternion.hpp>
+#include <viverna/maths/Vec3f.hpp>
+
+#include <vector>
+
+namespace verna::bench {
+
+namespace {
+constexpr size_t COUNT = 1024;
+
+std::vector<Transform> MakeTransforms() {
+    std::vector<Transform> transforms(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        auto f = static_cast<float>(i);
+        transforms[i].position = Vec3f(f, 0.5f * f, -f);
+        transforms[i].rotation =
+            Quaternion(Vec3f(0.0f, 1.0f, 0.0f), 0.01f * f);
+        transforms[i].scale = Vec3f(1.0f + 0.001f * f);
+    }
+    return transforms;
+}
+
+// invertible matrices, as the renderer gets them
+std::vector<Mat4f> MakeMatrices() {
+    std::vector<Mat4f> matrices;
+    matrices.reserve(COUNT);
+    for (const Transform& transform : MakeTransforms())
+        matrices.push_back(transform.GetMatrix());
+    return matrices;
+}
+
+void BenchMultiply(State& state) {
+    std::vector<Mat4f> matrices = MakeMatrices();
+    Mat4f view_projection =
+        Mat4f::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f)
+        * Mat4f::Rotation(Vec3f(1.0f, 0.0f, 0.0f), 0.3f);
+    while (state.KeepRunning()) {
+        for (const Mat4f& model : matrices)
+            DoNotOptimize(view_projection * model);
+    }
+    state.SetItemsProcessed(state.Iterations() * matrices.size());
+}
+
+void BenchInverted(State& state) {
+    std::vector<Mat4f> matrices = MakeMatrices();
+    while (state.KeepRunning()) {
+        for (const Mat4f& model : matrices)
+            DoNotOptimize(model.Inverted());
+    }
+    state.SetItemsProcessed(state.Iterations() * matrices.size());
+}
+
+void BenchMultiplyMany(State& state) {
+    std::vector<Mat4f> matrices = MakeMatrices();
+    std::vector<Mat4f> results(matrices.size());
+    Mat4f view_projection =
+        Mat4f::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f)
+        * Mat4f::Rotation(Vec3f(1.0f, 0.0f, 0.0f), 0.3f);
+    while (state.KeepRunning()) {
+        Mat4f::MultiplyMany(view_projection, matrices.data(), results.data(),
+                            matrices.size());
+        DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.Iterations() * matrices.size());
+}
+
+// normal matrices, computed for every draw
+void BenchInvertedTransposed(State& state) {
+    std::vector<Mat4f> matrices = MakeMatrices();
+    while (state.KeepRunning()) {
+        for (const Mat4f& model : matrices)
+            DoNotOptimize(model.InvertedTransposed());
+    }
+    state.SetItemsProcessed(state.Iterations() * matrices.size());
+}
+
+void BenchGetMatrix(State& state) {
+    std::vector<Transform> transforms = MakeTransforms();
+    while (state.KeepRunning()) {
+        for (const Transform& transform : transforms)
+            DoNotOptimize(transform.GetMatrix());
+    }
+    state.SetItemsProcessed(state.Iterations() * transforms.size());
+}
+}  // namespace
+
+void RegisterMathBenchmarks(std::vector<Benchmark>& benchmarks) {
+    benchmarks.push_back({"Mat4f/Multiply", BenchMultiply});
+    benchmarks.push_back({"Mat4f/MultiplyMany", BenchMultiplyMany});
+    benchmarks.push_back({"Mat4f/Inverted", BenchInverted});
+    benchmarks.push_back(
+        {"Mat4f/InvertedTransposed", BenchInvertedTransposed});
+    benchmarks.push_back({"Transform/GetMatrix", BenchGetMatrix});
+}
+
+}  // namespace verna::bench
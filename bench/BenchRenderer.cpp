@@ -0,0 +1,61 @@
+#include "Bench.hpp"
+#include <viverna/core/Scene.hpp>
+#include <viverna/core/Transform.hpp>
+#include <viverna/graphics/Material.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/graphics/Renderer.hpp>
+
+#include <array>
+#include <vector>
+
+namespace verna::bench {
+
+namespace {
+// A whole frame: culling, batch building, streaming of the instances to the
+// (null) backend and draw submission
+template <size_t count>
+void BenchFrame(State& state) {
+    ShaderId shader = Scene::GetActive().shader_manager.LoadShader("unlit");
+    if (!shader.IsValid()) {
+        state.SkipWithError("could not load the unlit shader");
+        return;
+    }
+    std::array meshes = {LoadPrimitiveMesh(PrimitiveMeshType::Cube),
+                         LoadPrimitiveMesh(PrimitiveMeshType::Pyramid),
+                         LoadPrimitiveMesh(PrimitiveMeshType::Sphere)};
+    std::array<Material, 4> materials;
+    for (size_t i = 0; i < materials.size(); i++)
+        materials[i].parameters[0] = static_cast<float>(i);
+    // grid in front of the default camera
+    constexpr size_t columns = 100;
+    std::vector<Transform> transforms(count);
+    for (size_t i = 0; i < count; i++) {
+        transforms[i].position =
+            Vec3f(static_cast<float>(i % columns) - 0.5f * columns,
+                  static_cast<float>(i / columns) - 0.5f * count / columns,
+                  120.0f);
+    }
+
+    while (state.KeepRunning()) {
+        NextFrame();
+        for (size_t i = 0; i < count; i++) {
+            Render(meshes[i % meshes.size()], materials[i % materials.size()],
+                   transforms[i], shader);
+        }
+        Draw();
+    }
+    RendererStats stats = GetRendererStats();
+    state.SetItemsProcessed(state.Iterations() * count);
+    state.SetCounter("batches", stats.batches);
+    state.SetCounter("draw_commands", stats.draw_commands);
+    state.SetCounter("instances", stats.instances);
+    Scene::GetActive().shader_manager.FreeShader(shader);
+}
+}  // namespace
+
+void RegisterRendererBenchmarks(std::vector<Benchmark>& benchmarks) {
+    benchmarks.push_back({"Renderer/Frame/1000", BenchFrame<1000>});
+    benchmarks.push_back({"Renderer/Frame/10000", BenchFrame<10000>});
+}
+
+}  // namespace verna::bench
@@ -1,43 +1,164 @@
 #ifndef VERNA_DEBUG_HPP
 #define VERNA_DEBUG_HPP
 
+/**
+ * @file Debug.hpp
+ * @brief Logging and assertions. Messages are queued and written by a
+ * background thread: arguments are copied as they are and turned into text
+ * there, so prefer VERNA_LOGI("Loaded ", name, " in ", ms, " ms") to building
+ * a std::string. Messages below the level set with SetLogLevel() are not even
+ * evaluated.
+ * Info messages are compiled only in debug builds, warnings and errors also in
+ * release builds with -DVIVERNA_RELEASE_LOGS=ON.
+ *
+ */
+
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace verna {
+enum class LogLevel : uint8_t { Info, Warning, Error, None };
+
+/**
+ * @brief Discards messages less severe than level. Default is
+ * LogLevel::Info
+ *
+ * @param level LogLevel::None disables logging
+ */
+void SetLogLevel(LogLevel level);
+LogLevel GetLogLevel();
+// Messages lost because the queue was full
+uint64_t GetDroppedLogCount();
+// Blocks until every message queued so far is written
+void FlushLog();
+
+namespace detail {
+extern std::atomic<LogLevel> log_level;
+
+inline bool ShouldLog(LogLevel level) {
+    return level >= log_level.load(std::memory_order_relaxed);
+}
+
+// encoded arguments of a message, bigger messages skip the queue
+constexpr size_t LOG_MESSAGE_CAPACITY = 480;
+
+enum class LogArg : uint8_t { String, Char, Bool, Int, Uint, Float };
+
+// Writes the arguments as tag + raw bytes, keeps counting once out of space
+class LogEncoder {
+   public:
+    LogEncoder(std::byte* data_, size_t capacity_)
+        : data(data_), capacity(capacity_), size(0) {}
+
+    template <typename T>
+    void Add(const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            Put(LogArg::Bool, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            Put(LogArg::Char, value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            Put(LogArg::Int, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<T>) {
+            Put(LogArg::Uint, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            Put(LogArg::Float, static_cast<double>(value));
+        } else if constexpr (std::is_enum_v<T>) {
+            Add(static_cast<std::underlying_type_t<T>>(value));
+        } else {
+            std::string_view str(value);
+            Put(LogArg::String, static_cast<uint32_t>(str.size()));
+            Write(str.data(), str.size());
+        }
+    }
+    size_t Size() const { return size; }
+    bool Fits() const { return size <= capacity; }
+
+   private:
+    template <typename T>
+    void Put(LogArg tag, T value) {
+        Write(&tag, sizeof(tag));
+        Write(&value, sizeof(value));
+    }
+    void Write(const void* src, size_t bytes) {
+        if (size <= capacity && bytes <= capacity - size)
+            std::memcpy(data + size, src, bytes);
+        size += bytes;
+    }
 
-namespace verna::detail {
-void LogInfo(std::string_view message);
-void LogWarning(std::string_view message);
-void LogError(std::string_view message);
-}  // namespace verna::detail
+    std::byte* data;
+    size_t capacity;
+    size_t size;
+};
+
+void EnqueueLog(LogLevel level, const std::byte* data, size_t size);
+// Writes on the calling thread, after the queued messages
+void WriteLogNow(LogLevel level, const std::byte* data, size_t size);
+
+template <typename... Args>
+void Log(LogLevel level, const Args&... args) {
+    std::array<std::byte, LOG_MESSAGE_CAPACITY> buffer;
+    LogEncoder encoder(buffer.data(), buffer.size());
+    (encoder.Add(args), ...);
+    if (encoder.Fits()) {
+        EnqueueLog(level, buffer.data(), encoder.Size());
+        return;
+    }
+    std::vector<std::byte> large(encoder.Size());
+    LogEncoder large_encoder(large.data(), large.size());
+    (large_encoder.Add(args), ...);
+    WriteLogNow(level, large.data(), large.size());
+}
+}  // namespace detail
+}  // namespace verna
+
+#define VERNA_LOG_(level, ...)                                              \
+    (verna::detail::ShouldLog(level) ? verna::detail::Log(level, __VA_ARGS__) \
+                                     : void())
+
+#ifndef NDEBUG
+#define VERNA_LOGI(...) VERNA_LOG_(verna::LogLevel::Info, __VA_ARGS__)
+#define VERNA_LOGI_IF(cond, ...) \
+    if (cond)                    \
+    VERNA_LOGI(__VA_ARGS__)
+#else
+#define VERNA_LOGI(...)
+#define VERNA_LOGI_IF(cond, ...)
+#endif
+
+#if !defined(NDEBUG) || defined(VERNA_RELEASE_LOGS)
+#define VERNA_LOGW(...) VERNA_LOG_(verna::LogLevel::Warning, __VA_ARGS__)
+#define VERNA_LOGE(...) VERNA_LOG_(verna::LogLevel::Error, __VA_ARGS__)
+#define VERNA_LOGW_IF(cond, ...) \
+    if (cond)                    \
+    VERNA_LOGW(__VA_ARGS__)
+#define VERNA_LOGE_IF(cond, ...) \
+    if (cond)                    \
+    VERNA_LOGE(__VA_ARGS__)
+#else
+#define VERNA_LOGW(...)
+#define VERNA_LOGE(...)
+#define VERNA_LOGW_IF(cond, ...)
+#define VERNA_LOGE_IF(cond, ...)
+#endif
 
 #ifndef NDEBUG
-#define VERNA_LOGI(x) verna::detail::LogInfo(x)
-#define VERNA_LOGW(x) verna::detail::LogWarning(x)
-#define VERNA_LOGE(x) verna::detail::LogError(x)
-#define VERNA_LOGI_IF(cond, x) \
-    if (cond)                  \
-    VERNA_LOGI(x)
-#define VERNA_LOGW_IF(cond, x) \
-    if (cond)                  \
-    VERNA_LOGW(x)
-#define VERNA_LOGE_IF(cond, x) \
-    if (cond)                  \
-    VERNA_LOGE(x)
-#define VERNA_ASSERT(x)                                      \
-    if (!(x)) {                                              \
-        VERNA_LOGE("ASSERT FAILED! File " __FILE__ ", line " \
-                   + std::to_string(__LINE__));              \
-        assert(false);                                       \
+// the message is flushed before aborting
+#define VERNA_ASSERT(x)                                                   \
+    if (!(x)) {                                                           \
+        VERNA_LOGE("ASSERT FAILED! File " __FILE__ ", line ", __LINE__); \
+        verna::FlushLog();                                                \
+        assert(false);                                                    \
     }
 #else
-#define VERNA_LOGI(x)
-#define VERNA_LOGW(x)
-#define VERNA_LOGE(x)
-#define VERNA_LOGI_IF(cond, x)
-#define VERNA_LOGW_IF(cond, x)
-#define VERNA_LOGE_IF(cond, x)
 #define VERNA_ASSERT(x)
 #endif
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,100 @@
+#ifndef VERNA_PROFILER_HPP
+#define VERNA_PROFILER_HPP
+
+/**
+ * @file Profiler.hpp
+ * @brief CPU zones, plus GPU zones for the render passes, written as a
+ * Chrome/Perfetto JSON trace (open it in ui.perfetto.dev or chrome://tracing).
+ * Zones are only compiled with -DVIVERNA_PROFILER=ON, otherwise the macros
+ * expand to nothing and the functions are empty.
+ * Usage:
+ * void Update() {
+ *     VERNA_PROFILE_FUNCTION();
+ *     {
+ *         VERNA_PROFILE_SCOPE("Physics");
+ *         ...
+ *     }
+ * }
+ * verna::profiler::SetEnabled(true);
+ * ...
+ * verna::profiler::WriteTrace("trace.json");
+ *
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#if defined(VERNA_PROFILER)
+#define VERNA_PROFILE_CONCAT_(a, b) a##b
+#define VERNA_PROFILE_CONCAT(a, b) VERNA_PROFILE_CONCAT_(a, b)
+// name must be a string literal (or outlive the trace)
+#define VERNA_PROFILE_SCOPE(name) \
+    verna::profiler::Zone VERNA_PROFILE_CONCAT(verna_zone_, __LINE__)(name)
+#define VERNA_PROFILE_FUNCTION() VERNA_PROFILE_SCOPE(__func__)
+#else
+#define VERNA_PROFILE_SCOPE(name)
+#define VERNA_PROFILE_FUNCTION()
+#endif
+
+namespace verna::profiler {
+/**
+ * @brief Starts or stops recording zones. Disabled by default: a disabled
+ * zone costs an atomic load
+ *
+ * @param enabled
+ */
+void SetEnabled(bool enabled);
+bool IsEnabled();
+// Discards every recorded zone
+void Clear();
+/**
+ * @brief Names the calling thread in the trace
+ *
+ * @param name Thread name (copied)
+ */
+void SetThreadName(std::string_view name);
+/**
+ * @brief Writes the zones recorded so far in Chrome trace event format
+ *
+ * @param path Output file, usually with .json extension
+ * @return false if the file could not be written or the profiler is
+ * compiled out
+ */
+bool WriteTrace(const std::filesystem::path& path);
+
+#if defined(VERNA_PROFILER)
+namespace detail {
+extern std::atomic<bool> enabled;
+// nanoseconds since the profiler started
+int64_t Now();
+void AddZone(const char* name, int64_t start, int64_t end);
+}  // namespace detail
+
+// Records the time between construction and destruction on the calling
+// thread's track
+class Zone {
+   public:
+    explicit Zone(const char* name_) : name(nullptr), start(0) {
+        if (detail::enabled.load(std::memory_order_relaxed)) {
+            name = name_;
+            start = detail::Now();
+        }
+    }
+    ~Zone() {
+        if (name != nullptr)
+            detail::AddZone(name, start, detail::Now());
+    }
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+   private:
+    // nullptr if the profiler was disabled at construction
+    const char* name;
+    int64_t start;
+};
+#endif
+}  // namespace verna::profiler
+
+#endif
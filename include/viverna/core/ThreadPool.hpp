@@ -1,16 +1,33 @@
 #ifndef VERNA_THREAD_POOL_HPP
 #define VERNA_THREAD_POOL_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace verna {
 
+class TaskGroup;
+
+/**
+ * @brief Work-stealing thread pool. Every worker owns a lock-free deque:
+ * tasks spawned by a worker go to its own deque, idle workers steal from the
+ * others. Tasks submitted by other threads go through a shared injection
+ * queue. Task nodes are recycled and small callables are stored inline, so
+ * steady-state submission doesn't allocate
+ *
+ */
 class ThreadPool {
    public:
     static ThreadPool& Get();
@@ -20,27 +37,157 @@ class ThreadPool {
         auto task = std::make_shared<std::packaged_task<ret_t()>>(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...));
         std::future result = task->get_future();
-        {
-            std::lock_guard lock(tasks_mtx);
-            if (!stop)
-                tasks.emplace([task]() { (*task)(); });
-            else
-                return std::future<ret_t>();
-        }
-        condition.notify_one();
+        if (stop.load())
+            return std::future<ret_t>();
+        Submit([task]() { (*task)(); });
         return result;
     }
+    /**
+     * @brief Fire-and-forget version of Enqueue. Doesn't allocate if fn fits
+     * in Task::INLINE_SIZE bytes
+     *
+     * @param fn Callable taking no arguments
+     */
+    template <typename F>
+    void Submit(F&& fn) {
+        Push(MakeTask(std::forward<F>(fn), nullptr));
+    }
+    /**
+     * @brief Splits [begin, end) into ranges of (at most) grain elements and
+     * processes them on the pool. The calling thread takes part in the work
+     * and returns when every range is done
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Max number of elements per range
+     * @param fn fn(size_t range_begin, size_t range_end)
+     */
+    template <typename F>
+    void ParallelFor(size_t begin, size_t end, size_t grain, F&& fn);
+    size_t NumThreads() const { return workers.size(); }
+    // true if the caller is one of the pool threads
+    static bool IsWorkerThread();
     ~ThreadPool();
 
    private:
-    ThreadPool(size_t num_threads);
-    void ThreadFunction();
-    std::vector<std::thread> threads;
-    std::queue<std::function<void()>> tasks;
-    std::mutex tasks_mtx;
+    friend class TaskGroup;
+    struct Task {
+        static constexpr size_t INLINE_SIZE = 48;
+        // Runs the stored callable, then destroys it
+        void (*run)(Task& task) = nullptr;
+        TaskGroup* group = nullptr;
+        Task* next = nullptr;
+        alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    };
+    struct Worker;
+
+    explicit ThreadPool(size_t num_threads);
+    void ThreadFunction(size_t index);
+    template <typename F>
+    Task* MakeTask(F&& fn, TaskGroup* group);
+    Task* AllocTask();
+    void FreeTask(Task* task);
+    // Own deque for workers, injection queue for any other thread
+    void Push(Task* task);
+    // Own deque, injection queue, then the other workers' deques
+    Task* FindTask();
+    void Execute(Task* task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    // Tasks submitted from outside the pool (intrusive FIFO)
+    Task* injection_head = nullptr;
+    Task* injection_tail = nullptr;
+    std::mutex injection_mtx;
+    // Recycled task nodes shared by every thread (intrusive stack)
+    Task* free_tasks = nullptr;
+    std::vector<std::unique_ptr<Task[]>> task_blocks;
+    std::mutex free_mtx;
+    // Tasks pushed but not taken yet
+    std::atomic<size_t> queued = 0;
+    std::atomic<uint32_t> sleeping = 0;
+    std::mutex sleep_mtx;
     std::condition_variable condition;
-    bool stop;
+    std::atomic<bool> stop = false;
+};
+
+/**
+ * @brief Set of tasks that can be waited on. The waiting thread runs pool
+ * tasks until the whole group is done, so groups can be nested (e.g. waiting
+ * inside a task) without deadlocks
+ *
+ */
+class TaskGroup {
+   public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup() { Wait(); }
+    template <typename F>
+    void Run(F&& fn) {
+        ThreadPool& pool = ThreadPool::Get();
+        pending.fetch_add(1);
+        pool.Push(pool.MakeTask(std::forward<F>(fn), this));
+    }
+    // Helps running tasks until every task of the group has finished
+    void Wait();
+
+   private:
+    friend class ThreadPool;
+    std::atomic<uint32_t> pending = 0;
 };
+
+template <typename F>
+ThreadPool::Task* ThreadPool::MakeTask(F&& fn, TaskGroup* group) {
+    using fn_t = std::decay_t<F>;
+    Task* task = AllocTask();
+    task->group = group;
+    if constexpr (sizeof(fn_t) <= Task::INLINE_SIZE
+                  && alignof(fn_t) <= alignof(std::max_align_t)) {
+        new (task->storage) fn_t(std::forward<F>(fn));
+        task->run = [](Task& t) {
+            fn_t* f = std::launder(reinterpret_cast<fn_t*>(t.storage));
+            (*f)();
+            f->~fn_t();
+        };
+    } else {
+        // too big: the callable lives on the heap
+        auto* heap_fn = new fn_t(std::forward<F>(fn));
+        new (task->storage) fn_t*(heap_fn);
+        task->run = [](Task& t) {
+            fn_t* f = *std::launder(reinterpret_cast<fn_t**>(t.storage));
+            (*f)();
+            delete f;
+        };
+    }
+    return task;
+}
+
+template <typename F>
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grain, F&& fn) {
+    if (begin >= end)
+        return;
+    grain = std::max<size_t>(grain, 1);
+    size_t num_ranges = (end - begin + grain - 1) / grain;
+    if (num_ranges == 1 || workers.empty()) {
+        for (size_t b = begin; b < end; b += grain)
+            fn(b, std::min(b + grain, end));
+        return;
+    }
+    std::atomic<size_t> next_range = 0;
+    auto work = [&]() {
+        size_t r;
+        while ((r = next_range.fetch_add(1)) < num_ranges) {
+            size_t b = begin + r * grain;
+            fn(b, std::min(b + grain, end));
+        }
+    };
+    TaskGroup group;
+    size_t num_helpers = std::min(num_ranges - 1, workers.size());
+    for (size_t i = 0; i < num_helpers; i++)
+        group.Run([&work]() { work(); });
+    work();
+    group.Wait();
+}
 }  // namespace verna
 
 #endif
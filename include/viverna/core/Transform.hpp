@@ -22,18 +22,22 @@ struct Transform {
     constexpr Vec3f Up() const { return Forward().Cross(Right()).Normalized(); }
 
     constexpr Mat4f GetMatrix() const {
-        Mat4f t_r = rotation.AsMatrix();
-        t_r[12] = position.x;
-        t_r[13] = position.y;
-        t_r[14] = position.z;
-
-        Mat4f s;
-        s[0] = scale.x;
-        s[5] = scale.y;
-        s[10] = scale.z;
-        s[15] = 1.0f;
-
-        return t_r * s;
+#if defined(VERNA_SIMD)
+        if (!VERNA_IS_CONSTANT_EVALUATED())
+            return detail::TransformMatrix(rotation, scale, position);
+#endif
+        // translation * rotation * scale, with the scale applied to the
+        // columns instead of a full matrix product
+        Mat4f t_r_s = rotation.AsMatrix();
+        for (size_t i = 0; i < 3; i++) {
+            t_r_s[i] *= scale.x;
+            t_r_s[4 + i] *= scale.y;
+            t_r_s[8 + i] *= scale.z;
+        }
+        t_r_s[12] = position.x;
+        t_r_s[13] = position.y;
+        t_r_s[14] = position.z;
+        return t_r_s;
     }
 
     constexpr bool IsAlmostEqual(const Transform& other,
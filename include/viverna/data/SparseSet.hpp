@@ -10,8 +10,24 @@ class SparseSet {
    public:
     using index_t = uint32_t;
     void Add(K k);
-    void Remove(K k);
+    /**
+     * @brief Swap-and-pop removal: the last dense element takes the place of
+     * the removed one. Containers parallel to the dense array should mirror
+     * the same swap
+     *
+     * @param k Key to remove
+     * @return true if k was found
+     */
+    bool Remove(K k);
+    /**
+     * @brief Removes every key and keeps the capacity, so that refilling the
+     * set doesn't allocate. Stale sparse entries are harmless: lookups check
+     * them against the dense array
+     *
+     */
     void Clear();
+    // Releases the memory kept by Clear()
+    void ShrinkToFit();
     auto Size() const { return dense.size(); }
     bool Contains(K k) const;
     bool GetIndex(K k, index_t& out_index) const;
@@ -49,17 +65,28 @@ bool SparseSet<K>::GetIndex(K k, index_t& out_index) const {
 }
 
 template <typename K>
-void SparseSet<K>::Remove(K k) {
+bool SparseSet<K>::Remove(K k) {
     index_t i;
-    if (GetIndex(k, i))
-        sparse[k] = static_cast<index_t>(-1);
+    if (!GetIndex(k, i))
+        return false;
+    K last = dense.back();
+    dense[i] = last;
+    sparse[last] = i;
+    dense.pop_back();
+    sparse[k] = static_cast<index_t>(-1);
+    return true;
 }
 
 template <typename K>
 void SparseSet<K>::Clear() {
     dense.clear();
+}
+
+template <typename K>
+void SparseSet<K>::ShrinkToFit() {
     dense.shrink_to_fit();
-    sparse.clear();
+    if (dense.empty())
+        sparse.clear();
     sparse.shrink_to_fit();
 }
 
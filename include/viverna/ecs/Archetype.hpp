@@ -0,0 +1,125 @@
+#ifndef VERNA_ARCHETYPE_HPP
+#define VERNA_ARCHETYPE_HPP
+
+#include "Entity.hpp"
+#include "Family.hpp"
+#include <viverna/core/TypeId.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace verna {
+
+// Type-erased array of components, one per chunk row
+class BaseComponentColumn {
+   public:
+    BaseComponentColumn() = default;
+    virtual ~BaseComponentColumn() = default;
+    virtual TypeId GetType() const = 0;
+    virtual size_t ElementSize() const = 0;
+    virtual size_t Size() const = 0;
+    virtual std::unique_ptr<BaseComponentColumn> NewEmpty(
+        size_t capacity) const = 0;
+    // Appends src[src_index]; src must hold the same component type
+    virtual void PushFrom(BaseComponentColumn& src, uint32_t src_index) = 0;
+    // Overwrites this[dst_index] with src[src_index] (same component type)
+    virtual void AssignFrom(uint32_t dst_index,
+                            BaseComponentColumn& src,
+                            uint32_t src_index) = 0;
+    virtual void PopBack() = 0;
+};
+
+template <typename C>
+class ComponentColumn : public BaseComponentColumn {
+   public:
+    TypeId GetType() const override { return GetTypeId<C>(); }
+    size_t ElementSize() const override { return sizeof(C); }
+    size_t Size() const override { return data.size(); }
+    std::unique_ptr<BaseComponentColumn> NewEmpty(
+        size_t capacity) const override {
+        auto column = std::make_unique<ComponentColumn<C>>();
+        column->data.reserve(capacity);
+        return column;
+    }
+    void PushFrom(BaseComponentColumn& src, uint32_t src_index) override {
+        auto& other = static_cast<ComponentColumn<C>&>(src);
+        data.push_back(std::move(other.data[src_index]));
+    }
+    void AssignFrom(uint32_t dst_index,
+                    BaseComponentColumn& src,
+                    uint32_t src_index) override {
+        auto& other = static_cast<ComponentColumn<C>&>(src);
+        data[dst_index] = std::move(other.data[src_index]);
+    }
+    void PopBack() override { data.pop_back(); }
+    std::vector<C> data;
+};
+
+/**
+ * @brief Fixed-size block of entities sharing the same archetype, stored as a
+ * structure of arrays (one column per component type)
+ *
+ */
+struct ArchetypeChunk {
+    std::vector<Entity> entities;
+    // Same order as Archetype::Types()
+    std::vector<std::unique_ptr<BaseComponentColumn>> columns;
+    size_t Size() const { return entities.size(); }
+};
+
+/**
+ * @brief Collection of every entity that has exactly the same set of
+ * components
+ *
+ */
+class Archetype {
+   public:
+    // Target size of a chunk (in bytes, excluding bookkeeping)
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr uint32_t INVALID_COLUMN = static_cast<uint32_t>(-1);
+
+    // prototypes must be sorted by TypeId
+    explicit Archetype(
+        std::vector<std::unique_ptr<BaseComponentColumn>>&& prototypes_);
+    const std::vector<TypeId>& Types() const { return types; }
+    bool Contains(TypeId type) const;
+    bool Matches(const Family& family) const;
+    uint32_t ColumnIndex(TypeId type) const;
+    // Max number of entities per chunk
+    uint32_t ChunkCapacity() const { return chunk_capacity; }
+    size_t Size() const;
+    const std::vector<ArchetypeChunk>& Chunks() const { return chunks; }
+    std::vector<ArchetypeChunk>& Chunks() { return chunks; }
+    const BaseComponentColumn& Prototype(uint32_t column) const {
+        return *prototypes[column];
+    }
+    // Returns the index of the first chunk that can take another entity
+    uint32_t ChunkWithSpace();
+    /**
+     * @brief Swap-and-pop removal: the hole is filled with the last entity of
+     * the archetype, so every chunk but the last one stays full
+     *
+     * @param chunk Chunk of the entity to remove
+     * @param row Row of the entity to remove
+     * @param out_moved Entity that took the removed one's place (if any)
+     * @return true if another entity was moved to (chunk, row)
+     */
+    bool RemoveRow(uint32_t chunk, uint32_t row, Entity& out_moved);
+    void Clear();
+
+    // Cached archetype transitions (component type -> archetype index)
+    std::vector<std::pair<TypeId, uint32_t>> add_edges;
+    std::vector<std::pair<TypeId, uint32_t>> remove_edges;
+
+   private:
+    std::vector<TypeId> types;
+    std::vector<std::unique_ptr<BaseComponentColumn>> prototypes;
+    std::vector<ArchetypeChunk> chunks;
+    uint32_t chunk_capacity;
+};
+
+}  // namespace verna
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef VERNA_ARCHETYPE_STORAGE_HPP
+#define VERNA_ARCHETYPE_STORAGE_HPP
+
+#include "Archetype.hpp"
+#include "Entity.hpp"
+#include "Family.hpp"
+#include <viverna/core/Debug.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace verna {
+
+/**
+ * @brief Component storage that groups entities by their component set
+ * (archetype). Components of the same archetype are kept together in
+ * fixed-size SoA chunks, so family queries are linear scans over the matching
+ * chunks
+ *
+ */
+class ArchetypeStorage {
+   public:
+    static constexpr uint32_t INVALID_ARCHETYPE = static_cast<uint32_t>(-1);
+    struct Location {
+        uint32_t archetype = INVALID_ARCHETYPE;
+        uint32_t chunk = 0;
+        uint32_t row = 0;
+    };
+
+    bool HasComponent(Entity e, TypeId comp_type) const;
+    bool Matches(Entity e, const Family& family) const;
+    void GetEntitiesInFamily(const Family& family,
+                             std::vector<Entity>& out_entities) const;
+    void Clear();
+    // Swap-and-pop removal of e and all of its components
+    void RemoveEntity(Entity e);
+    // Moves e to the archetype without comp_type
+    void RemoveComponent(Entity e, TypeId comp_type);
+    const std::vector<Archetype>& Archetypes() const { return archetypes; }
+    std::vector<Archetype>& Archetypes() { return archetypes; }
+    // Invalid location for stale or component-less entities
+    Location GetLocation(Entity e) const;
+
+    template <typename C>
+    C GetComponent(Entity e) const;
+    // Returns false if it's a new component
+    template <typename C>
+    bool SetComponent(Entity e, const C& component);
+
+   private:
+    std::vector<Archetype> archetypes;
+    // Indexed by EntityId
+    std::vector<Location> locations;
+
+    uint32_t FindArchetype(const std::vector<TypeId>& types) const;
+    // Moves e from its archetype to dst_archetype, leaving the new column
+    // (if any) to be filled by the caller
+    void MoveEntity(Entity e, uint32_t dst_archetype);
+    void RemoveFromArchetype(Entity e);
+    template <typename C>
+    uint32_t ArchetypeWithComponent(uint32_t src_archetype);
+};
+
+template <typename C>
+C ArchetypeStorage::GetComponent(Entity e) const {
+    Location loc = GetLocation(e);
+    if (loc.archetype == INVALID_ARCHETYPE) {
+        VERNA_LOGE("Component not found for Entity ", e.id);
+        return C();
+    }
+    const Archetype& archetype = archetypes[loc.archetype];
+    uint32_t column = archetype.ColumnIndex(GetTypeId<C>());
+    if (column == Archetype::INVALID_COLUMN) {
+        VERNA_LOGE("Component not found for Entity ", e.id);
+        return C();
+    }
+    const auto& chunk = archetype.Chunks()[loc.chunk];
+    const auto* col =
+        static_cast<const ComponentColumn<C>*>(chunk.columns[column].get());
+    return col->data[loc.row];
+}
+
+template <typename C>
+bool ArchetypeStorage::SetComponent(Entity e, const C& component) {
+    TypeId type = GetTypeId<C>();
+    Location loc = GetLocation(e);
+    if (loc.archetype != INVALID_ARCHETYPE) {
+        uint32_t column = archetypes[loc.archetype].ColumnIndex(type);
+        if (column != Archetype::INVALID_COLUMN) {
+            auto& chunk = archetypes[loc.archetype].Chunks()[loc.chunk];
+            auto* col =
+                static_cast<ComponentColumn<C>*>(chunk.columns[column].get());
+            col->data[loc.row] = component;
+            return true;
+        }
+    }
+    uint32_t dst = ArchetypeWithComponent<C>(loc.archetype);
+    MoveEntity(e, dst);
+    loc = locations[e.id];
+    Archetype& archetype = archetypes[loc.archetype];
+    auto& chunk = archetype.Chunks()[loc.chunk];
+    auto* col = static_cast<ComponentColumn<C>*>(
+        chunk.columns[archetype.ColumnIndex(type)].get());
+    col->data.push_back(component);
+    return false;
+}
+
+template <typename C>
+uint32_t ArchetypeStorage::ArchetypeWithComponent(uint32_t src_archetype) {
+    TypeId type = GetTypeId<C>();
+    if (src_archetype != INVALID_ARCHETYPE) {
+        for (const auto& [edge_type, dst] : archetypes[src_archetype].add_edges)
+            if (edge_type == type)
+                return dst;
+    }
+    std::vector<std::unique_ptr<BaseComponentColumn>> prototypes;
+    std::vector<TypeId> types;
+    bool inserted = false;
+    auto insert_new = [&] {
+        prototypes.push_back(std::make_unique<ComponentColumn<C>>());
+        types.push_back(type);
+        inserted = true;
+    };
+    if (src_archetype != INVALID_ARCHETYPE) {
+        const Archetype& src = archetypes[src_archetype];
+        const auto& src_types = src.Types();
+        for (uint32_t i = 0; i < src_types.size(); i++) {
+            if (!inserted && type < src_types[i])
+                insert_new();
+            prototypes.push_back(src.Prototype(i).NewEmpty(0));
+            types.push_back(src_types[i]);
+        }
+    }
+    if (!inserted)
+        insert_new();
+    uint32_t dst = FindArchetype(types);
+    if (dst == INVALID_ARCHETYPE) {
+        dst = static_cast<uint32_t>(archetypes.size());
+        archetypes.emplace_back(std::move(prototypes));
+    }
+    if (src_archetype != INVALID_ARCHETYPE)
+        archetypes[src_archetype].add_edges.emplace_back(type, dst);
+    return dst;
+}
+
+}  // namespace verna
+
+#endif
@@ -5,57 +5,94 @@
 #include <viverna/core/Debug.hpp>
 #include <viverna/data/SparseSet.hpp>
 
+#include <utility>
 #include <vector>
 
 namespace verna {
 
 class BaseComponentBuffer {
    public:
+    using index_t = SparseSet<EntityId>::index_t;
     BaseComponentBuffer() = default;
     virtual ~BaseComponentBuffer() = default;
     std::vector<Entity> GetEntities() const;
+    // Dense entities, parallel to the component array
+    const std::vector<Entity>& Entities() const { return entities; }
     virtual TypeId GetType() const = 0;
     bool Contains(Entity e) const;
+    // Index of e's component inside the dense component array
+    bool GetIndex(Entity e, index_t& out_index) const;
+    /**
+     * @brief Removes e's component in O(1), moving the last component in its
+     * place
+     *
+     * @param e Owner of the component
+     * @return true if e had a component in this buffer
+     */
+    bool Remove(Entity e);
     void Clear();
 
    protected:
     SparseSet<EntityId> sparse_set;
+    std::vector<Entity> entities;
+    // components[index] = std::move(components.back()); components.pop_back()
+    virtual void SwapAndPop(index_t index) = 0;
+    virtual void ClearComponents() = 0;
 };
 
 template <typename C>
 class ComponentBuffer : public BaseComponentBuffer {
    public:
     C GetComponent(Entity e) const;
-    // Returns false if it's a new component
+    // Returns false if it's a new component, or if e is stale (nothing is
+    // written then)
     bool SetComponent(Entity e, const C& component);
     const auto& GetComponents() const { return components; }
     auto& GetComponents() { return components; }
     TypeId GetType() const override { return GetTypeId<C>(); }
 
+   protected:
+    void SwapAndPop(index_t index) override;
+    void ClearComponents() override { components.clear(); }
+
    private:
     std::vector<C> components;
 };
 
 template <typename C>
 C ComponentBuffer<C>::GetComponent(Entity e) const {
-    SparseSet<EntityId>::index_t i;
-    [[maybe_unused]] bool found = sparse_set.GetIndex(e.id, i);
-    VERNA_LOGE_IF(!found,
-                  "Component not found for Entity " + std::to_string(e.id));
+    index_t i;
+    if (!GetIndex(e, i)) {
+        VERNA_LOGE("Component not found for Entity ", e.id);
+        return C();
+    }
     return components[i];
 }
 
 template <typename C>
 bool ComponentBuffer<C>::SetComponent(Entity e, const C& component) {
-    SparseSet<EntityId>::index_t i;
-    if (sparse_set.GetIndex(e.id, i)) {
+    index_t i;
+    if (GetIndex(e, i)) {
         components[i] = component;
         return true;
     }
+    if (sparse_set.Contains(e.id)) {
+        // the id belongs to a newer Entity
+        VERNA_LOGE("SetComponent called with stale Entity ", e.id);
+        return false;
+    }
     sparse_set.Add(e.id);
+    entities.push_back(e);
     components.push_back(component);
     return false;
 }
+
+template <typename C>
+void ComponentBuffer<C>::SwapAndPop(index_t index) {
+    if (index + 1 != components.size())
+        components[index] = std::move(components.back());
+    components.pop_back();
+}
 }  // namespace verna
 
 #endif
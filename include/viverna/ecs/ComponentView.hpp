@@ -0,0 +1,236 @@
+#ifndef VERNA_COMPONENT_VIEW_HPP
+#define VERNA_COMPONENT_VIEW_HPP
+
+#include "ArchetypeStorage.hpp"
+#include "ComponentBuffer.hpp"
+#include "Entity.hpp"
+#include <viverna/core/ThreadPool.hpp>
+
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace verna {
+
+/**
+ * @brief Zero-copy access to every entity that owns all of Comps. Components
+ * are handed out as references into the World storage (const-qualified
+ * Comps yield const references). A view must not outlive structural changes
+ * of its World (new components, removed entities...)
+ *
+ * @tparam Comps Component types
+ */
+template <typename... Comps>
+class ComponentView {
+   public:
+    using buffers_t =
+        std::tuple<ComponentBuffer<std::remove_const_t<Comps>>*...>;
+
+    ComponentView() = default;
+    explicit ComponentView(const buffers_t& buffers_) : buffers(buffers_) {}
+    explicit ComponentView(ArchetypeStorage* archetypes_) :
+        archetypes(archetypes_) {}
+
+    /**
+     * @brief Calls fn for every entity in the view
+     *
+     * @param fn Either fn(Entity, Comps&...) or fn(Comps&...)
+     */
+    template <typename F>
+    void ForEach(F&& fn) const;
+    /**
+     * @brief Same as ForEach, but the entities are split into batches that
+     * run on ThreadPool. fn is called concurrently: it must only touch the
+     * components it receives (no structural changes to the World)
+     *
+     * @param fn Either fn(Entity, Comps&...) or fn(Comps&...)
+     * @param grain Entities per batch (archetype storage always splits by
+     * chunk)
+     */
+    template <typename F>
+    void ParallelForEach(F&& fn, size_t grain = 1024) const;
+
+    /**
+     * @brief Retrieves a component of an entity in the view (no copy)
+     *
+     * @tparam C One of Comps
+     * @param e An entity owning C
+     * @return Reference to the stored component
+     */
+    template <typename C>
+    C& Get(Entity e) const;
+
+   private:
+    buffers_t buffers{};
+    ArchetypeStorage* archetypes = nullptr;
+
+    template <typename F, typename... Args>
+    static void Invoke(F& fn, Entity e, Args&... args) {
+        if constexpr (std::is_invocable_v<F&, Entity, Args&...>)
+            fn(e, args...);
+        else
+            fn(args...);
+    }
+    // Smallest buffer, or nullptr if a component type has no buffer
+    const BaseComponentBuffer* Driver() const;
+    template <typename F, size_t... I>
+    void ForEachInRange(F& fn,
+                        const std::vector<Entity>& entities,
+                        size_t begin,
+                        size_t end,
+                        std::index_sequence<I...>) const;
+    template <typename F, size_t... I>
+    static void ForEachInChunk(F& fn,
+                               ArchetypeChunk& chunk,
+                               const uint32_t* columns,
+                               std::index_sequence<I...>);
+    static bool HasAll(const Archetype& archetype) {
+        return (archetype.Contains(GetTypeId<std::remove_const_t<Comps>>())
+                && ...);
+    }
+    static std::array<uint32_t, sizeof...(Comps)> Columns(
+        const Archetype& archetype) {
+        return {archetype.ColumnIndex(
+            GetTypeId<std::remove_const_t<Comps>>())...};
+    }
+};
+
+template <typename... Comps>
+template <typename C>
+C& ComponentView<Comps...>::Get(Entity e) const {
+    using B = std::remove_const_t<C>;
+    if (archetypes != nullptr) {
+        auto loc = archetypes->GetLocation(e);
+        VERNA_ASSERT(loc.archetype != ArchetypeStorage::INVALID_ARCHETYPE);
+        Archetype& archetype = archetypes->Archetypes()[loc.archetype];
+        uint32_t column = archetype.ColumnIndex(GetTypeId<B>());
+        VERNA_ASSERT(column != Archetype::INVALID_COLUMN);
+        auto& chunk = archetype.Chunks()[loc.chunk];
+        auto* col =
+            static_cast<ComponentColumn<B>*>(chunk.columns[column].get());
+        return col->data[loc.row];
+    }
+    ComponentBuffer<B>* buffer = std::get<ComponentBuffer<B>*>(buffers);
+    VERNA_ASSERT(buffer != nullptr);
+    BaseComponentBuffer::index_t i = 0;
+    [[maybe_unused]] bool found = buffer->GetIndex(e, i);
+    VERNA_LOGE_IF(!found, "Component not found for Entity ", e.id);
+    return buffer->GetComponents()[i];
+}
+
+template <typename... Comps>
+template <typename F>
+void ComponentView<Comps...>::ForEach(F&& fn) const {
+    if (archetypes != nullptr) {
+        for (Archetype& archetype : archetypes->Archetypes()) {
+            if (!HasAll(archetype))
+                continue;
+            const auto columns = Columns(archetype);
+            for (ArchetypeChunk& chunk : archetype.Chunks())
+                ForEachInChunk(fn, chunk, columns.data(),
+                               std::index_sequence_for<Comps...>());
+        }
+        return;
+    }
+    const BaseComponentBuffer* driver = Driver();
+    if (driver == nullptr)
+        return;
+    const auto& entities = driver->Entities();
+    ForEachInRange(fn, entities, 0, entities.size(),
+                   std::index_sequence_for<Comps...>());
+}
+
+template <typename... Comps>
+template <typename F>
+void ComponentView<Comps...>::ParallelForEach(F&& fn, size_t grain) const {
+    ThreadPool& pool = ThreadPool::Get();
+    if (archetypes != nullptr) {
+        struct Batch {
+            ArchetypeChunk* chunk;
+            std::array<uint32_t, sizeof...(Comps)> columns;
+        };
+        std::vector<Batch> batches;
+        for (Archetype& archetype : archetypes->Archetypes()) {
+            if (!HasAll(archetype))
+                continue;
+            const auto columns = Columns(archetype);
+            for (ArchetypeChunk& chunk : archetype.Chunks())
+                batches.push_back({&chunk, columns});
+        }
+        pool.ParallelFor(0, batches.size(), 1, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; i++)
+                ForEachInChunk(fn, *batches[i].chunk,
+                               batches[i].columns.data(),
+                               std::index_sequence_for<Comps...>());
+        });
+        return;
+    }
+    const BaseComponentBuffer* driver = Driver();
+    if (driver == nullptr)
+        return;
+    const auto& entities = driver->Entities();
+    pool.ParallelFor(0, entities.size(), grain, [&](size_t b, size_t e) {
+        ForEachInRange(fn, entities, b, e,
+                       std::index_sequence_for<Comps...>());
+    });
+}
+
+template <typename... Comps>
+const BaseComponentBuffer* ComponentView<Comps...>::Driver() const {
+    const std::array<const BaseComponentBuffer*, sizeof...(Comps)> bases =
+        std::apply(
+            [](auto*... b) {
+                return std::array<const BaseComponentBuffer*,
+                                  sizeof...(Comps)>{b...};
+            },
+            buffers);
+    const BaseComponentBuffer* driver = bases[0];
+    for (const BaseComponentBuffer* b : bases) {
+        if (b == nullptr)
+            return nullptr;
+        if (b->Entities().size() < driver->Entities().size())
+            driver = b;
+    }
+    return driver;
+}
+
+template <typename... Comps>
+template <typename F, size_t... I>
+void ComponentView<Comps...>::ForEachInRange(
+    F& fn,
+    const std::vector<Entity>& entities,
+    size_t begin,
+    size_t end,
+    std::index_sequence<I...>) const {
+    // iterate the smallest buffer, look up the others
+    std::array<BaseComponentBuffer::index_t, sizeof...(Comps)> indices;
+    for (size_t n = begin; n < end; n++) {
+        Entity e = entities[n];
+        if (!(std::get<I>(buffers)->GetIndex(e, indices[I]) && ...))
+            continue;
+        Invoke(fn, e,
+               static_cast<Comps&>(
+                   std::get<I>(buffers)->GetComponents()[indices[I]])...);
+    }
+}
+
+template <typename... Comps>
+template <typename F, size_t... I>
+void ComponentView<Comps...>::ForEachInChunk(F& fn,
+                                             ArchetypeChunk& chunk,
+                                             const uint32_t* columns,
+                                             std::index_sequence<I...>) {
+    auto data = std::make_tuple(
+        static_cast<ComponentColumn<std::remove_const_t<Comps>>*>(
+            chunk.columns[columns[I]].get())
+            ->data.data()...);
+    size_t n = chunk.Size();
+    for (size_t row = 0; row < n; row++)
+        Invoke(fn, chunk.entities[row],
+               static_cast<Comps&>(std::get<I>(data)[row])...);
+}
+
+}  // namespace verna
+
+#endif
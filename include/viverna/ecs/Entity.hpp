@@ -7,20 +7,28 @@
 namespace verna {
 
 using EntityId = uint32_t;
+using EntityGeneration = uint32_t;
 class Family;
 
 struct Entity {
     EntityId id;
-    constexpr Entity() : id(0) {}
-    explicit constexpr Entity(EntityId id_) : id(id_) {}
+    // Incremented every time id gets recycled, detects stale handles
+    EntityGeneration generation;
+    constexpr Entity() : id(0), generation(0) {}
+    explicit constexpr Entity(EntityId id_, EntityGeneration generation_ = 0) :
+        id(id_), generation(generation_) {}
 };
 
 constexpr bool operator==(Entity a, Entity b) {
-    return a.id == b.id;
+    return a.id == b.id && a.generation == b.generation;
+}
+
+constexpr bool operator!=(Entity a, Entity b) {
+    return !(a == b);
 }
 
 constexpr bool operator<(Entity a, Entity b) {
-    return a.id < b.id;
+    return a.id < b.id || (a.id == b.id && a.generation < b.generation);
 }
 
 }  // namespace verna
@@ -5,6 +5,7 @@
 #include "EntityEvent.hpp"
 #include "Family.hpp"
 #include <viverna/core/Time.hpp>
+#include <viverna/data/SparseSet.hpp>
 #include <vector>
 
 namespace verna {
@@ -24,6 +25,31 @@ class System {
     void Notify(EntityEvent event);
     void ReassignEntities(std::vector<Entity>&& new_entities);
     bool operator==(const System& other) const;
+    /**
+     * @brief Declares the component types read by the system. Systems with
+     * declared access may run at the same time as the non-conflicting ones,
+     * so they must not add or remove entities or components. Systems that
+     * don't declare anything always run alone
+     *
+     * @tparam T Read-only component types
+     * @return *this
+     */
+    template <typename... T>
+    System& Reads() {
+        (reads.push_back(GetTypeId<T>()), ...);
+        declared_access = true;
+        return *this;
+    }
+    // Same as Reads, for component types that the system modifies
+    template <typename... T>
+    System& Writes() {
+        (writes.push_back(GetTypeId<T>()), ...);
+        declared_access = true;
+        return *this;
+    }
+    bool DeclaresAccess() const { return declared_access; }
+    // true if the systems can't run at the same time
+    bool ConflictsWith(const System& other) const;
     template <typename... T>
     static System FromFamilyOf(SystemUpdate update_func) {
         return System(Family::From<T...>(), update_func);
@@ -34,9 +60,16 @@ class System {
     SystemId id;
     SystemUpdate update;
     Family family;
+    std::vector<TypeId> reads;
+    std::vector<TypeId> writes;
+    bool declared_access = false;
+    // Dense list handed to update, kept parallel to membership.GetDense()
     std::vector<Entity> entities;
+    SparseSet<EntityId> membership;
     std::vector<EntityEvent> entity_queue;
     void ResolveEvents();
+    void AddEntity(Entity e);
+    void RemoveEntity(Entity e);
     static SystemId next_id;
 };
 
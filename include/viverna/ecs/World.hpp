@@ -1,7 +1,9 @@
 #ifndef VERNA_WORLD_HPP
 #define VERNA_WORLD_HPP
 
+#include "ArchetypeStorage.hpp"
 #include "ComponentBuffer.hpp"
+#include "ComponentView.hpp"
 #include "Entity.hpp"
 #include "System.hpp"
 #include <viverna/core/Time.hpp>
@@ -10,8 +12,26 @@
 #include <vector>
 
 namespace verna {
+
+enum class WorldStorage : uint8_t {
+    // One ComponentBuffer per component type (default)
+    SparseSet,
+    // Entities with the same component set share fixed-size SoA chunks
+    Archetype
+};
+
 class World {
    public:
+    World() = default;
+    explicit World(WorldStorage storage_);
+    WorldStorage GetStorage() const;
+    /**
+     * @brief Changes how components are stored. Every entity and component is
+     * removed (systems are kept)
+     *
+     * @param new_storage Storage mode to use from now on
+     */
+    void SetStorage(WorldStorage new_storage);
     bool HasComponent(Entity e, TypeId comp_type) const;
     bool Matches(Entity e, const Family& family) const;
     [[nodiscard]] std::vector<Entity> GetEntitiesWithComponent(
@@ -21,12 +41,32 @@ class World {
     void AddSystem(const System& system);
     SystemId AddSystem(const Family& family, SystemUpdate update_func);
     void RemoveSystem(SystemId system_id);
+    /**
+     * @brief Removes e and all of its components. Its id gets recycled by
+     * NewEntity with a new generation, so e becomes a stale handle
+     *
+     * @param e Entity to remove
+     */
     void RemoveEntity(Entity e);
+    // Returns false for removed (stale) or never created entities
+    [[nodiscard]] bool IsAlive(Entity e) const;
     void ClearData();
     void ClearSystems();
     // Same as ClearData + ClearSystems
     void ClearAll();
+    /**
+     * @brief Runs every system. Systems are grouped in stages, respecting
+     * the order in which they were added: systems in the same stage don't
+     * conflict (see System::Reads/Writes) and run at the same time on
+     * ThreadPool. While they do, they may read and write existing components
+     * but must not add or remove entities, components or systems: that
+     * notifies every system and isn't thread-safe (asserted in debug builds)
+     *
+     * @param dt Time elapsed since the last call
+     */
     void RunSystems(DeltaTime<float, Seconds> dt);
+    // Ids of the systems, grouped in the stages that RunSystems runs in order
+    [[nodiscard]] std::vector<std::vector<SystemId>> GetStages();
     DeltaTime<float, Seconds> GetDeltaTime() const;
     template <typename... Comps>
     Entity NewEntity();
@@ -38,22 +78,71 @@ class World {
     void SetComponent(Entity e, const C& component);
     template <typename... Comps>
     void SetComponents(Entity e, const Comps&... comps);
+    void RemoveComponent(Entity e, TypeId comp_type);
+    template <typename C>
+    void RemoveComponent(Entity e);
     template <typename C>
     [[nodiscard]] bool HasComponent(Entity e) const;
     template <typename C>
     [[nodiscard]] std::vector<Entity> GetEntitiesWithComponent() const;
+    /**
+     * @brief Zero-copy access to every entity owning all of Comps
+     *
+     * @tparam Comps Component types (const-qualify them for read-only access)
+     * @return View over the World storage
+     */
+    template <typename... Comps>
+    [[nodiscard]] ComponentView<Comps...> View();
+    template <typename... Comps>
+    [[nodiscard]] ComponentView<const Comps...> View() const;
+    /**
+     * @brief Same as View<Comps...>().ForEach(fn)
+     *
+     * @param fn Either fn(Entity, Comps&...) or fn(Comps&...)
+     */
+    template <typename... Comps, typename F>
+    void ForEach(F&& fn);
+    template <typename... Comps, typename F>
+    void ForEach(F&& fn) const;
+    // Same as View<Comps...>().ParallelForEach(fn, grain)
+    template <typename... Comps, typename F>
+    void ParallelForEach(F&& fn, size_t grain = 1024);
+    template <typename... Comps, typename F>
+    void ParallelForEach(F&& fn, size_t grain = 1024) const;
 
    private:
+    WorldStorage storage = WorldStorage::SparseSet;
+    ArchetypeStorage archetypes;
     SparseSet<TypeId> component_types;
     std::vector<std::unique_ptr<BaseComponentBuffer>> buffers;
     std::vector<System> systems;
+    // Indices of systems, grouped in stages that can run concurrently
+    std::vector<std::vector<size_t>> stages;
+    bool stages_dirty = true;
+    // true while the systems of a stage run concurrently
+    bool in_parallel_stage = false;
+    // Indexed by EntityId
+    std::vector<EntityGeneration> generations;
+    std::vector<EntityId> free_ids;
     EntityId next_id = 0;
     DeltaTime<float, Seconds> delta_time = Seconds(0);
+    template <typename C>
+    ComponentBuffer<C>* FindBuffer() const;
+    Entity CreateEntity();
+    void BuildStages();
 };
 
+template <typename C>
+ComponentBuffer<C>* World::FindBuffer() const {
+    SparseSet<TypeId>::index_t i;
+    if (!component_types.GetIndex(GetTypeId<C>(), i))
+        return nullptr;
+    return static_cast<ComponentBuffer<C>*>(buffers[i].get());
+}
+
 template <typename... Comps>
 Entity World::NewEntity() {
-    Entity e(++next_id);
+    Entity e = CreateEntity();
     SetComponents<Comps...>(e, Comps()...);
     for (auto& s : systems)
         if (Matches(e, s.GetFamily()))
@@ -63,6 +152,8 @@ Entity World::NewEntity() {
 
 template <typename C>
 C World::GetComponent(Entity e) const {
+    if (storage == WorldStorage::Archetype)
+        return archetypes.GetComponent<C>(e);
     TypeId type = GetTypeId<C>();
     SparseSet<TypeId>::index_t i;
     if (component_types.GetIndex(type, i)) {
@@ -80,19 +171,31 @@ void World::GetComponents(Entity e, Comps&... comps) const {
 
 template <typename C>
 void World::SetComponent(Entity e, const C& component) {
-    TypeId type = GetTypeId<C>();
-    SparseSet<TypeId>::index_t i;
-    ComponentBuffer<C>* b;
-    if (component_types.GetIndex(type, i)) {
-        BaseComponentBuffer* base_b = buffers[i].get();
-        b = static_cast<ComponentBuffer<C>*>(base_b);
+    if (!IsAlive(e)) {
+        VERNA_LOGE("SetComponent called on stale Entity ", e.id);
+        return;
+    }
+    if (storage == WorldStorage::Archetype) {
+        if (archetypes.SetComponent(e, component))
+            return;
     } else {
-        component_types.Add(type);
-        b = new ComponentBuffer<C>();
-        buffers.emplace_back(b);
+        TypeId type = GetTypeId<C>();
+        SparseSet<TypeId>::index_t i;
+        ComponentBuffer<C>* b;
+        if (component_types.GetIndex(type, i)) {
+            BaseComponentBuffer* base_b = buffers[i].get();
+            b = static_cast<ComponentBuffer<C>*>(base_b);
+        } else {
+            VERNA_ASSERT(!in_parallel_stage);
+            component_types.Add(type);
+            b = new ComponentBuffer<C>();
+            buffers.emplace_back(b);
+        }
+        if (b->SetComponent(e, component))
+            return;
     }
-    if (b->SetComponent(e, component))
-        return;
+    // e gained a component
+    VERNA_ASSERT(!in_parallel_stage);
     for (auto& s : systems) {
         const Family& family = s.GetFamily();
         if (family.Contains(GetTypeId<C>()) && Matches(e, family))
@@ -105,6 +208,11 @@ void World::SetComponents(Entity e, const Comps&... comps) {
     (SetComponent(e, comps), ...);
 }
 
+template <typename C>
+void World::RemoveComponent(Entity e) {
+    RemoveComponent(e, GetTypeId<C>());
+}
+
 template <typename C>
 bool World::HasComponent(Entity e) const {
     return HasComponent(e, GetTypeId<C>());
@@ -114,6 +222,47 @@ template <typename C>
 std::vector<Entity> World::GetEntitiesWithComponent() const {
     return GetEntitiesWithComponent(GetTypeId<C>());
 }
+
+template <typename... Comps>
+ComponentView<Comps...> World::View() {
+    if (storage == WorldStorage::Archetype)
+        return ComponentView<Comps...>(&archetypes);
+    using buffers_t = typename ComponentView<Comps...>::buffers_t;
+    return ComponentView<Comps...>(
+        buffers_t(FindBuffer<std::remove_const_t<Comps>>()...));
+}
+
+template <typename... Comps>
+ComponentView<const Comps...> World::View() const {
+    if (storage == WorldStorage::Archetype) {
+        // const-qualified Comps only hand out const references
+        auto* storage_ptr = const_cast<ArchetypeStorage*>(&archetypes);
+        return ComponentView<const Comps...>(storage_ptr);
+    }
+    using buffers_t = typename ComponentView<const Comps...>::buffers_t;
+    return ComponentView<const Comps...>(
+        buffers_t(FindBuffer<std::remove_const_t<Comps>>()...));
+}
+
+template <typename... Comps, typename F>
+void World::ForEach(F&& fn) {
+    View<Comps...>().ForEach(std::forward<F>(fn));
+}
+
+template <typename... Comps, typename F>
+void World::ForEach(F&& fn) const {
+    View<Comps...>().ForEach(std::forward<F>(fn));
+}
+
+template <typename... Comps, typename F>
+void World::ParallelForEach(F&& fn, size_t grain) {
+    View<Comps...>().ParallelForEach(std::forward<F>(fn), grain);
+}
+
+template <typename... Comps, typename F>
+void World::ParallelForEach(F&& fn, size_t grain) const {
+    View<Comps...>().ParallelForEach(std::forward<F>(fn), grain);
+}
 }  // namespace verna
 
 #endif
\ No newline at end of file
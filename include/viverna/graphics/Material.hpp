@@ -15,7 +15,7 @@ struct Material {
     static constexpr size_t DOES_NOT_CAST_SHADOW_INDEX = 3;
 
     constexpr bool CastsShadow() const {
-        return parameters[DOES_NOT_CAST_SHADOW_INDEX] != 0.0f;
+        return parameters[DOES_NOT_CAST_SHADOW_INDEX] == 0.0f;
     }
     constexpr void SetCastsShadow(bool casts_shadows) {
         parameters[DOES_NOT_CAST_SHADOW_INDEX] = casts_shadows ? 0.0f : 1.0f;
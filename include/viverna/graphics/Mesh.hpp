@@ -14,22 +14,66 @@ namespace verna {
 struct Mesh {
     using index_t = uint32_t;
     using id_type = uint32_t;
+    // Levels of detail, full detail included
+    static constexpr uint32_t MAX_LODS = 4;
     std::vector<Vertex> vertices;
     std::vector<index_t> indices;
+    // Simplified versions of indices (same vertices), from the most detailed.
+    // Level of detail 0 is indices itself
+    std::vector<std::vector<index_t>> lods;
     BoundingBox bounds;
     id_type id = 0;
     void RecalculateNormals();
     void RecalculateBounds();
+    /**
+     * @brief Fills lods with up to MAX_LODS - 1 simplified index lists, each
+     * with about half the triangles of the previous one. Meshes that are too
+     * small or can't be simplified get no levels. Needs valid bounds
+     *
+     */
+    void GenerateLods();
+    uint32_t LodCount() const { return 1 + static_cast<uint32_t>(lods.size()); }
+    const std::vector<index_t>& LodIndices(uint32_t lod) const {
+        return lod == 0 ? indices : lods[lod - 1];
+    }
 };
 
 enum class PrimitiveMeshType : uint8_t { Cube, Pyramid, Sphere };
 
 Mesh LoadPrimitiveMesh(PrimitiveMeshType type);
 
-std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path);
+/**
+ * @brief Loads every group of an OBJ file as a Mesh
+ *
+ * @param mesh_path Path of the file, relative to the meshes asset folder
+ * @param generate_lods Calls GenerateLods on every mesh, which costs more
+ * than the parsing itself on large meshes
+ * @return The meshes, empty on failure
+ */
+std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path,
+                                bool generate_lods = false);
 
 std::string GetMeshName(Mesh::id_type mesh_id);
 
+/**
+ * @brief Simplifies a triangle list with quadric error edge collapses.
+ * Vertices are only removed, never moved or created: the result indexes the
+ * same vertex list. Vertices sharing a position are treated as one, so that
+ * meshes with split normals or texture seams can be simplified
+ *
+ * @param vertices Vertices of the mesh
+ * @param indices Triangle list to simplify
+ * @param target_index_count Stops when there are this many indices left
+ * @param max_error Stops before moving a surface more than about this
+ * distance
+ * @return The simplified triangle list
+ */
+std::vector<Mesh::index_t> SimplifyIndices(
+    const std::vector<Vertex>& vertices,
+    const std::vector<Mesh::index_t>& indices,
+    size_t target_index_count,
+    float max_error);
+
 }  // namespace verna
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef VERNA_NULL_BACKEND_HPP
+#define VERNA_NULL_BACKEND_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Only available when building with -DVIVERNA_NULL_BACKEND=ON: the engine
+// then runs its desktop OpenGL code paths against a recorder instead of a
+// driver, without any window or GPU
+#if defined(VERNA_NULL_BACKEND)
+
+namespace verna {
+struct NullBackendCounters {
+    // frames ended with SwapBuffers()
+    uint64_t frames = 0;
+    // glDrawElementsInstancedBaseVertex calls
+    uint64_t draw_calls = 0;
+    // glMultiDrawElementsIndirect calls
+    uint64_t multi_draw_calls = 0;
+    // indirect commands read by multi draw calls
+    uint64_t draw_commands = 0;
+    uint64_t instances = 0;
+    uint64_t triangles = 0;
+    // bytes copied into buffers and textures by the driver
+    uint64_t bytes_uploaded = 0;
+    // bytes of persistently mapped buffers bound for drawing
+    uint64_t bytes_bound = 0;
+    uint64_t buffer_binds = 0;
+    uint64_t texture_binds = 0;
+    uint64_t program_binds = 0;
+    uint64_t framebuffer_binds = 0;
+    uint64_t vertex_array_binds = 0;
+    uint64_t uniform_updates = 0;
+    // enable, depth, cull, viewport and draw buffer changes
+    uint64_t state_changes = 0;
+    uint64_t clears = 0;
+    // GL errors raised by invalid calls
+    uint64_t errors = 0;
+};
+
+struct NullBackendCommand {
+    enum class Type : uint8_t {
+        Draw,
+        MultiDraw,
+        Upload,
+        BindBuffer,
+        BindTexture,
+        BindProgram,
+        BindFramebuffer,
+        BindVertexArray,
+        Uniform,
+        StateChange,
+        Clear,
+        SwapBuffers
+    };
+    Type type;
+    // GL name (buffer, texture, program...), capability or mode
+    uint32_t object;
+    // draw commands, instances or bytes, depending on type
+    uint64_t amount;
+};
+
+/**
+ * @brief Counters accumulated since the last ResetNullBackendCounters()
+ *
+ */
+const NullBackendCounters& GetNullBackendCounters();
+void ResetNullBackendCounters();
+
+/**
+ * @brief Starts or stops recording every call in the command stream. Off by
+ * default, counters are always updated
+ *
+ * @param enabled
+ */
+void SetNullBackendRecording(bool enabled);
+// Commands recorded since the last ClearNullBackendCommands()
+const std::vector<NullBackendCommand>& GetNullBackendCommands();
+void ClearNullBackendCommands();
+}  // namespace verna
+
+#endif
+
+#endif
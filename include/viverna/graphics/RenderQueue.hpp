@@ -0,0 +1,71 @@
+#ifndef VERNA_RENDER_QUEUE_HPP
+#define VERNA_RENDER_QUEUE_HPP
+
+#include <viverna/core/BoundingBox.hpp>
+#include <viverna/core/Transform.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "Shader.hpp"
+
+#include <vector>
+
+namespace verna {
+
+/**
+ * @brief List of render commands that can be filled without touching any
+ * Renderer state, so different queues can be recorded on different threads.
+ * Recording computes the per-mesh matrices and bounds; submitting a queue
+ * with Render(const RenderQueue&) appends its commands to the frame in the
+ * order they were recorded.
+ * Only a pointer to the mesh is kept: meshes must outlive the submission
+ *
+ */
+class RenderQueue {
+   public:
+    struct Command {
+        const Mesh* mesh;
+        Material material;
+        Mat4f model_matrix;
+        Mat4f transpose_inverse_model_matrix;
+        // world space bounds of the mesh
+        BoundingBox bounds;
+        ShaderId shader;
+
+        // Command with the matrices and bounds of the transformed mesh, as
+        // recorded by Render() and verna::Render
+        static Command From(const Mesh& mesh,
+                            const Material& material,
+                            const Transform& transform,
+                            ShaderId shader_id);
+    };
+
+    /**
+     * @brief Records a mesh, same arguments as verna::Render
+     *
+     * @param mesh The mesh that must be rendered
+     * @param material The material properties used to render the mesh
+     * @param transform The transformation of the mesh
+     * @param shader_id The shader used to render the mesh
+     */
+    void Render(const Mesh& mesh,
+                const Material& material,
+                const Transform& transform,
+                ShaderId shader_id);
+    // Removes every command, keeping the allocated memory
+    void Clear();
+    void Reserve(size_t num_commands);
+    size_t Size() const { return commands.size(); }
+    bool Empty() const { return commands.empty(); }
+    const std::vector<Command>& Commands() const { return commands; }
+    // Union of the world space bounds of every recorded mesh
+    const BoundingBox& Bounds() const { return bounds; }
+
+   private:
+    std::vector<Command> commands;
+    BoundingBox bounds;
+};
+
+}  // namespace verna
+
+#endif
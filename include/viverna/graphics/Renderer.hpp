@@ -10,6 +10,11 @@
 #include "Model.hpp"
 #include "Shader.hpp"
 #include "Material.hpp"
+#include "RenderQueue.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace verna {
 
@@ -28,7 +33,8 @@ void InitializeRenderer(VivernaState& state);
 void TerminateRenderer(VivernaState& state);
 
 /**
- * @brief Adds an element to the render batch
+ * @brief Adds an element to the render batch. Only a pointer to the mesh is
+ * kept: it must stay valid until Draw() gets called
  *
  * @param mesh The mesh that must be rendered
  * @param material The material properties used to render the mesh
@@ -42,9 +48,26 @@ void Render(const Mesh& mesh,
             const Transform& transform,
             ShaderId shader_id);
 
+/**
+ * @brief Adds every command of the queue to the render batch, in recording
+ * order. Submitting queues in a fixed order gives the same frame no matter
+ * which threads recorded them
+ *
+ * @param queue Commands recorded with RenderQueue::Render
+ */
+void Render(const RenderQueue& queue);
+
 void Render(const BoundingBox& box);
 void Render(const BoundingSphere& sphere);
 
+/**
+ * @brief Frees the GPU copy of a mesh. Meshes are uploaded once per id, so
+ * this must be called when the vertices or indices of a mesh change
+ *
+ * @param mesh_id Identifier of the mesh
+ */
+void EvictMesh(Mesh::id_type mesh_id);
+
 /**
  * @brief Draws the batch on the back buffer, which is not shown until
  * NextFrame() gets called
@@ -58,6 +81,106 @@ void Draw();
  */
 void NextFrame();
 
+/**
+ * @brief Enables cached shadows: the shadow map covers every submitted mesh
+ * and it's re-rendered only when the light, the set of shadow casters or
+ * their transforms change. Meant for mostly static scenes: while enabled,
+ * meshes with id 0 make the shadow map dirty every frame
+ *
+ * @param enabled Whether to cache the shadow map, false by default
+ */
+void SetShadowCaching(bool enabled);
+
+/**
+ * @brief Adds an occluder to the frame. Occluders aren't drawn: they hide
+ * the meshes behind them when occlusion culling is enabled. Big and simple
+ * meshes (e.g. walls, terrain) make good occluders. Only a pointer to the
+ * mesh is kept: it must stay valid until Draw() gets called
+ *
+ * @param mesh The occluder, usually a low-poly version of a rendered mesh
+ * @param transform The transformation of the occluder
+ */
+void RenderOccluder(const Mesh& mesh, const Transform& transform);
+
+/**
+ * @brief Enables software occlusion culling: the occluders are rasterized on
+ * the CPU into a low resolution depth buffer, and the meshes hidden behind
+ * them are skipped by the color pass
+ *
+ * @param enabled Whether to cull occluded meshes, false by default
+ */
+void SetOcclusionCulling(bool enabled);
+
+/**
+ * @brief Frustum and occlusion culling results of the last Draw()
+ *
+ */
+struct CullingStats {
+    // meshes submitted with Render()
+    uint32_t submitted = 0;
+    // meshes outside the camera frustum, skipped by the color pass
+    uint32_t culled = 0;
+    // meshes inside the frustum hidden by occluders, skipped by the color
+    // pass
+    uint32_t occluded = 0;
+    // shadow casters inside the light frustum, drawn by the depth pass
+    uint32_t casters = 0;
+    // true if the depth pass was skipped, see SetShadowCaching()
+    bool shadow_map_reused = false;
+};
+
+CullingStats GetCullingStats();
+
+/**
+ * @brief Work done by the last Draw(), to tell why a frame is slow
+ *
+ */
+struct RendererStats {
+    CullingStats culling;
+    // shaders used by the color pass, each with its bucket of batches
+    uint32_t buckets = 0;
+    // color pass batches, all buckets included
+    uint32_t batches = 0;
+    // batches of the fullest bucket
+    uint32_t max_bucket_batches = 0;
+    // depth pass batches
+    uint32_t shadow_batches = 0;
+    // glMultiDrawElementsIndirect calls (desktop)
+    uint32_t multi_draw_calls = 0;
+    // glDrawElementsInstancedBaseVertex calls (Android)
+    uint32_t draw_calls = 0;
+    // indirect commands, one per mesh and level of detail in each batch
+    uint32_t draw_commands = 0;
+    uint32_t instances = 0;
+    uint32_t program_binds = 0;
+    // texture units bound (not counting bindless handles)
+    uint32_t texture_binds = 0;
+    // mesh data sent to the GPU (meshes not resident yet and meshes with
+    // id 0), levels of detail included
+    uint32_t vertices_uploaded = 0;
+    uint32_t indices_uploaded = 0;
+    // bytes sent to uniform blocks
+    uint32_t uniform_bytes = 0;
+    // per-instance data, draw commands and texture handles
+    uint32_t streamed_bytes = 0;
+    // times the mesh vertex/index buffers had to grow
+    uint32_t mesh_buffer_growths = 0;
+    // times a per-frame storage buffer had to grow
+    uint32_t storage_growths = 0;
+};
+
+RendererStats GetRendererStats();
+
+/**
+ * @brief Keeps the stats of the last frames, see GetRendererStatsHistory()
+ *
+ * @param frames How many frames to keep, 0 (default) disables the history
+ */
+void SetRendererStatsHistory(size_t frames);
+// Stats of the last frames (at most the size set with
+// SetRendererStatsHistory()), oldest first
+std::vector<RendererStats> GetRendererStatsHistory();
+
 namespace RendererInfo {
 int MaxTextureUnits();
 int MaxMaterialTextures();
@@ -0,0 +1,18 @@
+#ifndef VERNA_GPU_DRAW_COMMAND_HPP
+#define VERNA_GPU_DRAW_COMMAND_HPP
+
+#include <cstdint>
+
+namespace verna::gpu {
+// Same layout as OpenGL's DrawElementsIndirectCommand
+struct DrawCommand {
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first_index;
+    int32_t base_vertex;
+    uint32_t base_instance;
+};
+static_assert(sizeof(DrawCommand) == 5 * sizeof(uint32_t));
+}  // namespace verna::gpu
+
+#endif
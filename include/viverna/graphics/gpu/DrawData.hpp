@@ -4,19 +4,25 @@
 #include "MeshData.hpp"
 
 namespace verna::gpu {
+// Per-instance data: a MeshData array indexed by first instance +
+// gl_InstanceID. On desktop it's a shader storage buffer (std430).
+// OpenGL ES doesn't have to support storage blocks in vertex shaders, so
+// Android uses a std140 uniform block holding MAX_UNIFORM_INSTANCES
+// instances, refilled whenever a draw needs other ones
 struct DrawData {
-    static constexpr unsigned MAX_MESHES = 64;
-
-    std::array<MeshData, MAX_MESHES> mesh_data;
+    // Max number of different meshes (draw calls) in a batch
+    static constexpr unsigned MAX_MESHES = 4096;
+    // 11 KiB: the block fits, together with FrameData, in the 16 KiB
+    // GL_MAX_UNIFORM_BLOCK_SIZE every OpenGL ES 3 device supports
+    static constexpr unsigned MAX_UNIFORM_INSTANCES = 64;
 
     static constexpr uint32_t BLOCK_BINDING = 1;
     static constexpr const char BLOCK_NAME[] = "DrawData";
 
-    constexpr MeshData& operator[](size_t index) { return mesh_data[index]; }
-    constexpr const MeshData& operator[](size_t index) const {
-        return mesh_data[index];
-    }
+    // With bindless textures: the handles of every texture used in a frame,
+    // indexed by MaterialData::texture_indices
+    static constexpr uint32_t TEXTURE_TABLE_BINDING = 2;
 };
 }  // namespace verna::gpu
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,7 @@
 #ifndef VERNA_MAT4F_HPP
 #define VERNA_MAT4F_HPP
 
+#include "Simd.hpp"
 #include "Vec3f.hpp"
 #include "Vec4f.hpp"
 #include <viverna/core/Debug.hpp>
@@ -8,8 +9,16 @@
 #include <array>
 #include <cstddef>
 
+// VIVERNA_ALIGNED_MATRICES: 16 byte aligned matrices, loaded with aligned
+// SIMD instructions
+#if defined(VERNA_ALIGNED_MAT4F)
+#define VERNA_MAT4F_ALIGNMENT 16
+#else
+#define VERNA_MAT4F_ALIGNMENT alignof(float)
+#endif
+
 namespace verna {
-struct Mat4f {
+struct alignas(VERNA_MAT4F_ALIGNMENT) Mat4f {
     std::array<float, 16> raw;
 
     constexpr Mat4f() : raw{} {}
@@ -25,6 +34,34 @@ struct Mat4f {
     constexpr float& operator[](size_t index) { return raw[index]; }
     constexpr Mat4f Inverted() const;
     constexpr Mat4f Transposed() const;
+    /**
+     * @brief Same as Inverted().Transposed(), without the transposition
+     * when computed with SIMD. Gives the normal matrix of a model matrix
+     *
+     * @return The transpose of the inverse
+     */
+    constexpr Mat4f InvertedTransposed() const;
+
+    /**
+     * @brief Computes result[i] = left * right[i]
+     *
+     * @param left left operand, shared by every product
+     * @param right count right operands
+     * @param result count products, may be the same array as right
+     * @param count number of products
+     */
+    static void MultiplyMany(const Mat4f& left,
+                             const Mat4f* right,
+                             Mat4f* result,
+                             size_t count);
+    /**
+     * @brief Computes result[i] = matrices[i].Inverted()
+     *
+     * @param matrices count matrices to invert
+     * @param result count inverses, may be the same array as matrices
+     * @param count number of matrices
+     */
+    static void InvertMany(const Mat4f* matrices, Mat4f* result, size_t count);
 
     static constexpr Mat4f Identity() { return Mat4f(1.0f); }
     static Mat4f Rotation(const Vec3f& unit_axis, float radians);
@@ -76,6 +113,144 @@ struct Mat4f {
     }
 };
 
+namespace detail {
+// Error log of Inverted(), out of line to keep the kernels small
+void LogNotInvertible(const Mat4f& matrix);
+
+#if defined(VERNA_SIMD)
+inline simd::Float4 LoadColumn(const Mat4f& matrix, size_t column) {
+#if defined(VERNA_ALIGNED_MAT4F)
+    return simd::LoadAligned(&matrix.raw[4 * column]);
+#else
+    return simd::Load(&matrix.raw[4 * column]);
+#endif
+}
+
+inline void StoreColumn(Mat4f& matrix, size_t column, simd::Float4 value) {
+#if defined(VERNA_ALIGNED_MAT4F)
+    simd::StoreAligned(&matrix.raw[4 * column], value);
+#else
+    simd::Store(&matrix.raw[4 * column], value);
+#endif
+}
+
+// a0-a3 are the columns of the left operand. Same order of operations as
+// the scalar product, the results only differ when MulAdd is fused
+inline simd::Float4 MultiplyColumn(simd::Float4 a0,
+                                   simd::Float4 a1,
+                                   simd::Float4 a2,
+                                   simd::Float4 a3,
+                                   const float* column) {
+    simd::Float4 result = simd::Mul(a0, simd::Splat(column[0]));
+    result = simd::MulAdd(a1, simd::Splat(column[1]), result);
+    result = simd::MulAdd(a2, simd::Splat(column[2]), result);
+    return simd::MulAdd(a3, simd::Splat(column[3]), result);
+}
+
+inline Mat4f Multiply(const Mat4f& a, const Mat4f& b) {
+    simd::Float4 a0 = LoadColumn(a, 0);
+    simd::Float4 a1 = LoadColumn(a, 1);
+    simd::Float4 a2 = LoadColumn(a, 2);
+    simd::Float4 a3 = LoadColumn(a, 3);
+    Mat4f result;
+    for (size_t i = 0; i < 4; i++)
+        StoreColumn(result, i,
+                    MultiplyColumn(a0, a1, a2, a3, &b.raw[4 * i]));
+    return result;
+}
+
+inline Vec4f Multiply(const Mat4f& mtx, const Vec4f& vec) {
+    const float column[4] = {vec.x, vec.y, vec.z, vec.w};
+    float result[4];
+    simd::Store(result, MultiplyColumn(LoadColumn(mtx, 0), LoadColumn(mtx, 1),
+                                       LoadColumn(mtx, 2), LoadColumn(mtx, 3),
+                                       column));
+    return Vec4f(result[0], result[1], result[2], result[3]);
+}
+
+// row with its fourth element taken from last[i]
+template <int i>
+inline simd::Float4 WithLast(simd::Float4 row, simd::Float4 last) {
+    simd::Float4 high = simd::Shuffle<2, 2, i, i>(row, last);
+    return simd::Shuffle<0, 1, 0, 2>(row, high);
+}
+
+// Inverse from the cross products of the columns (E. Lengyel, Foundations
+// of Game Engine Development, vol. 1): the rows of the inverse come out
+// directly, so the transposed inverse is the cheaper one
+template <bool transposed>
+inline Mat4f Invert(const Mat4f& matrix) {
+    simd::Float4 a = LoadColumn(matrix, 0);
+    simd::Float4 b = LoadColumn(matrix, 1);
+    simd::Float4 c = LoadColumn(matrix, 2);
+    simd::Float4 d = LoadColumn(matrix, 3);
+    // last row
+    simd::Float4 x = simd::Broadcast<3>(a);
+    simd::Float4 y = simd::Broadcast<3>(b);
+    simd::Float4 z = simd::Broadcast<3>(c);
+    simd::Float4 w = simd::Broadcast<3>(d);
+
+    // the fourth lane of s, t, u and v is 0
+    simd::Float4 s = simd::Cross3(a, b);
+    simd::Float4 t = simd::Cross3(c, d);
+    simd::Float4 u = simd::Sub(simd::Mul(a, y), simd::Mul(b, x));
+    simd::Float4 v = simd::Sub(simd::Mul(c, w), simd::Mul(d, z));
+    simd::Float4 det = simd::HorizontalSum(
+        simd::Add(simd::Mul(s, v), simd::Mul(t, u)));
+    if (simd::First(det) == 0.0f)
+        LogNotInvertible(matrix);
+    simd::Float4 inv_det = simd::Div(simd::Splat(1.0f), det);
+    s = simd::Mul(s, inv_det);
+    t = simd::Mul(t, inv_det);
+    u = simd::Mul(u, inv_det);
+    v = simd::Mul(v, inv_det);
+
+    // rows of the inverse, without their last element
+    simd::Float4 r0 = simd::MulAdd(t, y, simd::Cross3(b, v));
+    simd::Float4 r1 = simd::Sub(simd::Cross3(v, a), simd::Mul(t, x));
+    simd::Float4 r2 = simd::MulAdd(s, w, simd::Cross3(d, u));
+    simd::Float4 r3 = simd::Sub(simd::Cross3(u, c), simd::Mul(s, z));
+    // last column: (-b.t, a.t, -d.s, c.s)
+    simd::Float4 p0 = simd::Mul(b, t);
+    simd::Float4 p1 = simd::Mul(a, t);
+    simd::Float4 p2 = simd::Mul(d, s);
+    simd::Float4 p3 = simd::Mul(c, s);
+    simd::Transpose(p0, p1, p2, p3);
+    simd::Float4 last = simd::Add(simd::Add(p0, p1), simd::Add(p2, p3));
+    last = simd::Mul(last, simd::Set(-1.0f, 1.0f, -1.0f, 1.0f));
+
+    Mat4f result;
+    if constexpr (transposed) {
+        StoreColumn(result, 0, WithLast<0>(r0, last));
+        StoreColumn(result, 1, WithLast<1>(r1, last));
+        StoreColumn(result, 2, WithLast<2>(r2, last));
+        StoreColumn(result, 3, WithLast<3>(r3, last));
+    } else {
+        simd::Transpose(r0, r1, r2, r3);
+        StoreColumn(result, 0, r0);
+        StoreColumn(result, 1, r1);
+        StoreColumn(result, 2, r2);
+        StoreColumn(result, 3, last);
+    }
+    return result;
+}
+
+inline Mat4f Transpose(const Mat4f& matrix) {
+    simd::Float4 c0 = LoadColumn(matrix, 0);
+    simd::Float4 c1 = LoadColumn(matrix, 1);
+    simd::Float4 c2 = LoadColumn(matrix, 2);
+    simd::Float4 c3 = LoadColumn(matrix, 3);
+    simd::Transpose(c0, c1, c2, c3);
+    Mat4f result;
+    StoreColumn(result, 0, c0);
+    StoreColumn(result, 1, c1);
+    StoreColumn(result, 2, c2);
+    StoreColumn(result, 3, c3);
+    return result;
+}
+#endif
+}  // namespace detail
+
 /**
  * @brief Computes the matrix multiplication
  *
@@ -84,6 +259,10 @@ struct Mat4f {
  * @return The matrix product
  */
 constexpr Mat4f operator*(const Mat4f& a, const Mat4f& b) {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::Multiply(a, b);
+#endif
     Mat4f result;
     result[0] = a[0] * b[0] + a[4] * b[1] + a[8] * b[2] + a[12] * b[3];
     result[1] = a[1] * b[0] + a[5] * b[1] + a[9] * b[2] + a[13] * b[3];
@@ -105,6 +284,10 @@ constexpr Mat4f operator*(const Mat4f& a, const Mat4f& b) {
 }
 
 constexpr Vec4f operator*(const Mat4f& mtx, const Vec4f& vec) {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::Multiply(mtx, vec);
+#endif
     return Vec4f(
         mtx[0] * vec.x + mtx[4] * vec.y + mtx[8] * vec.z + mtx[12] * vec.w,
         mtx[1] * vec.x + mtx[5] * vec.y + mtx[9] * vec.z + mtx[13] * vec.w,
@@ -113,6 +296,10 @@ constexpr Vec4f operator*(const Mat4f& mtx, const Vec4f& vec) {
 }
 
 constexpr Mat4f Mat4f::Inverted() const {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::Invert<false>(*this);
+#endif
     Mat4f inv;
     inv[0] = raw[5] * raw[10] * raw[15] - raw[5] * raw[11] * raw[14]
              - raw[9] * raw[6] * raw[15] + raw[9] * raw[7] * raw[14]
@@ -181,25 +368,20 @@ constexpr Mat4f Mat4f::Inverted() const {
     float det =
         raw[0] * inv[0] + raw[1] * inv[4] + raw[2] * inv[8] + raw[3] * inv[12];
 
-    [[maybe_unused]] auto ToString = [](const std::array<float, 16>& arr) {
-        std::string result;
-        for (size_t i = 0; i < 4; i++) {
-            result += std::to_string(arr[i]) + '\t' + std::to_string(arr[i + 4])
-                      + '\t' + std::to_string(arr[i + 8]) + '\t'
-                      + std::to_string(arr[i + 12]) + '\n';
-        }
-        return result;
-    };
-    VERNA_LOGE_IF(det == 0.0f,
-                  "Math error: can't invert matrix!\n" + ToString(raw));
+    if (det == 0.0f)
+        detail::LogNotInvertible(*this);
 
-    det = 1.0 / det;
+    det = 1.0f / det;
     for (auto i = 0; i < 16; i++)
         inv[i] *= det;
     return inv;
 }
 
 constexpr Mat4f Mat4f::Transposed() const {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::Transpose(*this);
+#endif
     return Mat4f({
         raw[0], raw[4], raw[8], raw[12],   // first column
         raw[1], raw[5], raw[9], raw[13],   // second
@@ -207,6 +389,14 @@ constexpr Mat4f Mat4f::Transposed() const {
         raw[3], raw[7], raw[11], raw[15],  // fourth
     });
 }
+
+constexpr Mat4f Mat4f::InvertedTransposed() const {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::Invert<true>(*this);
+#endif
+    return Inverted().Transposed();
+}
 }  // namespace verna
 
 #endif
\ No newline at end of file
@@ -80,20 +80,7 @@ struct Quaternion {
      *
      * @return Equivalent rotation matrix
      */
-    constexpr Mat4f AsMatrix() const {
-        Mat4f r;
-        r[0] = 1.0f - 2.0f * (y * y + z * z);
-        r[1] = 2.0f * (x * y + w * z);
-        r[2] = 2.0f * (x * z - w * y);
-        r[4] = 2.0f * (x * y - w * z);
-        r[5] = 1.0f - 2.0f * (x * x + z * z);
-        r[6] = 2.0f * (y * z + w * x);
-        r[8] = 2.0f * (x * z + w * y);
-        r[9] = 2.0f * (y * z - w * x);
-        r[10] = 1.0f - 2.0f * (x * x + y * y);
-        r[15] = 1.0f;
-        return r;
-    }
+    constexpr Mat4f AsMatrix() const;
 
     static constexpr Quaternion Lerp(const Quaternion& a,
                                      const Quaternion& b,
@@ -104,6 +91,59 @@ struct Quaternion {
     }
 };
 
+namespace detail {
+#if defined(VERNA_SIMD)
+// Rotation matrix of q with its columns scaled by scale, followed by the
+// translation. Whole columns are stored at once: a matrix written float by
+// float and then loaded as columns stalls on store forwarding
+inline Mat4f TransformMatrix(const Quaternion& q,
+                             const Vec3f& scale,
+                             const Vec3f& translation) {
+    float xx = q.x * q.x;
+    float yy = q.y * q.y;
+    float zz = q.z * q.z;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float yz = q.y * q.z;
+    float wx = q.w * q.x;
+    float wy = q.w * q.y;
+    float wz = q.w * q.z;
+    simd::Float4 c0 = simd::Set(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz),
+                                2.0f * (xz - wy), 0.0f);
+    simd::Float4 c1 = simd::Set(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz),
+                                2.0f * (yz + wx), 0.0f);
+    simd::Float4 c2 = simd::Set(2.0f * (xz + wy), 2.0f * (yz - wx),
+                                1.0f - 2.0f * (xx + yy), 0.0f);
+    Mat4f result;
+    StoreColumn(result, 0, simd::Mul(c0, simd::Splat(scale.x)));
+    StoreColumn(result, 1, simd::Mul(c1, simd::Splat(scale.y)));
+    StoreColumn(result, 2, simd::Mul(c2, simd::Splat(scale.z)));
+    StoreColumn(result, 3,
+                simd::Set(translation.x, translation.y, translation.z, 1.0f));
+    return result;
+}
+#endif
+}  // namespace detail
+
+constexpr Mat4f Quaternion::AsMatrix() const {
+#if defined(VERNA_SIMD)
+    if (!VERNA_IS_CONSTANT_EVALUATED())
+        return detail::TransformMatrix(*this, Vec3f(1.0f), Vec3f());
+#endif
+    Mat4f r;
+    r[0] = 1.0f - 2.0f * (y * y + z * z);
+    r[1] = 2.0f * (x * y + w * z);
+    r[2] = 2.0f * (x * z - w * y);
+    r[4] = 2.0f * (x * y - w * z);
+    r[5] = 1.0f - 2.0f * (x * x + z * z);
+    r[6] = 2.0f * (y * z + w * x);
+    r[8] = 2.0f * (x * z + w * y);
+    r[9] = 2.0f * (y * z - w * x);
+    r[10] = 1.0f - 2.0f * (x * x + y * y);
+    r[15] = 1.0f;
+    return r;
+}
+
 /**
  * @brief Computes the result of rotation p applied after rotation q
  *
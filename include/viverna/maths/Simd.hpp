@@ -0,0 +1,197 @@
+#ifndef VERNA_SIMD_HPP
+#define VERNA_SIMD_HPP
+
+// Four float wide vectors used by the maths kernels.
+// VERNA_SIMD_SSE or VERNA_SIMD_NEON is defined when the target has them,
+// neither of them with VERNA_NO_SIMD (VIVERNA_SIMD=OFF) or when the compiler
+// can't tell constant evaluation apart: constexpr functions use the
+// vectors only at runtime and keep their scalar code for constant
+// expressions.
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define VERNA_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+#if !defined(VERNA_HAS_IS_CONSTANT_EVALUATED)                 \
+    && ((defined(__GNUC__) && __GNUC__ >= 9 && !defined(__clang__)) \
+        || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define VERNA_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+
+#if !defined(VERNA_NO_SIMD) && defined(VERNA_HAS_IS_CONSTANT_EVALUATED)
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERNA_SIMD_SSE 1
+#elif defined(__ARM_NEON) && (defined(__GNUC__) || defined(__clang__))
+#define VERNA_SIMD_NEON 1
+#endif
+#endif
+
+#if defined(VERNA_SIMD_SSE)
+#include <immintrin.h>
+#elif defined(VERNA_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(VERNA_SIMD_SSE) || defined(VERNA_SIMD_NEON)
+#define VERNA_SIMD 1
+// true while evaluating a constant expression
+#define VERNA_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+
+namespace verna::simd {
+#if defined(VERNA_SIMD_SSE)
+using Float4 = __m128;
+
+inline Float4 Load(const float* src) {
+    return _mm_loadu_ps(src);
+}
+inline Float4 LoadAligned(const float* src) {
+    return _mm_load_ps(src);
+}
+inline void Store(float* dst, Float4 v) {
+    _mm_storeu_ps(dst, v);
+}
+inline void StoreAligned(float* dst, Float4 v) {
+    _mm_store_ps(dst, v);
+}
+inline Float4 Set(float x, float y, float z, float w) {
+    return _mm_setr_ps(x, y, z, w);
+}
+inline Float4 Splat(float value) {
+    return _mm_set1_ps(value);
+}
+inline Float4 Add(Float4 a, Float4 b) {
+    return _mm_add_ps(a, b);
+}
+inline Float4 Sub(Float4 a, Float4 b) {
+    return _mm_sub_ps(a, b);
+}
+inline Float4 Mul(Float4 a, Float4 b) {
+    return _mm_mul_ps(a, b);
+}
+inline Float4 Div(Float4 a, Float4 b) {
+    return _mm_div_ps(a, b);
+}
+// a * b + c, fused when the target has FMA (-mfma, -march=haswell...)
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) {
+#if defined(__FMA__)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+inline float First(Float4 v) {
+    return _mm_cvtss_f32(v);
+}
+// (a[i0], a[i1], b[j0], b[j1])
+template <int i0, int i1, int j0, int j1>
+inline Float4 Shuffle(Float4 a, Float4 b) {
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(j1, j0, i1, i0));
+}
+#elif defined(VERNA_SIMD_NEON)
+using Float4 = float32x4_t;
+
+inline Float4 Load(const float* src) {
+    return vld1q_f32(src);
+}
+inline Float4 LoadAligned(const float* src) {
+    return vld1q_f32(src);
+}
+inline void Store(float* dst, Float4 v) {
+    vst1q_f32(dst, v);
+}
+inline void StoreAligned(float* dst, Float4 v) {
+    vst1q_f32(dst, v);
+}
+inline Float4 Set(float x, float y, float z, float w) {
+    const float values[4] = {x, y, z, w};
+    return vld1q_f32(values);
+}
+inline Float4 Splat(float value) {
+    return vdupq_n_f32(value);
+}
+inline Float4 Add(Float4 a, Float4 b) {
+    return vaddq_f32(a, b);
+}
+inline Float4 Sub(Float4 a, Float4 b) {
+    return vsubq_f32(a, b);
+}
+inline Float4 Mul(Float4 a, Float4 b) {
+    return vmulq_f32(a, b);
+}
+inline Float4 Div(Float4 a, Float4 b) {
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    // two Newton-Raphson steps on the reciprocal estimate
+    Float4 reciprocal = vrecpeq_f32(b);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, reciprocal);
+#endif
+}
+// a * b + c
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) {
+#if defined(__aarch64__)
+    return vfmaq_f32(c, a, b);
+#else
+    return vmlaq_f32(c, a, b);
+#endif
+}
+inline float First(Float4 v) {
+    return vgetq_lane_f32(v, 0);
+}
+// (a[i0], a[i1], b[j0], b[j1])
+template <int i0, int i1, int j0, int j1>
+inline Float4 Shuffle(Float4 a, Float4 b) {
+#if defined(__clang__)
+    return __builtin_shufflevector(a, b, i0, i1, j0 + 4, j1 + 4);
+#else
+    using Mask = __attribute__((vector_size(16))) int;
+    return __builtin_shuffle(a, b, Mask{i0, i1, j0 + 4, j1 + 4});
+#endif
+}
+#endif
+
+// (v[i0], v[i1], v[i2], v[i3])
+template <int i0, int i1, int i2, int i3>
+inline Float4 Swizzle(Float4 v) {
+    return Shuffle<i0, i1, i2, i3>(v, v);
+}
+
+// every lane set to v[i]
+template <int i>
+inline Float4 Broadcast(Float4 v) {
+    return Swizzle<i, i, i, i>(v);
+}
+
+// sum of the lanes, in every lane
+inline Float4 HorizontalSum(Float4 v) {
+    v = Add(v, Swizzle<1, 0, 3, 2>(v));
+    return Add(v, Swizzle<2, 3, 0, 1>(v));
+}
+
+// Cross product of the first three lanes, the fourth one of the result is 0
+// for finite inputs
+inline Float4 Cross3(Float4 a, Float4 b) {
+    Float4 zxy = Sub(Mul(a, Swizzle<1, 2, 0, 3>(b)),
+                     Mul(Swizzle<1, 2, 0, 3>(a), b));
+    return Swizzle<1, 2, 0, 3>(zxy);
+}
+
+// Rows become columns
+inline void Transpose(Float4& c0, Float4& c1, Float4& c2, Float4& c3) {
+    Float4 t0 = Shuffle<0, 1, 0, 1>(c0, c1);
+    Float4 t1 = Shuffle<0, 1, 0, 1>(c2, c3);
+    Float4 t2 = Shuffle<2, 3, 2, 3>(c0, c1);
+    Float4 t3 = Shuffle<2, 3, 2, 3>(c2, c3);
+    c0 = Shuffle<0, 2, 0, 2>(t0, t1);
+    c1 = Shuffle<1, 3, 1, 3>(t0, t1);
+    c2 = Shuffle<0, 2, 0, 2>(t2, t3);
+    c3 = Shuffle<1, 3, 1, 3>(t2, t3);
+}
+}  // namespace verna::simd
+#endif
+
+#endif
@@ -7,10 +7,29 @@
 
 #include <yaml-cpp/yaml.h>
 namespace verna {
+/**
+ * @brief Writes every entity with a name, material, mesh, shader and
+ * transform as a map under its name:
+ *
+ * Entity name:
+ *   material: ...
+ *   mesh: CUBE, PYRAMID, SPHERE or path.obj##group
+ *   lods: true  # optional, see DeserializeWorld
+ *   shader: ...
+ *   transform: ...
+ *
+ */
 YAML::Emitter& SerializeWorld(YAML::Emitter& emitter,
                               ShaderManager& shader_man,
                               TextureManager& texture_man,
                               const World& world);
+/**
+ * @brief Reads the entities written by SerializeWorld. OBJ meshes get levels
+ * of detail (see Mesh::GenerateLods) only when their entity has "lods: true",
+ * since generating them costs more than loading the file
+ *
+ * @return false if a node is missing or invalid
+ */
 bool DeserializeWorld(const YAML::Node& node,
                       ShaderManager& shader_man,
                       TextureManager& texture_man,
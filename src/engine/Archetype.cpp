@@ -0,0 +1,83 @@
+#include <viverna/ecs/Archetype.hpp>
+#include <viverna/core/Debug.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace verna {
+
+Archetype::Archetype(
+    std::vector<std::unique_ptr<BaseComponentColumn>>&& prototypes_) :
+    prototypes(std::move(prototypes_)) {
+    size_t row_size = 0;
+    types.reserve(prototypes.size());
+    for (const auto& p : prototypes) {
+        types.push_back(p->GetType());
+        row_size += p->ElementSize();
+    }
+    VERNA_ASSERT(std::is_sorted(types.begin(), types.end()));
+    size_t capacity = row_size == 0 ? CHUNK_BYTES : CHUNK_BYTES / row_size;
+    chunk_capacity = static_cast<uint32_t>(std::max<size_t>(capacity, 1));
+}
+
+bool Archetype::Contains(TypeId type) const {
+    return std::binary_search(types.begin(), types.end(), type);
+}
+
+bool Archetype::Matches(const Family& family) const {
+    for (TypeId type : family)
+        if (!Contains(type))
+            return false;
+    return true;
+}
+
+uint32_t Archetype::ColumnIndex(TypeId type) const {
+    auto it = std::lower_bound(types.begin(), types.end(), type);
+    if (it == types.end() || *it != type)
+        return INVALID_COLUMN;
+    return static_cast<uint32_t>(it - types.begin());
+}
+
+size_t Archetype::Size() const {
+    if (chunks.empty())
+        return 0;
+    return (chunks.size() - 1) * chunk_capacity + chunks.back().Size();
+}
+
+uint32_t Archetype::ChunkWithSpace() {
+    if (!chunks.empty() && chunks.back().Size() < chunk_capacity)
+        return static_cast<uint32_t>(chunks.size() - 1);
+    ArchetypeChunk& chunk = chunks.emplace_back();
+    chunk.entities.reserve(chunk_capacity);
+    chunk.columns.reserve(prototypes.size());
+    for (const auto& p : prototypes)
+        chunk.columns.push_back(p->NewEmpty(chunk_capacity));
+    return static_cast<uint32_t>(chunks.size() - 1);
+}
+
+bool Archetype::RemoveRow(uint32_t chunk, uint32_t row, Entity& out_moved) {
+    VERNA_ASSERT(chunk < chunks.size() && row < chunks[chunk].Size());
+    ArchetypeChunk& last_chunk = chunks.back();
+    auto last_row = static_cast<uint32_t>(last_chunk.Size() - 1);
+    ArchetypeChunk& target = chunks[chunk];
+    bool moved = (&target != &last_chunk) || (row != last_row);
+    if (moved) {
+        for (size_t i = 0; i < target.columns.size(); i++)
+            target.columns[i]->AssignFrom(row, *last_chunk.columns[i],
+                                          last_row);
+        target.entities[row] = last_chunk.entities[last_row];
+        out_moved = target.entities[row];
+    }
+    for (auto& column : last_chunk.columns)
+        column->PopBack();
+    last_chunk.entities.pop_back();
+    if (last_chunk.entities.empty())
+        chunks.pop_back();
+    return moved;
+}
+
+void Archetype::Clear() {
+    chunks.clear();
+}
+
+}  // namespace verna
@@ -0,0 +1,134 @@
+#include <viverna/ecs/ArchetypeStorage.hpp>
+
+namespace verna {
+
+ArchetypeStorage::Location ArchetypeStorage::GetLocation(Entity e) const {
+    if (e.id >= locations.size())
+        return Location();
+    Location loc = locations[e.id];
+    if (loc.archetype == INVALID_ARCHETYPE)
+        return loc;
+    const ArchetypeChunk& chunk = archetypes[loc.archetype].Chunks()[loc.chunk];
+    return chunk.entities[loc.row] == e ? loc : Location();
+}
+
+bool ArchetypeStorage::HasComponent(Entity e, TypeId comp_type) const {
+    Location loc = GetLocation(e);
+    if (loc.archetype == INVALID_ARCHETYPE)
+        return false;
+    return archetypes[loc.archetype].Contains(comp_type);
+}
+
+bool ArchetypeStorage::Matches(Entity e, const Family& family) const {
+    Location loc = GetLocation(e);
+    if (loc.archetype == INVALID_ARCHETYPE)
+        return false;
+    return archetypes[loc.archetype].Matches(family);
+}
+
+void ArchetypeStorage::GetEntitiesInFamily(
+    const Family& family,
+    std::vector<Entity>& out_entities) const {
+    for (const Archetype& archetype : archetypes) {
+        if (!archetype.Matches(family))
+            continue;
+        for (const ArchetypeChunk& chunk : archetype.Chunks())
+            out_entities.insert(out_entities.end(), chunk.entities.begin(),
+                                chunk.entities.end());
+    }
+}
+
+void ArchetypeStorage::Clear() {
+    archetypes.clear();
+    locations.clear();
+}
+
+void ArchetypeStorage::RemoveEntity(Entity e) {
+    if (GetLocation(e).archetype != INVALID_ARCHETYPE)
+        RemoveFromArchetype(e);
+}
+
+void ArchetypeStorage::RemoveComponent(Entity e, TypeId comp_type) {
+    Location loc = GetLocation(e);
+    if (loc.archetype == INVALID_ARCHETYPE)
+        return;
+    uint32_t src = loc.archetype;
+    if (!archetypes[src].Contains(comp_type))
+        return;
+    if (archetypes[src].Types().size() == 1) {
+        RemoveFromArchetype(e);
+        return;
+    }
+    uint32_t dst = INVALID_ARCHETYPE;
+    for (const auto& [edge_type, edge_dst] : archetypes[src].remove_edges) {
+        if (edge_type == comp_type) {
+            dst = edge_dst;
+            break;
+        }
+    }
+    if (dst == INVALID_ARCHETYPE) {
+        std::vector<std::unique_ptr<BaseComponentColumn>> prototypes;
+        std::vector<TypeId> types;
+        const auto& src_types = archetypes[src].Types();
+        for (uint32_t i = 0; i < src_types.size(); i++) {
+            if (src_types[i] == comp_type)
+                continue;
+            prototypes.push_back(archetypes[src].Prototype(i).NewEmpty(0));
+            types.push_back(src_types[i]);
+        }
+        dst = FindArchetype(types);
+        if (dst == INVALID_ARCHETYPE) {
+            dst = static_cast<uint32_t>(archetypes.size());
+            archetypes.emplace_back(std::move(prototypes));
+        }
+        archetypes[src].remove_edges.emplace_back(comp_type, dst);
+    }
+    MoveEntity(e, dst);
+}
+
+void ArchetypeStorage::RemoveFromArchetype(Entity e) {
+    Location& loc = locations[e.id];
+    Entity moved;
+    if (archetypes[loc.archetype].RemoveRow(loc.chunk, loc.row, moved))
+        locations[moved.id] = loc;
+    loc = Location();
+}
+
+uint32_t ArchetypeStorage::FindArchetype(
+    const std::vector<TypeId>& types) const {
+    for (size_t i = 0; i < archetypes.size(); i++)
+        if (archetypes[i].Types() == types)
+            return static_cast<uint32_t>(i);
+    return INVALID_ARCHETYPE;
+}
+
+void ArchetypeStorage::MoveEntity(Entity e, uint32_t dst_archetype) {
+    if (e.id >= locations.size())
+        locations.resize(e.id + 1);
+    Location src_loc = locations[e.id];
+    Archetype& dst = archetypes[dst_archetype];
+    uint32_t dst_chunk_index = dst.ChunkWithSpace();
+    ArchetypeChunk& dst_chunk = dst.Chunks()[dst_chunk_index];
+    auto dst_row = static_cast<uint32_t>(dst_chunk.Size());
+    if (src_loc.archetype != INVALID_ARCHETYPE) {
+        Archetype& src = archetypes[src_loc.archetype];
+        ArchetypeChunk& src_chunk = src.Chunks()[src_loc.chunk];
+        const auto& src_types = src.Types();
+        for (size_t i = 0; i < src_types.size(); i++) {
+            uint32_t column = dst.ColumnIndex(src_types[i]);
+            if (column != Archetype::INVALID_COLUMN)
+                dst_chunk.columns[column]->PushFrom(*src_chunk.columns[i],
+                                                    src_loc.row);
+        }
+        Entity moved;
+        if (src.RemoveRow(src_loc.chunk, src_loc.row, moved))
+            locations[moved.id] = src_loc;
+    }
+    dst_chunk.entities.push_back(e);
+    Location& loc = locations[e.id];
+    loc.archetype = dst_archetype;
+    loc.chunk = dst_chunk_index;
+    loc.row = dst_row;
+}
+
+}  // namespace verna
@@ -0,0 +1,100 @@
+#include "BindlessTextures.hpp"
+#include <viverna/core/Debug.hpp>
+#include <viverna/data/SparseSet.hpp>
+
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#elif defined(VERNA_ANDROID)
+#include <GLES3/gl32.h>
+#else
+#error Platform not supported!
+#endif
+
+#include <vector>
+
+namespace verna::bindless {
+
+#if defined(VERNA_DESKTOP) && !defined(VERNA_NULL_BACKEND)
+
+// the bundled glad loader doesn't include extensions
+using GetTextureHandleFn = GLuint64(GLAD_API_PTR*)(GLuint texture);
+using MakeHandleResidentFn = void(GLAD_API_PTR*)(GLuint64 handle);
+
+static GetTextureHandleFn get_texture_handle = nullptr;
+static MakeHandleResidentFn make_resident = nullptr;
+static MakeHandleResidentFn make_non_resident = nullptr;
+static SparseSet<TextureId::id_type> textures;
+// parallel to textures.GetDense()
+static std::vector<uint64_t> handles;
+
+void Initialize() {
+    get_texture_handle = nullptr;
+    make_resident = nullptr;
+    make_non_resident = nullptr;
+    if (!glfwExtensionSupported("GL_ARB_bindless_texture")) {
+        VERNA_LOGI("GL_ARB_bindless_texture not supported");
+        return;
+    }
+    get_texture_handle = reinterpret_cast<GetTextureHandleFn>(
+        glfwGetProcAddress("glGetTextureHandleARB"));
+    make_resident = reinterpret_cast<MakeHandleResidentFn>(
+        glfwGetProcAddress("glMakeTextureHandleResidentARB"));
+    make_non_resident = reinterpret_cast<MakeHandleResidentFn>(
+        glfwGetProcAddress("glMakeTextureHandleNonResidentARB"));
+    if (!IsSupported())
+        VERNA_LOGW("GL_ARB_bindless_texture entry points not found");
+}
+
+bool IsSupported() {
+    return get_texture_handle != nullptr && make_resident != nullptr
+           && make_non_resident != nullptr;
+}
+
+void Register(TextureId texture) {
+    if (!IsSupported() || textures.Contains(texture.id))
+        return;
+    GLuint64 handle = get_texture_handle(texture.id);
+    if (handle == 0) {
+        VERNA_LOGE("glGetTextureHandleARB failed for texture ", texture.id);
+        return;
+    }
+    make_resident(handle);
+    textures.Add(texture.id);
+    handles.push_back(handle);
+}
+
+void Unregister(TextureId texture) {
+    SparseSet<TextureId::id_type>::index_t index;
+    if (!textures.GetIndex(texture.id, index))
+        return;
+    make_non_resident(handles[index]);
+    // mirror SparseSet's swap-and-pop
+    textures.Remove(texture.id);
+    handles[index] = handles.back();
+    handles.pop_back();
+}
+
+uint64_t GetHandle(TextureId texture) {
+    SparseSet<TextureId::id_type>::index_t index;
+    return textures.GetIndex(texture.id, index) ? handles[index] : 0;
+}
+
+#else
+// no extension on GLES nor on the null backend
+
+void Initialize() {}
+bool IsSupported() {
+    return false;
+}
+void Register([[maybe_unused]] TextureId texture) {}
+void Unregister([[maybe_unused]] TextureId texture) {}
+uint64_t GetHandle([[maybe_unused]] TextureId texture) {
+    return 0;
+}
+
+#endif
+
+}  // namespace verna::bindless
@@ -0,0 +1,25 @@
+#ifndef VERNA_BINDLESS_TEXTURES_HPP
+#define VERNA_BINDLESS_TEXTURES_HPP
+
+#include <viverna/graphics/Texture.hpp>
+
+#include <cstdint>
+
+// ARB_bindless_texture: shaders sample textures through 64-bit handles
+// stored in buffers, so the number of textures used by a draw is not
+// limited by the texture units. Only available on desktop, when the driver
+// exposes the extension
+namespace verna::bindless {
+// Loads the extension entry points, call after the GL context is current
+void Initialize();
+bool IsSupported();
+// Creates the handle of a texture and makes it resident. Texture parameters
+// can't change afterwards
+void Register(TextureId texture);
+// Makes the handle non resident, call before deleting the texture
+void Unregister(TextureId texture);
+// 0 if the texture is not registered
+uint64_t GetHandle(TextureId texture);
+}  // namespace verna::bindless
+
+#endif
@@ -3,21 +3,28 @@
 namespace verna {
 void BaseComponentBuffer::Clear() {
     sparse_set.Clear();
+    entities.clear();
+    ClearComponents();
 }
 bool BaseComponentBuffer::Contains(Entity e) const {
-    return sparse_set.Contains(e.id);
+    index_t i;
+    return GetIndex(e, i);
+}
+bool BaseComponentBuffer::GetIndex(Entity e, index_t& out_index) const {
+    return sparse_set.GetIndex(e.id, out_index)
+           && entities[out_index].generation == e.generation;
 }
 std::vector<Entity> BaseComponentBuffer::GetEntities() const {
-    std::vector<Entity> result;
-    const auto& ids = sparse_set.GetDense();
-    size_t n = ids.size();
-    result.reserve(n);
-    Entity e;
-    for (size_t i = 0; i < n; i++) {
-        e.id = ids[i];
-        if (Contains(e))
-            result.push_back(e);
-    }
-    return result;
+    return entities;
+}
+bool BaseComponentBuffer::Remove(Entity e) {
+    index_t i;
+    if (!GetIndex(e, i))
+        return false;
+    SwapAndPop(i);
+    entities[i] = entities.back();
+    entities.pop_back();
+    sparse_set.Remove(e.id);
+    return true;
 }
 }  // namespace verna
@@ -0,0 +1,123 @@
+#include "FrustumCulling.hpp"
+#include <viverna/maths/Simd.hpp>
+
+namespace verna {
+
+namespace {
+enum Coord { MIN_X, MIN_Y, MIN_Z, MAX_X, MAX_Y, MAX_Z };
+
+// For each plane, the box corner farthest along the normal (positive
+// vertex) is the one picked by the signs of the normal: if even that corner
+// is outside, the whole box is
+struct PlaneTest {
+    float a, b, c, d;
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+std::array<PlaneTest, 6> MakeTests(
+    const Frustum& frustum,
+    const std::array<std::vector<float>, 6>& coords) {
+    std::array<PlaneTest, 6> tests;
+    for (size_t i = 0; i < tests.size(); i++) {
+        const Vec4f& p = frustum.planes[i];
+        tests[i] = {p.x,
+                    p.y,
+                    p.z,
+                    p.w,
+                    coords[p.x >= 0.0f ? MAX_X : MIN_X].data(),
+                    coords[p.y >= 0.0f ? MAX_Y : MIN_Y].data(),
+                    coords[p.z >= 0.0f ? MAX_Z : MIN_Z].data()};
+    }
+    return tests;
+}
+}  // namespace
+
+Frustum Frustum::FromMatrix(const Mat4f& m) {
+    // rows of the column-major matrix
+    Vec4f r0(m[0], m[4], m[8], m[12]);
+    Vec4f r1(m[1], m[5], m[9], m[13]);
+    Vec4f r2(m[2], m[6], m[10], m[14]);
+    Vec4f r3(m[3], m[7], m[11], m[15]);
+    Frustum f;
+    f.planes = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2};
+    return f;
+}
+
+void CullingBoxes::Add(const BoundingBox& box) {
+    Vec3f min = box.MinPosition();
+    Vec3f max = box.MaxPosition();
+    coords[MIN_X].push_back(min.x);
+    coords[MIN_Y].push_back(min.y);
+    coords[MIN_Z].push_back(min.z);
+    coords[MAX_X].push_back(max.x);
+    coords[MAX_Y].push_back(max.y);
+    coords[MAX_Z].push_back(max.z);
+    size++;
+}
+
+void CullingBoxes::Clear() {
+    for (auto& c : coords)
+        c.clear();
+    size = 0;
+}
+
+void CullingBoxes::Reserve(size_t num_boxes) {
+    for (auto& c : coords)
+        c.reserve(num_boxes);
+}
+
+size_t CullingBoxes::Cull(const Frustum& frustum, uint8_t* visible) const {
+    const std::array<PlaneTest, 6> tests = MakeTests(frustum, coords);
+    size_t culled = 0;
+    size_t i = 0;
+#if defined(VERNA_SIMD_SSE)
+    for (; i + LANES <= size; i += LANES) {
+        __m128 outside = _mm_setzero_ps();
+        for (const PlaneTest& t : tests) {
+            __m128 dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.a), _mm_loadu_ps(t.x + i)),
+                           _mm_mul_ps(_mm_set1_ps(t.b), _mm_loadu_ps(t.y + i))),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.c), _mm_loadu_ps(t.z + i)),
+                           _mm_set1_ps(t.d)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(outside);
+        for (size_t lane = 0; lane < LANES; lane++) {
+            bool out = (mask >> lane) & 1;
+            visible[i + lane] = !out;
+            culled += out;
+        }
+    }
+#elif defined(VERNA_SIMD_NEON)
+    for (; i + LANES <= size; i += LANES) {
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (const PlaneTest& t : tests) {
+            float32x4_t dist = vdupq_n_f32(t.d);
+            dist = vmlaq_n_f32(dist, vld1q_f32(t.x + i), t.a);
+            dist = vmlaq_n_f32(dist, vld1q_f32(t.y + i), t.b);
+            dist = vmlaq_n_f32(dist, vld1q_f32(t.z + i), t.c);
+            outside = vorrq_u32(outside, vcltq_f32(dist, vdupq_n_f32(0.0f)));
+        }
+        uint32_t lanes[LANES];
+        vst1q_u32(lanes, outside);
+        for (size_t lane = 0; lane < LANES; lane++) {
+            bool out = lanes[lane] != 0;
+            visible[i + lane] = !out;
+            culled += out;
+        }
+    }
+#endif
+    // the last Size() % LANES boxes, or all of them without SIMD
+    for (; i < size; i++) {
+        bool out = false;
+        for (const PlaneTest& t : tests)
+            out |= t.a * t.x[i] + t.b * t.y[i] + t.c * t.z[i] + t.d < 0.0f;
+        visible[i] = !out;
+        culled += out;
+    }
+    return culled;
+}
+
+}  // namespace verna
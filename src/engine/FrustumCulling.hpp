@@ -0,0 +1,54 @@
+#ifndef VERNA_FRUSTUM_CULLING_HPP
+#define VERNA_FRUSTUM_CULLING_HPP
+
+#include <viverna/core/BoundingBox.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include <viverna/maths/Vec4f.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace verna {
+
+// Planes of a view volume, with normals pointing inside:
+// a point p is inside a plane if Dot(plane, (p, 1)) >= 0
+struct Frustum {
+    std::array<Vec4f, 6> planes;
+
+    // Extracts the planes of the clip volume of pv_matrix
+    // (-w <= x, y, z <= w, as OpenGL clips)
+    static Frustum FromMatrix(const Mat4f& pv_matrix);
+};
+
+// Axis aligned boxes stored as structure of arrays, so that the culling
+// kernel can test several boxes with each SIMD instruction
+class CullingBoxes {
+   public:
+    // boxes per SSE2/NEON vector
+    static constexpr size_t LANES = 4;
+
+    void Add(const BoundingBox& box);
+    void Clear();
+    void Reserve(size_t num_boxes);
+    size_t Size() const { return size; }
+
+    /**
+     * @brief Tests every box against the frustum
+     *
+     * @param frustum The view volume
+     * @param visible Output of Size() elements: 1 if the box intersects the
+     * frustum (or might, for boxes near its corners), 0 if it's outside
+     * @return Number of boxes outside the frustum
+     */
+    size_t Cull(const Frustum& frustum, uint8_t* visible) const;
+
+   private:
+    // min x, y, z then max x, y, z
+    std::array<std::vector<float>, 6> coords;
+    size_t size = 0;
+};
+
+}  // namespace verna
+
+#endif
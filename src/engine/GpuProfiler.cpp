@@ -0,0 +1,120 @@
+#include "GpuProfiler.hpp"
+
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
+#include <glad/gl.h>
+#elif defined(VERNA_ANDROID)
+#include <GLES3/gl32.h>
+#else
+#error Platform not supported!
+#endif
+
+#include <algorithm>
+#include <array>
+
+namespace verna::gpu_profiler {
+
+#if defined(VERNA_PROFILER) && defined(VERNA_DESKTOP)
+
+namespace {
+// same as the StorageRing regions: results are read when the GPU should be
+// done with the frame
+constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+constexpr uint32_t MAX_ZONES = 16;
+
+struct QueryPool {
+    std::array<GLuint, MAX_ZONES> queries{};
+    std::array<const char*, MAX_ZONES> names{};
+    // CPU time at which the zone was submitted
+    std::array<int64_t, MAX_ZONES> submitted{};
+    uint32_t count = 0;
+};
+
+std::array<QueryPool, FRAMES_IN_FLIGHT> pools;
+uint32_t current = 0;
+bool initialized = false;
+bool query_active = false;
+// end of the last zone on the GPU track
+int64_t gpu_time = 0;
+
+void Collect(QueryPool& pool) {
+    for (uint32_t i = 0; i < pool.count; i++) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(pool.queries[i], GL_QUERY_RESULT_AVAILABLE,
+                           &available);
+        // queries end in order: the following ones aren't ready either
+        if (available == GL_FALSE)
+            break;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(pool.queries[i], GL_QUERY_RESULT, &elapsed);
+        // the GPU can't start before submission nor before the previous
+        // zone ended
+        int64_t start = std::max(pool.submitted[i], gpu_time);
+        gpu_time = start + static_cast<int64_t>(elapsed);
+        profiler::detail::AddGpuZone(pool.names[i], start, gpu_time);
+    }
+    pool.count = 0;
+}
+}  // namespace
+
+void Initialize() {
+    for (QueryPool& pool : pools) {
+        glGenQueries(MAX_ZONES, pool.queries.data());
+        pool.count = 0;
+    }
+    current = 0;
+    query_active = false;
+    initialized = true;
+}
+
+void Terminate() {
+    if (!initialized)
+        return;
+    for (QueryPool& pool : pools)
+        glDeleteQueries(MAX_ZONES, pool.queries.data());
+    initialized = false;
+}
+
+void NextFrame() {
+    if (!initialized)
+        return;
+    current = (current + 1) % FRAMES_IN_FLIGHT;
+    Collect(pools[current]);
+}
+
+bool Begin(const char* name) {
+    if (!initialized || query_active || !profiler::IsEnabled())
+        return false;
+    QueryPool& pool = pools[current];
+    if (pool.count == MAX_ZONES)
+        return false;
+    pool.names[pool.count] = name;
+    pool.submitted[pool.count] = profiler::detail::Now();
+    glBeginQuery(GL_TIME_ELAPSED, pool.queries[pool.count]);
+    query_active = true;
+    return true;
+}
+
+void End() {
+    glEndQuery(GL_TIME_ELAPSED);
+    pools[current].count++;
+    query_active = false;
+}
+
+#else
+
+void Initialize() {}
+void Terminate() {}
+void NextFrame() {}
+
+#if defined(VERNA_PROFILER)
+bool Begin([[maybe_unused]] const char* name) {
+    return false;
+}
+void End() {}
+#endif
+
+#endif
+
+}  // namespace verna::gpu_profiler
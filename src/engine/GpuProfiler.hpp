@@ -0,0 +1,52 @@
+#ifndef VERNA_GPU_PROFILER_HPP
+#define VERNA_GPU_PROFILER_HPP
+
+#include <viverna/core/Profiler.hpp>
+
+#include <cstdint>
+
+#if defined(VERNA_PROFILER)
+// Times the GL commands of the scope with a GL_TIME_ELAPSED query. Queries
+// can't nest: a zone opened inside another one is ignored
+#define VERNA_PROFILE_GPU_SCOPE(name)               \
+    verna::gpu_profiler::Zone VERNA_PROFILE_CONCAT( \
+        verna_gpu_zone_, __LINE__)(name)
+#else
+#define VERNA_PROFILE_GPU_SCOPE(name)
+#endif
+
+namespace verna::profiler::detail {
+void AddGpuZone(const char* name, int64_t start, int64_t end);
+}  // namespace verna::profiler::detail
+
+// Query pools for the GPU track of the trace, desktop only (GLES has no
+// GL_TIME_ELAPSED queries)
+namespace verna::gpu_profiler {
+// Needs the renderer API
+void Initialize();
+void Terminate();
+// Reads back the oldest frame in flight, never waits for the GPU: results
+// that aren't ready yet are dropped
+void NextFrame();
+
+#if defined(VERNA_PROFILER)
+bool Begin(const char* name);
+void End();
+
+class Zone {
+   public:
+    explicit Zone(const char* name) : started(Begin(name)) {}
+    ~Zone() {
+        if (started)
+            End();
+    }
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+   private:
+    bool started;
+};
+#endif
+}  // namespace verna::gpu_profiler
+
+#endif
@@ -1,6 +1,7 @@
 #include <viverna/graphics/Image.hpp>
 #include <viverna/core/Assets.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
 
 #if defined(VERNA_ANDROID)
 #include <android/imagedecoder.h>
@@ -96,11 +97,12 @@ void Image::ClearPixels() {
 }
 
 Image Image::Load(const std::filesystem::path& image_path) {
+    VERNA_PROFILE_FUNCTION();
     auto raw = LoadRawAsset(image_path);
     auto ptr = reinterpret_cast<const uint8_t*>(raw.data());
     auto result = LoadFromBuffer(ptr, raw.size());
-    VERNA_LOGE_IF(!result.IsValid(),
-                  "LoadImageFromBuffer failed: " + image_path.string());
+    VERNA_LOGE_IF(!result.IsValid(), "LoadImageFromBuffer failed: ",
+                  image_path.string());
     return result;
 }
 
@@ -133,8 +135,7 @@ Image Image::LoadFromBuffer(const uint8_t* buffer, size_t size) {
     err_code = AImageDecoder_setAndroidBitmapFormat(
         decoder, ANDROID_BITMAP_FORMAT_RGBA_8888);
     if (err_code != ANDROID_IMAGE_DECODER_SUCCESS) {
-        VERNA_LOGE("AImageDecoder_setAndroidBitmapFormat failed: "
-                   + std::to_string(err_code));
+        VERNA_LOGE("AImageDecoder_setAndroidBitmapFormat failed: ", err_code);
         AImageDecoder_delete(decoder);
         return result;
     }
@@ -150,8 +151,7 @@ Image Image::LoadFromBuffer(const uint8_t* buffer, size_t size) {
         AImageDecoder_decodeImage(decoder, pixel_buffer, stride, buffer_size);
     AImageDecoder_delete(decoder);
     if (err_code != ANDROID_IMAGE_DECODER_SUCCESS) {
-        VERNA_LOGE("AImageDecoder_setAndroidBitmapFormat failed: "
-                   + std::to_string(err_code));
+        VERNA_LOGE("AImageDecoder_setAndroidBitmapFormat failed: ", err_code);
         std::free(pixel_buffer);
         result.width = 0;
         result.height = 0;
@@ -0,0 +1,274 @@
+#include "Log.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace verna {
+
+namespace {
+// bounded memory (about 256 KB): messages that don't fit are dropped
+constexpr size_t QUEUE_SIZE = 512;
+static_assert((QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0);
+
+struct Slot {
+    // queue position when free, position + 1 once written by a producer
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    uint16_t size;
+    std::array<std::byte, detail::LOG_MESSAGE_CAPACITY> data;
+};
+
+// Bounded MPSC queue: producers claim a position with a CAS on enqueue_pos
+// and publish the slot through its sequence, only the writer thread reads
+struct Queue {
+    Queue() {
+        for (size_t i = 0; i < QUEUE_SIZE; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    std::array<Slot, QUEUE_SIZE> slots;
+    alignas(64) std::atomic<size_t> enqueue_pos = 0;
+    // messages written, the next position to read
+    alignas(64) std::atomic<size_t> dequeue_pos = 0;
+};
+
+enum class WriterState : uint8_t { NotStarted, Running, Stopped };
+
+std::atomic<WriterState> writer_state = WriterState::NotStarted;
+std::atomic<uint64_t> dropped = 0;
+// serializes the platform output between the writer and WriteLogNow()
+std::mutex output_mtx;
+
+std::string Decode(const std::byte* data, size_t size) {
+    std::string message;
+    size_t i = 0;
+    auto read = [&](auto& value) {
+        std::memcpy(&value, data + i, sizeof(value));
+        i += sizeof(value);
+    };
+    while (i < size) {
+        detail::LogArg tag;
+        read(tag);
+        switch (tag) {
+            case detail::LogArg::String: {
+                uint32_t length;
+                read(length);
+                message.append(reinterpret_cast<const char*>(data + i),
+                               length);
+                i += length;
+                break;
+            }
+            case detail::LogArg::Char: {
+                char c;
+                read(c);
+                message += c;
+                break;
+            }
+            case detail::LogArg::Bool: {
+                uint8_t b;
+                read(b);
+                message += b ? "true" : "false";
+                break;
+            }
+            case detail::LogArg::Int: {
+                int64_t n;
+                read(n);
+                message += std::to_string(n);
+                break;
+            }
+            case detail::LogArg::Uint: {
+                uint64_t n;
+                read(n);
+                message += std::to_string(n);
+                break;
+            }
+            case detail::LogArg::Float: {
+                double d;
+                read(d);
+                message += std::to_string(d);
+                break;
+            }
+        }
+    }
+    return message;
+}
+
+class Writer {
+   public:
+    Writer() : queue(std::make_unique<Queue>()), stop(false) {
+        thread = std::thread([this] { Run(); });
+        writer_state.store(WriterState::Running, std::memory_order_release);
+    }
+    ~Writer() {
+        {
+            std::lock_guard lock(wake_mtx);
+            stop.store(true, std::memory_order_relaxed);
+        }
+        wake_cv.notify_one();
+        thread.join();
+        writer_state.store(WriterState::Stopped, std::memory_order_release);
+        // messages queued while the thread was stopping
+        Drain();
+    }
+
+    bool Enqueue(LogLevel level, const std::byte* data, size_t size) {
+        size_t pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &queue->slots[pos & (QUEUE_SIZE - 1)];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (queue->enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->size = static_cast<uint16_t>(size);
+        std::memcpy(slot->data.data(), data, size);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        Wake();
+        return true;
+    }
+
+    // Waits for the writer to reach the messages queued so far
+    void Flush() {
+        size_t target = queue->enqueue_pos.load(std::memory_order_acquire);
+        while (queue->dequeue_pos.load(std::memory_order_acquire) < target) {
+            if (writer_state.load(std::memory_order_acquire)
+                != WriterState::Running)
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+   private:
+    // Drains the queue, parked on wake_cv while it's empty
+    void Run() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (Drain())
+                continue;
+            std::unique_lock lock(wake_mtx);
+            idle.store(true, std::memory_order_relaxed);
+            // pairs with the fence of Wake(): either the producer sees idle,
+            // or the message is seen here
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            wake_cv.wait(lock, [this] {
+                return stop.load(std::memory_order_relaxed) || HasMessage();
+            });
+            idle.store(false, std::memory_order_relaxed);
+        }
+        Drain();
+    }
+
+    // Called by producers after publishing a slot, only locks while the
+    // writer is parked
+    void Wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!idle.load(std::memory_order_relaxed))
+            return;
+        {
+            std::lock_guard lock(wake_mtx);
+        }
+        wake_cv.notify_one();
+    }
+
+    bool HasMessage() const {
+        size_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+        const Slot& slot = queue->slots[pos & (QUEUE_SIZE - 1)];
+        return slot.sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // Writes every published message, returns false if there were none
+    bool Drain() {
+        size_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+        size_t start = pos;
+        std::lock_guard lock(output_mtx);
+        for (;;) {
+            Slot& slot = queue->slots[pos & (QUEUE_SIZE - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+                break;
+            detail::WriteLogMessage(slot.level,
+                                    Decode(slot.data.data(), slot.size));
+            slot.sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
+            pos++;
+            queue->dequeue_pos.store(pos, std::memory_order_release);
+        }
+        uint64_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost > reported_dropped) {
+            detail::WriteLogMessage(
+                LogLevel::Warning,
+                "Log queue full, " + std::to_string(lost - reported_dropped)
+                    + " messages dropped");
+            reported_dropped = lost;
+        }
+        if (pos == start)
+            return false;
+        detail::FlushLogOutput();
+        return true;
+    }
+
+    std::unique_ptr<Queue> queue;
+    std::thread thread;
+    std::atomic<bool> stop;
+    // set while the writer is parked, or about to be
+    std::atomic<bool> idle = false;
+    std::mutex wake_mtx;
+    std::condition_variable wake_cv;
+    uint64_t reported_dropped = 0;
+};
+
+// started by the first message, stopped (after writing everything) at exit
+Writer& GetWriter() {
+    static Writer writer;
+    return writer;
+}
+}  // namespace
+
+namespace detail {
+std::atomic<LogLevel> log_level = LogLevel::Info;
+
+void EnqueueLog(LogLevel level, const std::byte* data, size_t size) {
+    WriterState state = writer_state.load(std::memory_order_acquire);
+    if (state == WriterState::Stopped) {
+        WriteLogNow(level, data, size);
+        return;
+    }
+    if (!GetWriter().Enqueue(level, data, size))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WriteLogNow(LogLevel level, const std::byte* data, size_t size) {
+    std::string message = Decode(data, size);
+    FlushLog();
+    std::lock_guard lock(output_mtx);
+    WriteLogMessage(level, message);
+    FlushLogOutput();
+}
+}  // namespace detail
+
+void SetLogLevel(LogLevel level) {
+    detail::log_level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel GetLogLevel() {
+    return detail::log_level.load(std::memory_order_relaxed);
+}
+
+uint64_t GetDroppedLogCount() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void FlushLog() {
+    if (writer_state.load(std::memory_order_acquire) == WriterState::Running)
+        GetWriter().Flush();
+}
+
+}  // namespace verna
@@ -0,0 +1,16 @@
+#ifndef VERNA_LOG_HPP
+#define VERNA_LOG_HPP
+
+#include <viverna/core/Debug.hpp>
+
+#include <string_view>
+
+// Output of the log writer, implemented by each platform. Calls are
+// serialized by the caller
+namespace verna::detail {
+void WriteLogMessage(LogLevel level, std::string_view message);
+// Called after a batch of messages
+void FlushLogOutput();
+}  // namespace verna::detail
+
+#endif
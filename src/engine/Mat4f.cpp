@@ -3,6 +3,7 @@
 #include <viverna/maths/Vec3f.hpp>
 
 #include <cmath>
+#include <string>
 #include <utility>
 
 namespace verna {
@@ -40,4 +41,55 @@ Mat4f Mat4f::Perspective(float fovy, float aspect, float near, float far) {
     result[14] = 2.0f * near * far * inverse_depth;
     return result;
 }
+
+void Mat4f::MultiplyMany(const Mat4f& left,
+                         const Mat4f* right,
+                         Mat4f* result,
+                         size_t count) {
+#if defined(VERNA_SIMD)
+    // left stays in registers, even when result overlaps it
+    simd::Float4 l0 = detail::LoadColumn(left, 0);
+    simd::Float4 l1 = detail::LoadColumn(left, 1);
+    simd::Float4 l2 = detail::LoadColumn(left, 2);
+    simd::Float4 l3 = detail::LoadColumn(left, 3);
+    for (size_t i = 0; i < count; i++) {
+        simd::Float4 c0 =
+            detail::MultiplyColumn(l0, l1, l2, l3, &right[i].raw[0]);
+        simd::Float4 c1 =
+            detail::MultiplyColumn(l0, l1, l2, l3, &right[i].raw[4]);
+        simd::Float4 c2 =
+            detail::MultiplyColumn(l0, l1, l2, l3, &right[i].raw[8]);
+        simd::Float4 c3 =
+            detail::MultiplyColumn(l0, l1, l2, l3, &right[i].raw[12]);
+        detail::StoreColumn(result[i], 0, c0);
+        detail::StoreColumn(result[i], 1, c1);
+        detail::StoreColumn(result[i], 2, c2);
+        detail::StoreColumn(result[i], 3, c3);
+    }
+#else
+    const Mat4f l = left;
+    for (size_t i = 0; i < count; i++)
+        result[i] = l * right[i];
+#endif
+}
+
+void Mat4f::InvertMany(const Mat4f* matrices, Mat4f* result, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        result[i] = matrices[i].Inverted();
+}
+
+namespace detail {
+void LogNotInvertible([[maybe_unused]] const Mat4f& matrix) {
+#if !defined(NDEBUG) || defined(VERNA_RELEASE_LOGS)
+    std::string rows;
+    for (size_t i = 0; i < 4; i++) {
+        rows += std::to_string(matrix[i]) + '\t'
+                + std::to_string(matrix[i + 4]) + '\t'
+                + std::to_string(matrix[i + 8]) + '\t'
+                + std::to_string(matrix[i + 12]) + '\n';
+    }
+    VERNA_LOGE("Math error: can't invert matrix!\n", rows);
+#endif
+}
+}  // namespace detail
 }  // namespace verna
\ No newline at end of file
@@ -1,15 +1,23 @@
 #include <viverna/graphics/Mesh.hpp>
 #include <viverna/core/Assets.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
 #include <viverna/data/SparseSet.hpp>
 #include <viverna/maths/Quaternion.hpp>
 
+#include <array>
 #include <sstream>
 #include <utility>
 
 namespace verna {
 
 static Mesh::id_type last_id = 0;
+// Meshes with fewer triangles aren't worth simplifying
+static constexpr size_t MIN_LOD_TRIANGLES = 128;
+// Max simplification error of each level of detail, relative to the
+// diagonal of the bounds
+static constexpr std::array<float, Mesh::MAX_LODS> LOD_MAX_ERRORS = {
+    0.0f, 0.01f, 0.03f, 0.08f};
 static SparseSet<Mesh::id_type> mesh_mapper;
 static std::vector<std::string> mesh_names;
 
@@ -40,6 +48,26 @@ void Mesh::RecalculateBounds() {
     bounds.Recalculate(*this);
 }
 
+void Mesh::GenerateLods() {
+    VERNA_PROFILE_FUNCTION();
+    lods.clear();
+    if (indices.size() / 3 < MIN_LOD_TRIANGLES)
+        return;
+    // levels are simplified from the previous one: no reallocations allowed
+    lods.reserve(MAX_LODS - 1);
+    const float diagonal = bounds.Size().Magnitude();
+    for (uint32_t lod = 1; lod < MAX_LODS; lod++) {
+        const std::vector<index_t>& source = LodIndices(lod - 1);
+        size_t target = source.size() / 6 * 3;
+        std::vector<index_t> simplified = SimplifyIndices(
+            vertices, source, target, LOD_MAX_ERRORS[lod] * diagonal);
+        // not worth another level
+        if (simplified.size() < 3 || 4 * simplified.size() > 3 * source.size())
+            break;
+        lods.push_back(std::move(simplified));
+    }
+}
+
 std::string GetMeshName(Mesh::id_type mesh_id) {
     SparseSet<Mesh::id_type>::index_t index;
     return mesh_mapper.GetIndex(mesh_id, index) ? mesh_names[index]
@@ -60,12 +88,14 @@ static Mesh MakeMesh(const std::vector<Vec3f>& positions,
                      const std::vector<Vec3f>& normals,
                      const std::vector<ObjTri>& tris);
 
-std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path) {
+std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path,
+                                bool generate_lods) {
+    VERNA_PROFILE_FUNCTION();
     std::filesystem::path path = "meshes" / mesh_path;
 
     auto raw = LoadRawAsset(path);
     if (raw.empty()) {
-        VERNA_LOGE("Failed to load mesh at " + path.string());
+        VERNA_LOGE("Failed to load mesh at ", path.string());
         return {};
     }
     std::vector<Mesh> result;
@@ -125,8 +155,8 @@ std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path) {
                     tris.push_back({verts[0], verts[1], verts[2]});
                     break;
                 default:
-                    VERNA_LOGE("Unsupported number of faces in " + path.string()
-                               + ":\n" + line);
+                    VERNA_LOGE("Unsupported number of faces in ", path.string(),
+                               ":\n", line);
                     return {};
             }
         } else if (token == "o" || token == "g") {
@@ -150,11 +180,11 @@ std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path) {
             // smooth shading
             linestream >> token;
             if (token != "0" && token != "off")
-                VERNA_LOGW("Smoothing groups not supported! (" + path.string()
-                           + ")");
+                VERNA_LOGW("Smoothing groups not supported! (", path.string(),
+                           ")");
         } else {
-            VERNA_LOGE("Unrecognized token while parsing " + path.string()
-                       + ": " + token);
+            VERNA_LOGE("Unrecognized token while parsing ", path.string(), ": ",
+                       token);
             // return {};
         }
     }
@@ -167,8 +197,11 @@ std::vector<Mesh> LoadMeshesOBJ(const std::filesystem::path& mesh_path) {
         mesh_names.push_back(std::move(name));
         result.push_back(std::move(mesh));
     }
-    for (Mesh& m : result)
+    for (Mesh& m : result) {
         m.RecalculateBounds();
+        if (generate_lods)
+            m.GenerateLods();
+    }
 
     return result;
 }
@@ -0,0 +1,306 @@
+#include "MeshPool.hpp"
+#include <viverna/core/Debug.hpp>
+#include <viverna/graphics/Vertex.hpp>
+
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#elif defined(VERNA_ANDROID)
+#include <GLES3/gl32.h>
+#include <EGL/egl.h>
+#else
+#error Platform not supported!
+#endif
+
+#include <algorithm>
+#include <cstddef>
+
+namespace verna {
+
+namespace {
+constexpr uint32_t INITIAL_VERTICES = 1u << 16;
+constexpr uint32_t INITIAL_INDICES = 1u << 18;
+constexpr uint32_t MAX_VERTICES = 1u << 22;
+constexpr uint32_t MAX_INDICES = 1u << 24;
+constexpr GLsizeiptr INDEX_SIZE = sizeof(Mesh::index_t);
+
+void ResizeBuffer(GLuint& buffer, GLsizeiptr old_size, GLsizeiptr new_size) {
+    GLuint new_buffer;
+    glGenBuffers(1, &new_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, new_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                        old_size);
+    glDeleteBuffers(1, &buffer);
+    buffer = new_buffer;
+}
+}  // namespace
+
+void RangeAllocator::Reset(uint32_t capacity_) {
+    capacity = capacity_;
+    free_ranges.clear();
+    if (capacity > 0)
+        free_ranges.push_back({0, capacity});
+}
+
+void RangeAllocator::Grow(uint32_t new_capacity) {
+    if (new_capacity <= capacity)
+        return;
+    Free(capacity, new_capacity - capacity);
+    capacity = new_capacity;
+}
+
+bool RangeAllocator::Allocate(uint32_t size, uint32_t& out_offset) {
+    for (size_t i = 0; i < free_ranges.size(); i++) {
+        Range& range = free_ranges[i];
+        if (range.size < size)
+            continue;
+        out_offset = range.offset;
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0)
+            free_ranges.erase(free_ranges.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+void RangeAllocator::Free(uint32_t offset, uint32_t size) {
+    if (size == 0)
+        return;
+    auto next = std::lower_bound(
+        free_ranges.begin(), free_ranges.end(), offset,
+        [](const Range& r, uint32_t off) { return r.offset < off; });
+    bool merge_prev = next != free_ranges.begin()
+                      && std::prev(next)->offset + std::prev(next)->size
+                             == offset;
+    bool merge_next =
+        next != free_ranges.end() && offset + size == next->offset;
+    if (merge_prev && merge_next) {
+        std::prev(next)->size += size + next->size;
+        free_ranges.erase(next);
+    } else if (merge_prev) {
+        std::prev(next)->size += size;
+    } else if (merge_next) {
+        next->offset = offset;
+        next->size += size;
+    } else {
+        free_ranges.insert(next, {offset, size});
+    }
+}
+
+void MeshPool::Initialize() {
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, INITIAL_VERTICES * sizeof(Vertex), nullptr,
+                 GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, INITIAL_INDICES * INDEX_SIZE,
+                 nullptr, GL_DYNAMIC_DRAW);
+    SetupVertexArray();
+    vertex_ranges.Reset(INITIAL_VERTICES);
+    index_ranges.Reset(INITIAL_INDICES);
+    frame = 0;
+}
+
+void MeshPool::Terminate() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+    vao = vbo = ebo = 0;
+    vertex_ranges.Reset(0);
+    index_ranges.Reset(0);
+    resident_ids.Clear();
+    resident_ids.ShrinkToFit();
+    entries.clear();
+    transient.clear();
+}
+
+void MeshPool::SetupVertexArray() {
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+        reinterpret_cast<void*>(offsetof(Vertex, texture_coords)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                          reinterpret_cast<void*>(offsetof(Vertex, normal)));
+    glEnableVertexAttribArray(2);
+}
+
+bool MeshPool::Fetch(const Mesh& mesh,
+                     uint32_t lod,
+                     MeshLocation& out_location) {
+    SparseSet<Mesh::id_type>::index_t index;
+    if (mesh.id != 0 && resident_ids.GetIndex(mesh.id, index)) {
+        Entry& entry = entries[index];
+        entry.last_used_frame = frame;
+        out_location = Location(mesh, entry.allocation, lod);
+        return true;
+    }
+    auto vertex_count = static_cast<uint32_t>(mesh.vertices.size());
+    size_t total_indices = mesh.indices.size();
+    for (const auto& lod_indices : mesh.lods)
+        total_indices += lod_indices.size();
+    auto index_count = static_cast<uint32_t>(total_indices);
+    Allocation allocation;
+    if (!Allocate(vertex_count, index_count, allocation)) {
+        VERNA_LOGE("MeshPool out of memory! Can't upload mesh ", mesh.id);
+        return false;
+    }
+    Upload(mesh, allocation);
+    if (mesh.id == 0) {
+        transient.push_back(allocation);
+    } else {
+        resident_ids.Add(mesh.id);
+        entries.push_back({allocation, frame});
+    }
+    out_location = Location(mesh, allocation, lod);
+    return true;
+}
+
+MeshLocation MeshPool::Location(const Mesh& mesh,
+                                const Allocation& allocation,
+                                uint32_t lod) {
+    lod = std::min(lod, mesh.LodCount() - 1);
+    uint32_t first_index = allocation.index_offset;
+    for (uint32_t i = 0; i < lod; i++)
+        first_index += static_cast<uint32_t>(mesh.LodIndices(i).size());
+    return {static_cast<int32_t>(allocation.vertex_offset), first_index,
+            static_cast<uint32_t>(mesh.LodIndices(lod).size()), lod};
+}
+
+void MeshPool::Evict(Mesh::id_type mesh_id) {
+    SparseSet<Mesh::id_type>::index_t index;
+    if (!resident_ids.GetIndex(mesh_id, index))
+        return;
+    Free(entries[index].allocation);
+    resident_ids.Remove(mesh_id);
+    entries[index] = entries.back();
+    entries.pop_back();
+}
+
+void MeshPool::NextFrame() {
+    for (const Allocation& a : transient)
+        Free(a);
+    transient.clear();
+    frame++;
+}
+
+MeshPool::Stats MeshPool::TakeStats() {
+    Stats taken = stats;
+    stats = Stats();
+    return taken;
+}
+
+bool MeshPool::Allocate(uint32_t vertex_count,
+                        uint32_t index_count,
+                        Allocation& out_allocation) {
+    if (TryAllocate(vertex_count, index_count, out_allocation))
+        return true;
+    if (Grow(vertex_count, index_count)
+        && TryAllocate(vertex_count, index_count, out_allocation))
+        return true;
+    while (EvictLeastRecentlyUsed())
+        if (TryAllocate(vertex_count, index_count, out_allocation))
+            return true;
+    return false;
+}
+
+bool MeshPool::TryAllocate(uint32_t vertex_count,
+                           uint32_t index_count,
+                           Allocation& out_allocation) {
+    uint32_t vertex_offset, index_offset;
+    if (!vertex_ranges.Allocate(vertex_count, vertex_offset))
+        return false;
+    if (!index_ranges.Allocate(index_count, index_offset)) {
+        vertex_ranges.Free(vertex_offset, vertex_count);
+        return false;
+    }
+    out_allocation.vertex_offset = vertex_offset;
+    out_allocation.vertex_count = vertex_count;
+    out_allocation.index_offset = index_offset;
+    out_allocation.index_count = index_count;
+    return true;
+}
+
+void MeshPool::Free(const Allocation& allocation) {
+    vertex_ranges.Free(allocation.vertex_offset, allocation.vertex_count);
+    index_ranges.Free(allocation.index_offset, allocation.index_count);
+}
+
+bool MeshPool::Grow(uint32_t vertex_count, uint32_t index_count) {
+    uint32_t old_vertices = vertex_ranges.Capacity();
+    uint32_t old_indices = index_ranges.Capacity();
+    uint64_t wanted_vertices =
+        std::max<uint64_t>(2ull * old_vertices, old_vertices + vertex_count);
+    uint64_t wanted_indices =
+        std::max<uint64_t>(2ull * old_indices, old_indices + index_count);
+    auto new_vertices =
+        static_cast<uint32_t>(std::min<uint64_t>(wanted_vertices, MAX_VERTICES));
+    auto new_indices =
+        static_cast<uint32_t>(std::min<uint64_t>(wanted_indices, MAX_INDICES));
+    if (new_vertices == old_vertices && new_indices == old_indices)
+        return false;
+    if (new_vertices > old_vertices) {
+        ResizeBuffer(vbo, old_vertices * sizeof(Vertex),
+                     new_vertices * sizeof(Vertex));
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // attribute pointers capture the buffer bound when they are set
+        SetupVertexArray();
+        vertex_ranges.Grow(new_vertices);
+    }
+    if (new_indices > old_indices) {
+        ResizeBuffer(ebo, old_indices * INDEX_SIZE, new_indices * INDEX_SIZE);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        index_ranges.Grow(new_indices);
+    }
+    stats.growths++;
+    VERNA_LOGI("MeshPool grown to ", new_vertices, " vertices, ", new_indices,
+               " indices");
+    return true;
+}
+
+bool MeshPool::EvictLeastRecentlyUsed() {
+    size_t lru = entries.size();
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].last_used_frame == frame)
+            continue;
+        if (lru == entries.size()
+            || entries[i].last_used_frame < entries[lru].last_used_frame)
+            lru = i;
+    }
+    if (lru == entries.size())
+        return false;
+    Evict(resident_ids.GetDense()[lru]);
+    return true;
+}
+
+void MeshPool::Upload(const Mesh& mesh, const Allocation& allocation) {
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(allocation.vertex_offset)
+                        * static_cast<GLintptr>(sizeof(Vertex)),
+                    static_cast<GLsizeiptr>(mesh.vertices.size()
+                                            * sizeof(Vertex)),
+                    mesh.vertices.data());
+    stats.vertices_uploaded += static_cast<uint32_t>(mesh.vertices.size());
+    stats.indices_uploaded += allocation.index_count;
+    auto first_index = static_cast<GLintptr>(allocation.index_offset);
+    for (uint32_t lod = 0; lod < mesh.LodCount(); lod++) {
+        const std::vector<Mesh::index_t>& indices = mesh.LodIndices(lod);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first_index * INDEX_SIZE,
+                        static_cast<GLsizeiptr>(indices.size()) * INDEX_SIZE,
+                        indices.data());
+        first_index += static_cast<GLintptr>(indices.size());
+    }
+}
+
+}  // namespace verna
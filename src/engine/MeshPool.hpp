@@ -0,0 +1,107 @@
+#ifndef VERNA_MESH_POOL_HPP
+#define VERNA_MESH_POOL_HPP
+
+#include <viverna/data/SparseSet.hpp>
+#include <viverna/graphics/Mesh.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace verna {
+
+// First-fit allocator of [offset, offset + size) ranges. Adjacent free
+// ranges get merged
+class RangeAllocator {
+   public:
+    void Reset(uint32_t capacity_);
+    // Adds [Capacity(), new_capacity) to the free ranges
+    void Grow(uint32_t new_capacity);
+    bool Allocate(uint32_t size, uint32_t& out_offset);
+    void Free(uint32_t offset, uint32_t size);
+    uint32_t Capacity() const { return capacity; }
+
+   private:
+    struct Range {
+        uint32_t offset;
+        uint32_t size;
+    };
+    // Sorted by offset
+    std::vector<Range> free_ranges;
+    uint32_t capacity = 0;
+};
+
+// Where a level of detail of a mesh lives in the shared vertex/index buffers
+struct MeshLocation {
+    int32_t base_vertex;
+    uint32_t first_index;
+    uint32_t index_count;
+    uint32_t lod;
+};
+
+// Meshes uploaded once (keyed by Mesh::id) into a shared VBO/EBO arena,
+// every level of detail included (indices one after the other).
+// Meshes with id 0 are transient: uploaded on every use, freed by
+// NextFrame(). When the arena is full and can't grow, the least recently
+// used meshes (not used in the current frame) get evicted
+class MeshPool {
+   public:
+    struct Stats {
+        uint32_t vertices_uploaded = 0;
+        uint32_t indices_uploaded = 0;
+        uint32_t growths = 0;
+    };
+
+    // Creates the VAO and the buffers, leaving the VAO bound
+    void Initialize();
+    void Terminate();
+    // Uploads the mesh if it's not resident. false if it doesn't fit
+    bool Fetch(const Mesh& mesh, uint32_t lod, MeshLocation& out_location);
+    // Frees the GPU copy of a mesh (e.g. after its vertices changed)
+    void Evict(Mesh::id_type mesh_id);
+    void NextFrame();
+    // Stats since the last call
+    Stats TakeStats();
+
+   private:
+    struct Allocation {
+        uint32_t vertex_offset;
+        uint32_t vertex_count;
+        uint32_t index_offset;
+        uint32_t index_count;
+    };
+    struct Entry {
+        Allocation allocation;
+        uint64_t last_used_frame;
+    };
+
+    bool Allocate(uint32_t vertex_count,
+                  uint32_t index_count,
+                  Allocation& out_allocation);
+    bool TryAllocate(uint32_t vertex_count,
+                     uint32_t index_count,
+                     Allocation& out_allocation);
+    void Free(const Allocation& allocation);
+    bool Grow(uint32_t vertex_count, uint32_t index_count);
+    bool EvictLeastRecentlyUsed();
+    void Upload(const Mesh& mesh, const Allocation& allocation);
+    static MeshLocation Location(const Mesh& mesh,
+                                 const Allocation& allocation,
+                                 uint32_t lod);
+    void SetupVertexArray();
+
+    uint32_t vao = 0;
+    uint32_t vbo = 0;
+    uint32_t ebo = 0;
+    RangeAllocator vertex_ranges;
+    RangeAllocator index_ranges;
+    SparseSet<Mesh::id_type> resident_ids;
+    // Parallel to resident_ids.GetDense()
+    std::vector<Entry> entries;
+    std::vector<Allocation> transient;
+    uint64_t frame = 0;
+    Stats stats;
+};
+
+}  // namespace verna
+
+#endif
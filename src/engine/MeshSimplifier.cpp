@@ -0,0 +1,473 @@
+#include <viverna/graphics/Mesh.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace verna {
+
+namespace {
+// Boundary edges are held in place by planes orthogonal to their triangle,
+// which weigh more than the surface planes
+constexpr double BOUNDARY_WEIGHT = 10.0;
+// Weight of the squared edge length added to the cost of a collapse: flat
+// regions, where every collapse costs nothing, collapse their shortest edges
+// first instead of piling onto one position. Edges longer than about 30
+// times the max error are kept
+constexpr double EDGE_LENGTH_WEIGHT = 1e-3;
+// Collapses leaving a position with more neighbours are rejected, so that
+// flat regions don't turn into fans of slivers
+constexpr size_t MAX_VALENCE = 12;
+// Collapses turning a triangle by more than about 75 degrees are rejected,
+// as folds: slivers standing across the surface can't be told from flips
+constexpr float MIN_NORMAL_COS = 0.25f;
+// Nor can those turning a triangle into a sliver, with a quality (1 for
+// equilateral triangles, 0 for degenerate ones) lower than this, so that
+// folds don't build up over several collapses
+constexpr float MIN_QUALITY = 0.1f;
+
+// Sum of squared distances from a set of weighted planes, stored as the
+// symmetric matrix of the quadratic form
+struct Quadric {
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+    double weight = 0.0;
+
+    // Plane a*x + b*y + c*z + d = 0, with (a, b, c) normalized
+    static Quadric FromPlane(const Vec3f& normal, float d, double weight) {
+        double a = normal.x, b = normal.y, c = normal.z;
+        Quadric q;
+        q.a2 = weight * a * a;
+        q.ab = weight * a * b;
+        q.ac = weight * a * c;
+        q.ad = weight * a * d;
+        q.b2 = weight * b * b;
+        q.bc = weight * b * c;
+        q.bd = weight * b * d;
+        q.c2 = weight * c * c;
+        q.cd = weight * c * d;
+        q.d2 = weight * d * d;
+        q.weight = weight;
+        return q;
+    }
+    Quadric& operator+=(const Quadric& q) {
+        a2 += q.a2;
+        ab += q.ab;
+        ac += q.ac;
+        ad += q.ad;
+        b2 += q.b2;
+        bc += q.bc;
+        bd += q.bd;
+        c2 += q.c2;
+        cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+        return *this;
+    }
+    // Weighted mean of the squared distances of p from the planes
+    double Error(const Vec3f& p) const {
+        if (weight <= 0.0)
+            return 0.0;
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + b2 * y * y + c2 * z * z
+                   + 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+                   + 2.0 * (ad * x + bd * y + cd * z) + d2;
+        return std::abs(e) / weight;
+    }
+};
+
+// Moves every vertex of position `from` onto position `to`
+struct Collapse {
+    double cost;
+    uint32_t from;
+    uint32_t to;
+    // versions of the positions when the cost was computed
+    uint32_t from_version;
+    uint32_t to_version;
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+using PositionKey = std::array<uint32_t, 3>;
+
+// Edge collapse works on welded positions; triangles keep their corners as
+// indices of the original vertices, so that attributes are preserved
+class Simplifier {
+   public:
+    Simplifier(const std::vector<Vertex>& vertices_,
+               const std::vector<Mesh::index_t>& indices);
+    void Run(size_t target_triangles, double max_error);
+    std::vector<Mesh::index_t> Result() const;
+
+   private:
+    void Weld();
+    void BuildQuadrics();
+    // Collapses of the edges of position
+    void PushCollapses(uint32_t position);
+    void PushCollapse(uint32_t a, uint32_t b);
+    // The collapse would flip or fold a triangle, or turn it into a sliver
+    bool BreaksTriangles(uint32_t from, uint32_t to) const;
+    // The collapse would make the surface non manifold, or leave to with
+    // too many neighbours
+    bool BreaksTopology(uint32_t from, uint32_t to);
+    // Positions sharing a triangle with position, sorted
+    void GatherNeighbours(uint32_t position, std::vector<uint32_t>& out) const;
+    void Apply(uint32_t from, uint32_t to);
+    // Vertex of position with the attributes closest to those of vertex
+    Mesh::index_t BestVertex(uint32_t position, Mesh::index_t vertex) const;
+
+    const std::vector<Vertex>& vertices;
+    // welded vertices
+    std::vector<uint32_t> vertex_position;
+    std::vector<Vec3f> positions;
+    // vertices of position p are welded_vertices[position_start[p]] up to
+    // welded_vertices[position_start[p + 1]]
+    std::vector<Mesh::index_t> welded_vertices;
+    std::vector<uint32_t> position_start;
+    std::vector<Quadric> quadrics;
+    std::vector<uint32_t> versions;
+    std::vector<uint8_t> position_alive;
+    // triangles using each position, dead ones removed lazily
+    std::vector<std::vector<uint32_t>> adjacency;
+    // triangles
+    std::vector<std::array<uint32_t, 3>> triangle_positions;
+    std::vector<std::array<Mesh::index_t, 3>> triangle_vertices;
+    std::vector<uint8_t> triangle_alive;
+    size_t live_triangles = 0;
+    // scratch lists of PushCollapses and BreaksTopology
+    std::vector<uint32_t> from_neighbours;
+    std::vector<uint32_t> to_neighbours;
+    std::vector<uint32_t> opposite;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>>
+        collapses;
+};
+
+Simplifier::Simplifier(const std::vector<Vertex>& vertices_,
+                       const std::vector<Mesh::index_t>& indices) :
+    vertices(vertices_) {
+    Weld();
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<Mesh::index_t, 3> corners = {indices[i], indices[i + 1],
+                                                indices[i + 2]};
+        std::array<uint32_t, 3> p;
+        for (size_t k = 0; k < 3; k++)
+            p[k] = vertex_position[corners[k]];
+        // already degenerate: dropped
+        if (p[0] == p[1] || p[1] == p[2] || p[2] == p[0])
+            continue;
+        auto t = static_cast<uint32_t>(triangle_positions.size());
+        triangle_positions.push_back(p);
+        triangle_vertices.push_back(corners);
+        triangle_alive.push_back(1);
+        for (uint32_t position : p)
+            adjacency[position].push_back(t);
+    }
+    live_triangles = triangle_positions.size();
+    BuildQuadrics();
+}
+
+void Simplifier::Weld() {
+    // sorted by position bits, vertices sharing a position are contiguous
+    std::vector<PositionKey> keys(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vec3f& pos = vertices[i].position;
+        std::memcpy(&keys[i][0], &pos.x, sizeof(float));
+        std::memcpy(&keys[i][1], &pos.y, sizeof(float));
+        std::memcpy(&keys[i][2], &pos.z, sizeof(float));
+    }
+    welded_vertices.resize(vertices.size());
+    std::iota(welded_vertices.begin(), welded_vertices.end(), Mesh::index_t{0});
+    std::sort(welded_vertices.begin(), welded_vertices.end(),
+              [&keys](Mesh::index_t a, Mesh::index_t b) {
+                  return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+              });
+    vertex_position.resize(vertices.size());
+    for (size_t i = 0; i < welded_vertices.size(); i++) {
+        Mesh::index_t vertex = welded_vertices[i];
+        if (i == 0 || keys[vertex] != keys[welded_vertices[i - 1]]) {
+            position_start.push_back(static_cast<uint32_t>(i));
+            positions.push_back(vertices[vertex].position);
+        }
+        vertex_position[vertex] = static_cast<uint32_t>(positions.size() - 1);
+    }
+    position_start.push_back(static_cast<uint32_t>(welded_vertices.size()));
+    quadrics.resize(positions.size());
+    versions.assign(positions.size(), 0);
+    position_alive.assign(positions.size(), 1);
+    adjacency.resize(positions.size());
+}
+
+void Simplifier::BuildQuadrics() {
+    if (triangle_positions.empty())
+        return;
+    // area weighted planes, normalized so that the mean weight is 1
+    double total_area = 0.0;
+    for (const auto& p : triangle_positions) {
+        Vec3f n = (positions[p[1]] - positions[p[0]])
+                      .Cross(positions[p[2]] - positions[p[0]]);
+        total_area += 0.5 * n.Magnitude();
+    }
+    double mean_area =
+        total_area / static_cast<double>(triangle_positions.size());
+    if (mean_area <= 0.0)
+        return;
+
+    for (const auto& p : triangle_positions) {
+        const Vec3f& p0 = positions[p[0]];
+        Vec3f n = (positions[p[1]] - p0).Cross(positions[p[2]] - p0);
+        float length = n.Magnitude();
+        if (length <= 0.0f)
+            continue;
+        double weight = 0.5 * length / mean_area;
+        n = (1.0f / length) * n;
+        Quadric plane = Quadric::FromPlane(n, -n.Dot(p0), weight);
+        for (uint32_t position : p)
+            quadrics[position] += plane;
+        for (size_t k = 0; k < 3; k++) {
+            uint32_t a = p[k];
+            uint32_t b = p[(k + 1) % 3];
+            // border edges belong to one triangle
+            auto uses = std::count_if(
+                adjacency[a].begin(), adjacency[a].end(), [&](uint32_t t) {
+                    const auto& q = triangle_positions[t];
+                    return q[0] == b || q[1] == b || q[2] == b;
+                });
+            if (uses != 1)
+                continue;
+            Vec3f edge = positions[b] - positions[a];
+            Vec3f side = edge.Cross(n);
+            float side_length = side.Magnitude();
+            if (side_length <= 0.0f)
+                continue;
+            side = (1.0f / side_length) * side;
+            Quadric border = Quadric::FromPlane(
+                side, -side.Dot(positions[a]), BOUNDARY_WEIGHT * weight);
+            quadrics[a] += border;
+            quadrics[b] += border;
+        }
+    }
+}
+
+void Simplifier::Run(size_t target_triangles, double max_error) {
+    for (uint32_t i = 0; i < positions.size(); i++) {
+        GatherNeighbours(i, from_neighbours);
+        // each edge once
+        for (uint32_t other : from_neighbours)
+            if (other > i)
+                PushCollapse(i, other);
+    }
+    const double max_cost = max_error * max_error;
+    while (live_triangles > target_triangles && !collapses.empty()) {
+        Collapse c = collapses.top();
+        collapses.pop();
+        if (!position_alive[c.from] || !position_alive[c.to]
+            || versions[c.from] != c.from_version
+            || versions[c.to] != c.to_version)
+            continue;
+        // the cheapest collapse is too expensive: so are the others
+        if (c.cost > max_cost)
+            break;
+        if (BreaksTriangles(c.from, c.to) || BreaksTopology(c.from, c.to))
+            continue;
+        Apply(c.from, c.to);
+    }
+}
+
+std::vector<Mesh::index_t> Simplifier::Result() const {
+    std::vector<Mesh::index_t> result;
+    result.reserve(live_triangles * 3);
+    for (size_t t = 0; t < triangle_vertices.size(); t++)
+        if (triangle_alive[t])
+            result.insert(result.end(), triangle_vertices[t].begin(),
+                          triangle_vertices[t].end());
+    return result;
+}
+
+void Simplifier::PushCollapses(uint32_t position) {
+    GatherNeighbours(position, from_neighbours);
+    for (uint32_t other : from_neighbours)
+        PushCollapse(position, other);
+}
+
+void Simplifier::PushCollapse(uint32_t a, uint32_t b) {
+    Quadric q = quadrics[a];
+    q += quadrics[b];
+    double to_b = q.Error(positions[b]);
+    double to_a = q.Error(positions[a]);
+    double length = EDGE_LENGTH_WEIGHT
+                    * (positions[b] - positions[a]).SquaredMagnitude();
+    if (to_b <= to_a)
+        collapses.push({to_b + length, a, b, versions[a], versions[b]});
+    else
+        collapses.push({to_a + length, b, a, versions[b], versions[a]});
+}
+
+// 4 * sqrt(3) * area over the sum of the squared edges, from twice the area
+float Quality(const Vec3f& double_area, const std::array<Vec3f, 3>& corners) {
+    float edges = (corners[1] - corners[0]).SquaredMagnitude()
+                  + (corners[2] - corners[1]).SquaredMagnitude()
+                  + (corners[0] - corners[2]).SquaredMagnitude();
+    if (edges <= 0.0f)
+        return 0.0f;
+    return 2.0f * std::sqrt(3.0f) * double_area.Magnitude() / edges;
+}
+
+bool Simplifier::BreaksTriangles(uint32_t from, uint32_t to) const {
+    for (uint32_t t : adjacency[from]) {
+        const auto& p = triangle_positions[t];
+        if (!triangle_alive[t] || p[0] == to || p[1] == to || p[2] == to)
+            continue;
+        std::array<Vec3f, 3> corners;
+        for (size_t k = 0; k < 3; k++)
+            corners[k] = positions[p[k]];
+        Vec3f before =
+            (corners[1] - corners[0]).Cross(corners[2] - corners[0]);
+        float quality_before = Quality(before, corners);
+        for (size_t k = 0; k < 3; k++)
+            if (p[k] == from)
+                corners[k] = positions[to];
+        Vec3f after = (corners[1] - corners[0]).Cross(corners[2] - corners[0]);
+        if (before.SquaredMagnitude() <= 0.0f)
+            continue;
+        float dot = before.Dot(after);
+        if (dot <= 0.0f
+            || dot * dot <= MIN_NORMAL_COS * MIN_NORMAL_COS
+                                * before.SquaredMagnitude()
+                                * after.SquaredMagnitude())
+            return true;
+        float quality_after = Quality(after, corners);
+        if (quality_after < MIN_QUALITY && quality_after < quality_before)
+            return true;
+    }
+    return false;
+}
+
+bool Simplifier::BreaksTopology(uint32_t from, uint32_t to) {
+    GatherNeighbours(from, from_neighbours);
+    GatherNeighbours(to, to_neighbours);
+    // link condition: the only positions next to both ends of the edge are
+    // the third corners of the triangles on the edge, otherwise the collapse
+    // folds the surface onto itself and duplicates triangles
+    opposite.clear();
+    for (uint32_t t : adjacency[from]) {
+        const auto& p = triangle_positions[t];
+        if (!triangle_alive[t] || (p[0] != to && p[1] != to && p[2] != to))
+            continue;
+        for (uint32_t position : p)
+            if (position != from && position != to)
+                opposite.push_back(position);
+    }
+    std::sort(opposite.begin(), opposite.end());
+    opposite.erase(std::unique(opposite.begin(), opposite.end()),
+                   opposite.end());
+    size_t shared = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < from_neighbours.size() && j < to_neighbours.size()) {
+        if (from_neighbours[i] < to_neighbours[j]) {
+            i++;
+        } else if (to_neighbours[j] < from_neighbours[i]) {
+            j++;
+        } else {
+            uint32_t position = from_neighbours[i];
+            if (!std::binary_search(opposite.begin(), opposite.end(),
+                                    position))
+                return true;
+            shared++;
+            i++;
+            j++;
+        }
+    }
+    // from and to are neighbours of each other, and the shared ones count
+    // once
+    size_t valence =
+        from_neighbours.size() + to_neighbours.size() - shared - 2;
+    size_t to_valence = to_neighbours.size();
+    return valence > std::max(MAX_VALENCE, to_valence);
+}
+
+void Simplifier::GatherNeighbours(uint32_t position,
+                                  std::vector<uint32_t>& out) const {
+    out.clear();
+    for (uint32_t t : adjacency[position]) {
+        if (!triangle_alive[t])
+            continue;
+        for (uint32_t other : triangle_positions[t])
+            if (other != position)
+                out.push_back(other);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void Simplifier::Apply(uint32_t from, uint32_t to) {
+    std::vector<uint32_t>& target = adjacency[to];
+    for (uint32_t t : adjacency[from]) {
+        if (!triangle_alive[t])
+            continue;
+        auto& p = triangle_positions[t];
+        if (p[0] == to || p[1] == to || p[2] == to) {
+            // the collapsed edge belongs to this triangle
+            triangle_alive[t] = 0;
+            live_triangles--;
+            continue;
+        }
+        for (size_t k = 0; k < 3; k++) {
+            if (p[k] != from)
+                continue;
+            p[k] = to;
+            triangle_vertices[t][k] = BestVertex(to, triangle_vertices[t][k]);
+        }
+        target.push_back(t);
+    }
+    adjacency[from].clear();
+    adjacency[from].shrink_to_fit();
+    position_alive[from] = 0;
+    quadrics[to] += quadrics[from];
+    target.erase(std::remove_if(target.begin(), target.end(),
+                                [this](uint32_t t) {
+                                    return !triangle_alive[t];
+                                }),
+                 target.end());
+    versions[to]++;
+    PushCollapses(to);
+}
+
+Mesh::index_t Simplifier::BestVertex(uint32_t position,
+                                     Mesh::index_t vertex) const {
+    const Vertex& v = vertices[vertex];
+    Mesh::index_t best = welded_vertices[position_start[position]];
+    float best_score = -std::numeric_limits<float>::infinity();
+    for (uint32_t i = position_start[position];
+         i < position_start[position + 1]; i++) {
+        Mesh::index_t candidate = welded_vertices[i];
+        const Vertex& c = vertices[candidate];
+        Vec2f uv = c.texture_coords - v.texture_coords;
+        float score = c.normal.Dot(v.normal) - uv.Dot(uv);
+        if (score > best_score) {
+            best_score = score;
+            best = candidate;
+        }
+    }
+    return best;
+}
+}  // namespace
+
+std::vector<Mesh::index_t> SimplifyIndices(
+    const std::vector<Vertex>& vertices,
+    const std::vector<Mesh::index_t>& indices,
+    size_t target_index_count,
+    float max_error) {
+    Simplifier simplifier(vertices, indices);
+    simplifier.Run(target_index_count / 3, max_error);
+    return simplifier.Result();
+}
+
+}  // namespace verna
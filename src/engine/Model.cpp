@@ -44,26 +44,23 @@ MeshId Model::AddMesh(Mesh&& mesh) {
 const Material& Model::GetMaterial(MeshId mesh_id) const {
     auto index = AsIndex(mesh_id);
     VERNA_LOGE_IF(!Contains(mesh_id),
-                  "GetMaterial failed: can't access material "
-                      + std::to_string(mesh_id)
-                      + " (index: " + std::to_string(index) + ')');
+                  "GetMaterial failed: can't access material ", mesh_id,
+                  " (index: ", index, ')');
     return materials[index];
 }
 
 void Model::SetMaterial(MeshId mesh_id, const Material& material) {
     auto index = AsIndex(mesh_id);
     VERNA_LOGE_IF(!Contains(mesh_id),
-                  "SetMaterial failed: can't access material "
-                      + std::to_string(mesh_id)
-                      + " (index: " + std::to_string(index) + ')');
+                  "SetMaterial failed: can't access material ", mesh_id,
+                  " (index: ", index, ')');
     materials[index] = material;
 }
 
 const Mesh& Model::GetMesh(MeshId mesh_id) const {
     auto index = AsIndex(mesh_id);
-    VERNA_LOGE_IF(!Contains(mesh_id),
-                  "GetMesh failed: can't access mesh " + std::to_string(mesh_id)
-                      + " (index: " + std::to_string(index) + ')');
+    VERNA_LOGE_IF(!Contains(mesh_id), "GetMesh failed: can't access mesh ",
+                  mesh_id, " (index: ", index, ')');
     return meshes[index];
 }
 
@@ -0,0 +1,301 @@
+#include "OcclusionCulling.hpp"
+#include <viverna/core/ThreadPool.hpp>
+#include <viverna/maths/Simd.hpp>
+#include <viverna/maths/Vec4f.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace verna {
+
+namespace {
+// rows rasterized by each task
+constexpr int32_t BAND_HEIGHT = 16;
+// smallest w considered in front of the camera
+constexpr float MIN_W = 1e-5f;
+
+int32_t ClampIndex(float value, uint32_t size) {
+    float clamped =
+        std::clamp(std::floor(value), 0.0f, static_cast<float>(size - 1));
+    return static_cast<int32_t>(clamped);
+}
+}  // namespace
+
+void OcclusionBuffer::Resize(uint32_t width_, uint32_t height_) {
+    width = std::max(width_, 1u);
+    height = std::max(height_, 1u);
+    levels.clear();
+    size_t offset = 0;
+    uint32_t w = width;
+    uint32_t h = height;
+    while (true) {
+        levels.push_back({w, h, offset});
+        offset += static_cast<size_t>(w) * h;
+        if (w == 1 && h == 1)
+            break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    // nothing occluded until the first Finish()
+    depth.assign(offset, 1.0f);
+}
+
+void OcclusionBuffer::Begin(const Mat4f& pv_matrix) {
+    pv = pv_matrix;
+    triangles.clear();
+}
+
+void OcclusionBuffer::AddOccluder(const Mesh& mesh, const Mat4f& model_matrix) {
+    const Mat4f mvp = pv * model_matrix;
+    const float half_width = 0.5f * static_cast<float>(width);
+    const float half_height = 0.5f * static_cast<float>(height);
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        Triangle tri;
+        bool clipped = false;
+        for (size_t v = 0; v < 3 && !clipped; v++) {
+            const Vec3f& pos = mesh.vertices[mesh.indices[i + v]].position;
+            Vec4f clip = mvp * Vec4f(pos, 1.0f);
+            // parts in front of the near plane aren't drawn by the GPU:
+            // they can't hide anything
+            clipped = clip.w < MIN_W || clip.z > clip.w;
+            float inverse_w = 1.0f / clip.w;
+            tri.x[v] = (clip.x * inverse_w + 1.0f) * half_width;
+            tri.y[v] = (clip.y * inverse_w + 1.0f) * half_height;
+            tri.z[v] = 0.5f - 0.5f * clip.z * inverse_w;
+        }
+        if (clipped)
+            continue;
+        float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0])
+                     - (tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+        if (std::abs(area) < 1e-8f)
+            continue;
+        if (area < 0.0f) {
+            // both faces occlude
+            std::swap(tri.x[1], tri.x[2]);
+            std::swap(tri.y[1], tri.y[2]);
+            std::swap(tri.z[1], tri.z[2]);
+        }
+        float min_x = std::min({tri.x[0], tri.x[1], tri.x[2]});
+        float max_x = std::max({tri.x[0], tri.x[1], tri.x[2]});
+        float min_y = std::min({tri.y[0], tri.y[1], tri.y[2]});
+        float max_y = std::max({tri.y[0], tri.y[1], tri.y[2]});
+        if (max_x < 0.0f || max_y < 0.0f || min_x >= 2.0f * half_width
+            || min_y >= 2.0f * half_height)
+            continue;
+        tri.min_x = ClampIndex(min_x, width);
+        tri.max_x = ClampIndex(max_x, width);
+        tri.min_y = ClampIndex(min_y, height);
+        tri.max_y = ClampIndex(max_y, height);
+        triangles.push_back(tri);
+    }
+}
+
+void OcclusionBuffer::Finish() {
+    if (levels.empty())
+        return;
+    // bands own disjoint rows: no synchronization needed
+    const auto rows = static_cast<int32_t>(height);
+    const size_t num_bands = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+    ThreadPool::Get().ParallelFor(0, num_bands, 1, [&](size_t b, size_t e) {
+        for (size_t band = b; band < e; band++) {
+            int32_t y0 = static_cast<int32_t>(band) * BAND_HEIGHT;
+            int32_t y1 = std::min(y0 + BAND_HEIGHT, rows);
+            std::fill(depth.begin() + static_cast<size_t>(y0) * width,
+                      depth.begin() + static_cast<size_t>(y1) * width, 1.0f);
+            for (const Triangle& tri : triangles)
+                if (tri.min_y < y1 && tri.max_y >= y0)
+                    Rasterize(tri, y0, y1);
+        }
+    });
+    for (size_t level = 1; level < levels.size(); level++)
+        BuildLevel(level);
+}
+
+void OcclusionBuffer::Rasterize(const Triangle& tri,
+                                int32_t band_y0,
+                                int32_t band_y1) {
+    // edge i goes from vertex i to vertex i + 1, positive inside
+    float step_x[3], step_y[3], origin[3];
+    for (int v = 0; v < 3; v++) {
+        int next = (v + 1) % 3;
+        float dx = tri.x[next] - tri.x[v];
+        float dy = tri.y[next] - tri.y[v];
+        step_x[v] = -dy;
+        step_y[v] = dx;
+        origin[v] = dy * tri.x[v] - dx * tri.y[v];
+        // a texel is covered only if its four corners are inside: the edge
+        // is tested at the center, moved towards the most outside corner
+        origin[v] -= 0.5f * (std::abs(step_x[v]) + std::abs(step_y[v]));
+    }
+    // depth plane
+    float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0])
+                 - (tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+    float z10 = tri.z[1] - tri.z[0];
+    float z20 = tri.z[2] - tri.z[0];
+    float dz_dx =
+        (z10 * (tri.y[2] - tri.y[0]) - z20 * (tri.y[1] - tri.y[0])) / area;
+    float dz_dy =
+        (z20 * (tri.x[1] - tri.x[0]) - z10 * (tri.x[2] - tri.x[0])) / area;
+    // covered texels get the farthest depth of the triangle inside them
+    const float texel_depth = 0.5f * (std::abs(dz_dx) + std::abs(dz_dy));
+
+    int32_t y_begin = std::max(tri.min_y, band_y0);
+    int32_t y_end = std::min(tri.max_y + 1, band_y1);
+    int32_t x_end = tri.max_x + 1;
+    for (int32_t y = y_begin; y < y_end; y++) {
+        float* row = depth.data() + static_cast<size_t>(y) * width;
+        // values at the center of the first pixel
+        float px = static_cast<float>(tri.min_x) + 0.5f;
+        float py = static_cast<float>(y) + 0.5f;
+        float e[3];
+        for (int v = 0; v < 3; v++)
+            e[v] = origin[v] + step_x[v] * px + step_y[v] * py;
+        float z = tri.z[0] + dz_dx * (px - tri.x[0]) + dz_dy * (py - tri.y[0])
+                  + texel_depth;
+        int32_t x = tri.min_x;
+#if defined(VERNA_SIMD_SSE)
+        const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        const __m128 zero = _mm_setzero_ps();
+        for (; x + 4 <= x_end; x += 4) {
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int v = 0; v < 3; v++) {
+                __m128 step = _mm_mul_ps(lane, _mm_set1_ps(step_x[v]));
+                __m128 ev = _mm_add_ps(_mm_set1_ps(e[v]), step);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(ev, zero));
+            }
+            if (_mm_movemask_ps(inside) != 0) {
+                __m128 zv = _mm_add_ps(_mm_set1_ps(z),
+                                       _mm_mul_ps(lane, _mm_set1_ps(dz_dx)));
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, zv);
+                _mm_storeu_ps(row + x,
+                              _mm_or_ps(_mm_and_ps(inside, nearer),
+                                        _mm_andnot_ps(inside, old)));
+            }
+            for (int v = 0; v < 3; v++)
+                e[v] += 4.0f * step_x[v];
+            z += 4.0f * dz_dx;
+        }
+#elif defined(VERNA_SIMD_NEON)
+        const float lanes[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+        const float32x4_t lane = vld1q_f32(lanes);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        for (; x + 4 <= x_end; x += 4) {
+            uint32x4_t inside = vdupq_n_u32(~0u);
+            for (int v = 0; v < 3; v++) {
+                float32x4_t ev =
+                    vmlaq_n_f32(vdupq_n_f32(e[v]), lane, step_x[v]);
+                inside = vandq_u32(inside, vcgeq_f32(ev, zero));
+            }
+            uint32x2_t any =
+                vorr_u32(vget_low_u32(inside), vget_high_u32(inside));
+            if ((vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) != 0) {
+                float32x4_t zv = vmlaq_n_f32(vdupq_n_f32(z), lane, dz_dx);
+                float32x4_t old = vld1q_f32(row + x);
+                float32x4_t nearer = vminq_f32(old, zv);
+                vst1q_f32(row + x, vbslq_f32(inside, nearer, old));
+            }
+            for (int v = 0; v < 3; v++)
+                e[v] += 4.0f * step_x[v];
+            z += 4.0f * dz_dx;
+        }
+#endif
+        for (; x < x_end; x++) {
+            if (e[0] >= 0.0f && e[1] >= 0.0f && e[2] >= 0.0f)
+                row[x] = std::min(row[x], z);
+            for (int v = 0; v < 3; v++)
+                e[v] += step_x[v];
+            z += dz_dx;
+        }
+    }
+}
+
+void OcclusionBuffer::BuildLevel(size_t level) {
+    const Level& src = levels[level - 1];
+    const Level& dst = levels[level];
+    const float* in = depth.data() + src.offset;
+    float* out = depth.data() + dst.offset;
+    for (uint32_t y = 0; y < dst.height; y++) {
+        uint32_t y0 = 2 * y;
+        uint32_t y1 = std::min(y0 + 1, src.height - 1);
+        for (uint32_t x = 0; x < dst.width; x++) {
+            uint32_t x0 = 2 * x;
+            uint32_t x1 = std::min(x0 + 1, src.width - 1);
+            out[y * dst.width + x] = std::max(
+                std::max(in[y0 * src.width + x0], in[y0 * src.width + x1]),
+                std::max(in[y1 * src.width + x0], in[y1 * src.width + x1]));
+        }
+    }
+}
+
+float OcclusionBuffer::MaxDepth(size_t level,
+                                int32_t x0,
+                                int32_t y0,
+                                int32_t x1,
+                                int32_t y1) const {
+    const Level& l = levels[level];
+    const float* texels = depth.data() + l.offset;
+    float max = 0.0f;
+    for (int32_t y = y0; y <= y1; y++)
+        for (int32_t x = x0; x <= x1; x++)
+            max = std::max(max, texels[static_cast<size_t>(y) * l.width + x]);
+    return max;
+}
+
+bool OcclusionBuffer::IsVisible(const BoundingBox& box) const {
+    if (levels.empty())
+        return true;
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    float min_x = INF, min_y = INF;
+    float max_z = -INF;
+    float max_x = -INF, max_y = -INF;
+    const Vec3f box_min = box.MinPosition();
+    const Vec3f box_max = box.MaxPosition();
+    for (int i = 0; i < 8; i++) {
+        Vec4f corner((i & 1) ? box_max.x : box_min.x,
+                     (i & 2) ? box_max.y : box_min.y,
+                     (i & 4) ? box_max.z : box_min.z, 1.0f);
+        Vec4f clip = pv * corner;
+        // crosses the near plane: the box may be all around the camera
+        if (clip.w < MIN_W || clip.z > clip.w)
+            return true;
+        float inverse_w = 1.0f / clip.w;
+        min_x = std::min(min_x, clip.x * inverse_w);
+        max_x = std::max(max_x, clip.x * inverse_w);
+        min_y = std::min(min_y, clip.y * inverse_w);
+        max_y = std::max(max_y, clip.y * inverse_w);
+        max_z = std::max(max_z, clip.z * inverse_w);
+    }
+    const float half_width = 0.5f * static_cast<float>(width);
+    const float half_height = 0.5f * static_cast<float>(height);
+    min_x = (min_x + 1.0f) * half_width;
+    max_x = (max_x + 1.0f) * half_width;
+    min_y = (min_y + 1.0f) * half_height;
+    max_y = (max_y + 1.0f) * half_height;
+    // off screen boxes are left to frustum culling
+    if (max_x < 0.0f || max_y < 0.0f || min_x >= 2.0f * half_width
+        || min_y >= 2.0f * half_height)
+        return true;
+    int32_t x0 = ClampIndex(min_x, width);
+    int32_t x1 = ClampIndex(max_x, width);
+    int32_t y0 = ClampIndex(min_y, height);
+    int32_t y1 = ClampIndex(max_y, height);
+    // coarsest useful level: the box covers at most 2x2 texels
+    size_t level = 0;
+    while (level + 1 < levels.size() && (x1 - x0 > 1 || y1 - y0 > 1)) {
+        level++;
+        x0 >>= 1;
+        x1 >>= 1;
+        y0 >>= 1;
+        y1 >>= 1;
+    }
+    // every texel touched by the box counts, and occluders only fill the
+    // texels they cover entirely: a box peeking out of an occluder's
+    // silhouette stays visible
+    float nearest = 0.5f - 0.5f * max_z;
+    return nearest <= MaxDepth(level, x0, y0, x1, y1);
+}
+
+}  // namespace verna
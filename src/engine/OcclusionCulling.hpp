@@ -0,0 +1,83 @@
+#ifndef VERNA_OCCLUSION_CULLING_HPP
+#define VERNA_OCCLUSION_CULLING_HPP
+
+#include <viverna/core/BoundingBox.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/maths/Mat4f.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace verna {
+
+// Low resolution depth buffer filled on the CPU by rasterizing occluders,
+// plus a hierarchy of levels storing the farthest depth of the texels below
+// (hierarchical Z), used to test boxes without touching every pixel.
+// Occlusion is conservative: a texel is covered only when it's entirely
+// inside an occluder triangle, and keeps the farthest depth of the triangle
+// over the texel.
+// Depth goes from 0 at the near plane to 1 at the far plane (the camera
+// projection is reversed: clip space z / w is 1 at the near plane).
+// Doesn't need a GPU context
+class OcclusionBuffer {
+   public:
+    void Resize(uint32_t width, uint32_t height);
+    uint32_t Width() const { return width; }
+    uint32_t Height() const { return height; }
+
+    /**
+     * @brief Discards the occluders of the previous frame
+     *
+     * @param pv_matrix View-projection matrix used by the following calls
+     */
+    void Begin(const Mat4f& pv_matrix);
+    /**
+     * @brief Sets up the triangles of an occluder. Triangles crossing the
+     * near plane are skipped, so that occlusion stays conservative
+     *
+     * @param mesh The occluder
+     * @param model_matrix Transformation of the occluder
+     */
+    void AddOccluder(const Mesh& mesh, const Mat4f& model_matrix);
+    // Rasterizes the occluders (in parallel on ThreadPool) and builds the
+    // hierarchy. Must be called after the last AddOccluder()
+    void Finish();
+    // false if the box is completely hidden behind the occluders
+    bool IsVisible(const BoundingBox& box) const;
+
+   private:
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        // index of the first texel in depth
+        size_t offset;
+    };
+    // Screen space triangle, counter-clockwise
+    struct Triangle {
+        float x[3];
+        float y[3];
+        float z[3];
+        int32_t min_x, min_y, max_x, max_y;
+    };
+
+    void Rasterize(const Triangle& tri, int32_t band_y0, int32_t band_y1);
+    void BuildLevel(size_t level);
+    // Farthest depth inside [x0, x1] x [y0, y1] of a level
+    float MaxDepth(size_t level,
+                   int32_t x0,
+                   int32_t y0,
+                   int32_t x1,
+                   int32_t y1) const;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // Every level, finest first
+    std::vector<float> depth;
+    std::vector<Level> levels;
+    std::vector<Triangle> triangles;
+    Mat4f pv;
+};
+
+}  // namespace verna
+
+#endif
@@ -0,0 +1,178 @@
+#include <viverna/core/Profiler.hpp>
+#include <viverna/core/Debug.hpp>
+#include <viverna/core/Time.hpp>
+#include "GpuProfiler.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace verna::profiler {
+
+#if defined(VERNA_PROFILER)
+
+namespace {
+// bounds the memory of a trace left running: later zones are dropped
+constexpr size_t MAX_ZONES_PER_TRACK = 1 << 20;
+
+struct ZoneEvent {
+    const char* name;
+    int64_t start;
+    int64_t end;
+};
+
+// Zones of one thread (or of the GPU). Only the owner thread appends, the
+// lock is there for WriteTrace() and Clear(), so it's never contended
+struct Track {
+    std::mutex mtx;
+    std::vector<ZoneEvent> zones;
+    std::string name;
+    uint32_t id;
+    uint64_t dropped = 0;
+};
+
+const TimePoint epoch = Clock::now();
+std::mutex tracks_mtx;
+// tracks are never destroyed: threads keep a pointer to theirs
+std::vector<std::unique_ptr<Track>> tracks;
+thread_local Track* thread_track = nullptr;
+Track* gpu_track = nullptr;
+
+Track* NewTrack(std::string_view name) {
+    std::lock_guard lock(tracks_mtx);
+    auto& track = tracks.emplace_back(std::make_unique<Track>());
+    track->id = static_cast<uint32_t>(tracks.size());
+    if (name.empty())
+        track->name = "Thread " + std::to_string(track->id);
+    else
+        track->name = name;
+    return track.get();
+}
+
+Track& ThreadTrack() {
+    if (thread_track == nullptr)
+        thread_track = NewTrack({});
+    return *thread_track;
+}
+
+void AddToTrack(Track& track, const char* name, int64_t start, int64_t end) {
+    std::lock_guard lock(track.mtx);
+    if (track.zones.size() == MAX_ZONES_PER_TRACK) {
+        track.dropped++;
+        return;
+    }
+    track.zones.push_back({name, start, end});
+}
+
+void WriteEscaped(std::ostream& out, std::string_view str) {
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+}
+
+// the trace format wants microseconds
+void WriteMicros(std::ostream& out, int64_t ns) {
+    out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+}
+}  // namespace
+
+namespace detail {
+std::atomic<bool> enabled = false;
+
+int64_t Now() {
+    return std::chrono::duration_cast<Nanoseconds>(Clock::now() - epoch)
+        .count();
+}
+
+void AddZone(const char* name, int64_t start, int64_t end) {
+    AddToTrack(ThreadTrack(), name, start, end);
+}
+
+void AddGpuZone(const char* name, int64_t start, int64_t end) {
+    if (gpu_track == nullptr)
+        gpu_track = NewTrack("GPU");
+    AddToTrack(*gpu_track, name, start, end);
+}
+}  // namespace detail
+
+void SetEnabled(bool enabled) {
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void Clear() {
+    std::lock_guard lock(tracks_mtx);
+    for (auto& track : tracks) {
+        std::lock_guard track_lock(track->mtx);
+        track->zones.clear();
+        track->dropped = 0;
+    }
+}
+
+void SetThreadName(std::string_view name) {
+    Track& track = ThreadTrack();
+    std::lock_guard lock(track.mtx);
+    track.name = name;
+}
+
+bool WriteTrace(const std::filesystem::path& path) {
+    std::ofstream out(path);
+    if (!out) {
+        VERNA_LOGE("Could not write trace to ", path.string());
+        return false;
+    }
+    out << "{\"traceEvents\":[";
+    const char* separator = "\n";
+    std::lock_guard lock(tracks_mtx);
+    for (auto& track : tracks) {
+        std::lock_guard track_lock(track->mtx);
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+            << "\"tid\":" << track->id << ",\"args\":{\"name\":\"";
+        WriteEscaped(out, track->name);
+        out << "\"}}";
+        separator = ",\n";
+        for (const ZoneEvent& zone : track->zones) {
+            out << separator << "{\"name\":\"";
+            WriteEscaped(out, zone.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track->id
+                << ",\"ts\":";
+            WriteMicros(out, zone.start);
+            out << ",\"dur\":";
+            WriteMicros(out, zone.end - zone.start);
+            out << '}';
+        }
+        VERNA_LOGW_IF(track->dropped > 0, "Profiler dropped ", track->dropped,
+                      " zones of ", track->name);
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out.good();
+}
+
+#else
+
+void SetEnabled([[maybe_unused]] bool enabled) {}
+
+bool IsEnabled() {
+    return false;
+}
+
+void Clear() {}
+
+void SetThreadName([[maybe_unused]] std::string_view name) {}
+
+bool WriteTrace([[maybe_unused]] const std::filesystem::path& path) {
+    VERNA_LOGW("WriteTrace: profiler not compiled, see VIVERNA_PROFILER");
+    return false;
+}
+
+#endif
+
+}  // namespace verna::profiler
@@ -1,45 +1,164 @@
 #ifndef VERNA_RENDER_BATCH_HPP
 #define VERNA_RENDER_BATCH_HPP
 
+#include <array>
 #include <vector>
 #include <viverna/graphics/Material.hpp>
 #include <viverna/graphics/Mesh.hpp>
 #include <viverna/graphics/Renderer.hpp>
 #include <viverna/graphics/Texture.hpp>
-#include <viverna/graphics/Vertex.hpp>
+#include <viverna/data/SparseSet.hpp>
+#include <viverna/graphics/gpu/DrawCommand.hpp>
+#include <viverna/graphics/gpu/DrawData.hpp>
 #include <viverna/graphics/gpu/MeshData.hpp>
+#include "MeshPool.hpp"
 
 namespace verna {
 struct RenderBatch {
     static constexpr size_t MAX_MESHES = gpu::DrawData::MAX_MESHES;
-    // all of the vertices for this batch
-    std::vector<Vertex> vertices;
-    // all of the indices for this batch
-    std::vector<uint32_t> indices;
-    // -> vertices offsets (GLint* basevertex)
-    std::array<int32_t, MAX_MESHES> vertices_count;
-    // -> indices offsets (const GLvoid* const * indices)
-    std::array<int32_t, MAX_MESHES> indices_count;
-    // per-mesh data
-    gpu::DrawData draw_data;
+    // one instanced draw call
+    struct Draw {
+        // offset in the MeshPool vertex buffer
+        int32_t base_vertex;
+        // offset in the MeshPool index buffer
+        uint32_t first_index;
+        int32_t indices_count;
+        uint32_t instance_count;
+        // set by SortInstances: offset of the first instance
+        uint32_t first_instance;
+    };
+    std::vector<Draw> draws;
+    static constexpr uint16_t NO_DRAW = UINT16_MAX;
+    // Mesh::id -> draws rendering it (id 0 never gets instanced)
+    SparseSet<Mesh::id_type> mesh_ids;
+    // parallel to mesh_ids.GetDense(): draw of each level of detail, or
+    // NO_DRAW
+    std::vector<std::array<uint16_t, Mesh::MAX_LODS>> mesh_draws;
+    // per-instance data, in submission order
+    std::vector<gpu::MeshData> instances;
+    // draw of every instance (parallel to instances)
+    std::vector<uint16_t> instance_draws;
     // textures
     std::vector<TextureId> textures;
-    // number of meshes (GLsizei drawcount)
-    unsigned num_meshes = 0;
+    // index of the first command of this batch in the frame's command buffer
+    uint32_t first_command = 0;
 
     // returns -1 if not found
     int32_t GetTextureIndex(TextureId texture) const;
-    bool CanContain(const Mesh& mesh) const;
-    void GenerateOffsets(
-        std::array<const void*, MAX_MESHES>& indices_off_out,
-        std::array<int32_t, MAX_MESHES>& vertices_off_out) const;
-    bool TryAddUniformData(const Material& material, const Mat4f& transform);
+    bool CanContain(const Mesh& mesh, uint32_t lod) const;
+    // returns the draw that already renders that level of mesh, or -1
+    int32_t FindDraw(const Mesh& mesh, uint32_t lod) const;
+    // Adds a draw for location.lod of mesh (no instances yet) and returns
+    // its index
+    uint16_t NewDraw(const Mesh& mesh, const MeshLocation& location);
+    // Adds one more instance of the draw rendering location.lod of mesh,
+    // creating the draw if needed
+    void AddInstance(const Mesh& mesh,
+                     const MeshLocation& location,
+                     const gpu::MeshData& instance);
+    // Fills the material data, false if out of texture units
+    bool TryAddMaterial(const Material& material,
+                        gpu::MaterialData& material_out);
+    /**
+     * @brief Writes the instances grouped by draw, so that every draw reads
+     * a contiguous range
+     *
+     * @param out Destination of instances.size() elements
+     * @param first_instance Index of out[0] in the shader storage buffer
+     */
+    void SortInstances(gpu::MeshData* out, uint32_t first_instance);
+    /**
+     * @brief Writes one indirect draw command per draw. Call after
+     * SortInstances
+     *
+     * @param out Destination of draws.size() elements
+     */
+    void WriteCommands(gpu::DrawCommand* out) const;
     void Clear();
+
+   private:
+    std::vector<uint32_t> sort_offsets;
 };
 
-inline bool RenderBatch::CanContain(const Mesh& mesh) const {
-    // TODO max vertices, indices...
-    return num_meshes < MAX_MESHES;
+// Batches that survive across frames: Clear() empties them but keeps the
+// objects, with the capacity of their buffers, for the next frame
+class RenderBatchList {
+   public:
+    // Returns an empty batch
+    RenderBatch& Add();
+    void Clear();
+    size_t Size() const { return size; }
+    bool Empty() const { return size == 0; }
+    RenderBatch& operator[](size_t index) { return batches[index]; }
+    const RenderBatch& operator[](size_t index) const { return batches[index]; }
+    RenderBatch& Back() { return batches[size - 1]; }
+    RenderBatch* begin() { return batches.data(); }
+    RenderBatch* end() { return batches.data() + size; }
+    const RenderBatch* begin() const { return batches.data(); }
+    const RenderBatch* end() const { return batches.data() + size; }
+
+   private:
+    std::vector<RenderBatch> batches;
+    // batches in use, the others are cleared
+    size_t size = 0;
+};
+
+inline RenderBatch& RenderBatchList::Add() {
+    if (size == batches.size())
+        batches.emplace_back();
+    return batches[size++];
+}
+
+inline void RenderBatchList::Clear() {
+    for (size_t i = 0; i < size; i++)
+        batches[i].Clear();
+    size = 0;
+}
+
+inline bool RenderBatch::CanContain(const Mesh& mesh, uint32_t lod) const {
+    // geometry lives in the MeshPool: only per-mesh data is limited
+    return draws.size() < MAX_MESHES || FindDraw(mesh, lod) != -1;
+}
+
+inline int32_t RenderBatch::FindDraw(const Mesh& mesh, uint32_t lod) const {
+    SparseSet<Mesh::id_type>::index_t i;
+    if (mesh.id == 0 || !mesh_ids.GetIndex(mesh.id, i))
+        return -1;
+    uint16_t draw = mesh_draws[i][lod];
+    return draw == NO_DRAW ? -1 : draw;
+}
+
+inline uint16_t RenderBatch::NewDraw(const Mesh& mesh,
+                                     const MeshLocation& location) {
+    auto index = static_cast<uint16_t>(draws.size());
+    Draw& draw = draws.emplace_back();
+    draw.base_vertex = location.base_vertex;
+    draw.first_index = location.first_index;
+    draw.indices_count = static_cast<int32_t>(location.index_count);
+    draw.instance_count = 0;
+    draw.first_instance = 0;
+    if (mesh.id != 0) {
+        SparseSet<Mesh::id_type>::index_t i;
+        if (!mesh_ids.GetIndex(mesh.id, i)) {
+            i = static_cast<SparseSet<Mesh::id_type>::index_t>(mesh_ids.Size());
+            mesh_ids.Add(mesh.id);
+            mesh_draws.emplace_back().fill(NO_DRAW);
+        }
+        mesh_draws[i][location.lod] = index;
+    }
+    return index;
+}
+
+inline void RenderBatch::AddInstance(const Mesh& mesh,
+                                     const MeshLocation& location,
+                                     const gpu::MeshData& instance) {
+    // same mesh in the same batch: one more instance of the same draw
+    int32_t draw = FindDraw(mesh, location.lod);
+    if (draw == -1)
+        draw = NewDraw(mesh, location);
+    draws[draw].instance_count++;
+    instances.push_back(instance);
+    instance_draws.push_back(static_cast<uint16_t>(draw));
 }
 
 inline int32_t RenderBatch::GetTextureIndex(TextureId texture) const {
@@ -49,26 +168,10 @@ inline int32_t RenderBatch::GetTextureIndex(TextureId texture) const {
     return -1;
 }
 
-inline void RenderBatch::GenerateOffsets(
-    std::array<const void*, RenderBatch::MAX_MESHES>& indices_off_out,
-    std::array<int32_t, RenderBatch::MAX_MESHES>& vertices_off_out) const {
-    indices_off_out[0] = static_cast<const void*>(0);
-    vertices_off_out[0] = 0;
-    for (unsigned i = 1; i < num_meshes; i++) {
-        unsigned prev = i - 1;
-        size_t n = reinterpret_cast<size_t>(indices_off_out[prev]);
-        n += static_cast<size_t>(indices_count[prev])
-             * sizeof(decltype(indices[0]));
-        indices_off_out[i] = reinterpret_cast<const void*>(n);
-        vertices_off_out[i] = vertices_off_out[prev] + vertices_count[prev];
-    }
-}
-
-inline bool RenderBatch::TryAddUniformData(const Material& material,
-                                           const Mat4f& transform) {
+inline bool RenderBatch::TryAddMaterial(const Material& material,
+                                        gpu::MaterialData& material_out) {
     const size_t max_textures =
         static_cast<size_t>(RendererInfo::MaxMaterialTextures());
-    gpu::MeshData& mesh_data = draw_data[num_meshes];
     for (size_t i = 0; i < material.textures.size(); i++) {
         TextureId mat_texture = material.textures[i];
         if (!mat_texture.IsValid())
@@ -80,25 +183,48 @@ inline bool RenderBatch::TryAddUniformData(const Material& material,
             index = textures.size();
             textures.push_back(mat_texture);
         }
-        mesh_data.material.texture_indices[i] = index;
+        material_out.texture_indices[i] = index;
     }
-    mesh_data.material.parameters = material.parameters;
-    mesh_data.model_matrix = transform;
-    mesh_data.transpose_inverse_model_matrix =
-        transform.Inverted().Transposed();
+    material_out.parameters = material.parameters;
     return true;
 }
 
+inline void RenderBatch::SortInstances(gpu::MeshData* out,
+                                       uint32_t first_instance) {
+    uint32_t offset = 0;
+    for (Draw& draw : draws) {
+        draw.first_instance = first_instance + offset;
+        offset += draw.instance_count;
+    }
+    // counting sort: instance counts are the bucket sizes
+    std::vector<uint32_t>& next = sort_offsets;
+    next.resize(draws.size());
+    for (size_t i = 0; i < draws.size(); i++)
+        next[i] = draws[i].first_instance - first_instance;
+    for (size_t i = 0; i < instances.size(); i++)
+        out[next[instance_draws[i]]++] = instances[i];
+}
+
+inline void RenderBatch::WriteCommands(gpu::DrawCommand* out) const {
+    for (size_t i = 0; i < draws.size(); i++) {
+        const Draw& draw = draws[i];
+        gpu::DrawCommand& cmd = out[i];
+        cmd.count = static_cast<uint32_t>(draw.indices_count);
+        cmd.instance_count = draw.instance_count;
+        cmd.first_index = draw.first_index;
+        cmd.base_vertex = draw.base_vertex;
+        cmd.base_instance = draw.first_instance;
+    }
+}
+
 inline void RenderBatch::Clear() {
-    vertices.clear();
-    indices.clear();
-#ifndef NDEBUG
-    constexpr int INVALID_OFFSET = -1;
-    vertices_count.fill(INVALID_OFFSET);
-    indices_count.fill(INVALID_OFFSET);
-#endif
+    draws.clear();
+    mesh_ids.Clear();
+    mesh_draws.clear();
+    instances.clear();
+    instance_draws.clear();
     textures.clear();
-    num_meshes = 0;
+    first_command = 0;
 }
 
 }  // namespace verna
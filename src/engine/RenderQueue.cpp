@@ -0,0 +1,46 @@
+#include <viverna/graphics/RenderQueue.hpp>
+#include <viverna/core/Debug.hpp>
+
+namespace verna {
+
+RenderQueue::Command RenderQueue::Command::From(const Mesh& mesh,
+                                                const Material& material,
+                                                const Transform& transform,
+                                                ShaderId shader_id) {
+    VERNA_LOGE_IF(!shader_id.IsValid(), "Called Render() with invalid shader!");
+    VERNA_LOGE_IF(mesh.vertices.empty() || mesh.indices.empty(),
+                  "Called Render() on empty Mesh!");
+    Command cmd;
+    cmd.mesh = &mesh;
+    cmd.material = material;
+    cmd.model_matrix = transform.GetMatrix();
+    cmd.transpose_inverse_model_matrix =
+        cmd.model_matrix.InvertedTransposed();
+    cmd.bounds = mesh.bounds;
+    cmd.bounds.ApplyTransform(transform);
+    cmd.shader = shader_id;
+    return cmd;
+}
+
+void RenderQueue::Render(const Mesh& mesh,
+                         const Material& material,
+                         const Transform& transform,
+                         ShaderId shader_id) {
+    const Command& cmd = commands.emplace_back(
+        Command::From(mesh, material, transform, shader_id));
+    if (commands.size() == 1)
+        bounds = cmd.bounds;
+    else
+        bounds.Encapsulate(cmd.bounds);
+}
+
+void RenderQueue::Clear() {
+    commands.clear();
+    bounds = BoundingBox();
+}
+
+void RenderQueue::Reserve(size_t num_commands) {
+    commands.reserve(num_commands);
+}
+
+}  // namespace verna
@@ -1,24 +1,36 @@
 #include <viverna/graphics/Renderer.hpp>
 #include <viverna/core/BoundingBox.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
 #include <viverna/core/Scene.hpp>
+#include <viverna/core/ThreadPool.hpp>
 #include <viverna/core/Transform.hpp>
 #include <viverna/graphics/Material.hpp>
 #include <viverna/graphics/ShaderManager.hpp>
 #include <viverna/graphics/Texture.hpp>
 #include <viverna/graphics/Vertex.hpp>
 #include <viverna/graphics/Window.hpp>
+#include <viverna/graphics/gpu/DrawCommand.hpp>
 #include <viverna/graphics/gpu/DrawData.hpp>
 #include <viverna/graphics/gpu/FrameData.hpp>
+#include "BindlessTextures.hpp"
+#include "FrustumCulling.hpp"
+#include "GpuProfiler.hpp"
+#include "MeshPool.hpp"
+#include "OcclusionCulling.hpp"
 #include "RenderBatch.hpp"
 #include "ShaderBucketMapper.hpp"
+#include "SortKey.hpp"
+#include "StorageRing.hpp"
 #include "UniformBuffer.hpp"
 
 #include <algorithm>
 #include <utility>
 #include <vector>
 
-#if defined(VERNA_DESKTOP)
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 #elif defined(VERNA_ANDROID)
@@ -31,23 +43,101 @@
 namespace verna {
 
 namespace {
-struct GlDrawCommand {
-    // indices counts
-    const GLsizei* count;
-    // indices offsets
-    const GLvoid* const* indices;
-    // number of meshes
-    GLsizei drawcount;
-    // vertices offsets
-    const GLint* basevertex;
-};
-
 void* native_window = nullptr;
 ShaderBucketMapper shader_to_bucket;
-std::vector<RenderBatch> render_batches;
+RenderBatchList render_batches;
+// batches of DepthPass: visible casters, grouped regardless of shader
+RenderBatchList shadow_batches;
+
+// submissions of the current frame, batched by Draw() after culling
+std::vector<RenderQueue::Command> submissions;
+CullingBoxes submission_bounds;
+std::vector<uint8_t> submission_visible;
+// visible shadow casters, parallel to submissions
+std::vector<uint8_t> caster_visible;
+// union of the visible submissions
+BoundingBox receiver_bounds;
+// where the mesh of each submission is in the MeshPool, if fetched, at
+// the level of detail picked for the frame
+std::vector<MeshLocation> submission_locations;
+std::vector<uint8_t> submission_fetched;
+// visible submissions in drawing order
+std::vector<SortItem> sort_items;
+std::vector<SortItem> sort_scratch;
+
+// Shadow map caching: the depth pass is skipped while the light matrix and
+// the list of casters stay the same. The level of detail of a caster
+// depends on the camera, so it's part of the key
+struct ShadowCasterKey {
+    Mesh::id_type mesh_id;
+    uint32_t lod;
+    Mat4f model_matrix;
+};
+bool shadow_caching = false;
+// set when the shadow map content can't be trusted anymore
+bool shadow_map_dirty = true;
+bool shadow_map_reused = false;
+std::vector<ShadowCasterKey> shadow_casters;
+std::vector<ShadowCasterKey> last_shadow_casters;
+Mat4f last_shadow_pv_matrix;
+CullingStats culling_stats;
+// stats of the last Draw(), with the history of the last frames (a ring
+// starting at stats_history_next once full)
+RendererStats frame_stats;
+std::vector<RendererStats> stats_history;
+size_t stats_history_size = 0;
+size_t stats_history_next = 0;
+
+// Levels of detail: level i + 1 is used when the diameter of the bounds of a
+// mesh is smaller than LOD_SCREEN_SIZES[i], as a fraction of the screen
+// height
+constexpr std::array<float, Mesh::MAX_LODS - 1> LOD_SCREEN_SIZES = {
+    0.25f, 0.1f, 0.04f};
+
+// Occlusion culling: occluders are rasterized on the CPU, then the visible
+// submissions are tested against the resulting depth
+struct Occluder {
+    const Mesh* mesh;
+    Mat4f model_matrix;
+};
+bool occlusion_culling = false;
+std::vector<Occluder> occluders;
+OcclusionBuffer occlusion_buffer;
+constexpr uint32_t OCCLUSION_BUFFER_WIDTH = 256;
+constexpr uint32_t OCCLUSION_BUFFER_HEIGHT = 128;
+// boxes tested by each task
+constexpr size_t OCCLUSION_GRAIN = 256;
+
+MeshPool mesh_pool;
+#if defined(VERNA_DESKTOP)
+// per-instance data of every batch, written once per frame
+StorageRing instance_ring;
+#elif defined(VERNA_ANDROID)
+// per-instance data of every batch, sent to the DrawData uniform block up to
+// MAX_UNIFORM_INSTANCES at a time
+std::vector<gpu::MeshData> frame_instances;
+// range of frame_instances currently in the uniform block
+uint32_t uniform_instances_begin = 0;
+uint32_t uniform_instances_end = 0;
+#endif
+// indirect draw commands of every batch, built once per frame and used by
+// every pass
+#if defined(VERNA_DESKTOP)
+StorageRing command_ring;
+#elif defined(VERNA_ANDROID)
+std::vector<gpu::DrawCommand> frame_commands;
+#endif
+const gpu::DrawCommand* commands_begin = nullptr;
 
-GLuint vao, vbo, ebo;
-GLsizeiptr vbo_size, ebo_size;
+// With bindless textures, materials index a table with the handles of every
+// texture used in the frame, so textures never split batches.
+// Index 0 is a white texture, used for missing textures
+SparseSet<TextureId::id_type> frame_texture_ids;
+std::vector<uint64_t> frame_texture_handles;
+#if defined(VERNA_DESKTOP)
+StorageRing texture_ring;
+#endif
+TextureId white_texture;
 
 gpu::FrameData frame_data;
 
@@ -60,12 +150,16 @@ constexpr GLsizei SHADOW_MAP_SIZE = 2048;
 constexpr GLsizei SHADOW_MAP_WIDTH = SHADOW_MAP_SIZE;
 constexpr GLsizei SHADOW_MAP_HEIGHT = SHADOW_MAP_SIZE;
 
+Mesh wireframe_cube;
+Mesh wireframe_sphere;
+
 BoundingBox render_bounds;
 }  // namespace
 
 static void CheckForGLErrors(std::string_view origin);
 static void LoadPrivateShaders();
 static void FreePrivateShaders();
+static void LoadPrivateMeshes();
 static void GenBuffers();
 static void DeleteBuffers();
 static void ClearBatches();
@@ -74,17 +168,39 @@ static void RendererError(VivernaState& state,
                           [[maybe_unused]] std::string_view message);
 static BatchId NewBatchInExistingBucket(Bucket& bucket);
 static BatchId NewBatchInNewBucket(ShaderId shader);
-static void SendDataToVbo(const RenderBatch& batch);
-static void SendDataToEbo(const RenderBatch& batch);
 static void BindTextures(const RenderBatch& batch);
 static void PrepareDraw();
+static void LightSpaceBounds(const Mat4f& view,
+                             const BoundingBox& box,
+                             Vec3f& out_min,
+                             Vec3f& out_max);
+static void CullForCamera();
+static uint32_t CullOccluded();
+static uint32_t SelectLod(const RenderQueue::Command& cmd);
+static void CullForLight();
+static bool CanReuseShadowMap();
 static void DepthPass();
 static void DrawBatchIgnoreTextures(const RenderBatch& batch);
+#if defined(VERNA_ANDROID)
+static void SendUniformInstances(uint32_t first);
+#endif
 static void DrawBatch(const RenderBatch& batch);
-static void DrawGlCommand(const GlDrawCommand& cmd);
+static void SendDrawData();
+static void DrawSubmissions();
+static void FinishStats();
 static void InitLights();
 static void TermLights();
 static void ResetRenderBounds();
+static void EncapsulateRenderBounds(const BoundingBox& box);
+static void Submit(const RenderQueue::Command& cmd);
+static void BuildBatches();
+static void AddToBatch(const RenderQueue::Command& cmd,
+                       const MeshLocation& location);
+static void AddToShadowBatch(const RenderQueue::Command& cmd,
+                             const MeshLocation& location);
+static void ResetTextureTable();
+static void AddBindlessMaterial(const Material& material,
+                                gpu::MaterialData& material_out);
 
 static auto DirectionLightTUIndex() {
     return RendererInfo::MaxMaterialTextures();
@@ -120,12 +236,12 @@ void CheckForGLErrors(std::string_view origin) {
                 error_string = std::to_string(glerr);
                 break;
         }
-        VERNA_LOGE(std::string(origin)
-                   + " detected OpenGL error: " + error_string);
+        VERNA_LOGE(origin, " detected OpenGL error: ", error_string);
     }
 }
 
 void InitLights() {
+    shadow_map_dirty = true;
     glGenFramebuffers(1, &dirlight_fbo);
 
     glGenTextures(1, &dirlight_depthmap);
@@ -149,9 +265,8 @@ void InitLights() {
     glDrawBuffers(1, &none);
     glReadBuffer(GL_NONE);
     [[maybe_unused]] auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    VERNA_LOGE_IF(
-        status != GL_FRAMEBUFFER_COMPLETE,
-        "Incomplete fbo for direction light: " + std::to_string(status));
+    VERNA_LOGE_IF(status != GL_FRAMEBUFFER_COMPLETE,
+                  "Incomplete fbo for direction light: ", status);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
@@ -171,64 +286,117 @@ void FreePrivateShaders() {
     shaders.FreeShader(dirlight_shader);
 }
 
+void LoadPrivateMeshes() {
+    // loaded once, so that they keep the same id in the MeshPool
+    wireframe_cube = LoadPrimitiveMesh(PrimitiveMeshType::Cube);
+    wireframe_sphere = LoadPrimitiveMesh(PrimitiveMeshType::Sphere);
+}
+
 void GenBuffers() {
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-
-    constexpr GLsizeiptr vbo_size_start =
-        sizeof(Vertex) * 8 * RenderBatch::MAX_MESHES;
-    constexpr GLsizeiptr ebo_size_start =
-        sizeof(decltype(RenderBatch::indices[0])) * 6 * 6
-        * RenderBatch::MAX_MESHES;
-
-    vbo_size = vbo_size_start;
-    ebo_size = ebo_size_start;
-    glGenBuffers(1, &vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vbo_size, nullptr, GL_DYNAMIC_DRAW);
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, ebo_size, nullptr, GL_DYNAMIC_DRAW);
+    mesh_pool.Initialize();
     ubo::GenerateUBO();
     ubo::AddBlock(gpu::FrameData::BLOCK_BINDING, sizeof(gpu::FrameData));
-    ubo::AddBlock(gpu::DrawData::BLOCK_BINDING, sizeof(gpu::DrawData));
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          reinterpret_cast<void*>(offsetof(Vertex, position)));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(
-        1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-        reinterpret_cast<void*>(offsetof(Vertex, texture_coords)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          reinterpret_cast<void*>(offsetof(Vertex, normal)));
-    glEnableVertexAttribArray(2);
+
+#if defined(VERNA_DESKTOP)
+    constexpr size_t instance_ring_size_start =
+        sizeof(gpu::MeshData) * RenderBatch::MAX_MESHES;
+    instance_ring.Initialize(GL_SHADER_STORAGE_BUFFER,
+                             gpu::DrawData::BLOCK_BINDING,
+                             instance_ring_size_start);
+    constexpr size_t command_ring_size_start =
+        sizeof(gpu::DrawCommand) * RenderBatch::MAX_MESHES;
+    command_ring.Initialize(GL_DRAW_INDIRECT_BUFFER, 0,
+                            command_ring_size_start);
+#elif defined(VERNA_ANDROID)
+    constexpr size_t draw_data_size =
+        sizeof(gpu::MeshData) * gpu::DrawData::MAX_UNIFORM_INSTANCES;
+    // both blocks, with room for the offset alignment of the second one
+    static_assert(sizeof(gpu::FrameData) + 256 + draw_data_size <= 16384);
+    ubo::AddBlock(gpu::DrawData::BLOCK_BINDING, draw_data_size);
+#endif
+    if (bindless::IsSupported()) {
+#if defined(VERNA_DESKTOP)
+        constexpr size_t texture_ring_size_start = 1024 * sizeof(uint64_t);
+        texture_ring.Initialize(GL_SHADER_STORAGE_BUFFER,
+                                gpu::DrawData::TEXTURE_TABLE_BINDING,
+                                texture_ring_size_start);
+#endif
+        constexpr uint32_t white = 0xFFFFFFFF;
+        glGenTextures(1, &white_texture.id);
+        glBindTexture(GL_TEXTURE_2D, white_texture.id);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, 1, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA,
+                        GL_UNSIGNED_BYTE, &white);
+        bindless::Register(white_texture);
+        ResetTextureTable();
+    }
 
     CheckForGLErrors("GenBuffers");
 }
 
 void DeleteBuffers() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
+    mesh_pool.Terminate();
     ubo::TerminateUBO();
-    vbo_size = 0;
-    ebo_size = 0;
+#if defined(VERNA_DESKTOP)
+    instance_ring.Terminate();
+    command_ring.Terminate();
+#endif
+    if (white_texture.IsValid()) {
+#if defined(VERNA_DESKTOP)
+        texture_ring.Terminate();
+#endif
+        bindless::Unregister(white_texture);
+        glDeleteTextures(1, &white_texture.id);
+        white_texture = TextureId();
+    }
 }
 
 void ClearBatches() {
-    /*
-    for (auto& batch : render_batches)
-        batch.Clear();
-    */
+    // everything keeps its capacity: no allocations in steady state
     shader_to_bucket.Clear();
-    render_batches.clear();
+    render_batches.Clear();
+    shadow_batches.Clear();
+    submissions.clear();
+    submission_bounds.Clear();
+    occluders.clear();
+    if (bindless::IsSupported())
+        ResetTextureTable();
+}
+
+void ResetTextureTable() {
+    frame_texture_ids.Clear();
+    frame_texture_handles.clear();
+    frame_texture_ids.Add(white_texture.id);
+    frame_texture_handles.push_back(bindless::GetHandle(white_texture));
+}
+
+void AddBindlessMaterial(const Material& material,
+                         gpu::MaterialData& material_out) {
+    for (size_t i = 0; i < material.textures.size(); i++) {
+        TextureId texture = material.textures[i];
+        SparseSet<TextureId::id_type>::index_t index;
+        int32_t slot = 0;  // white texture
+        if (!texture.IsValid()) {
+            // keep the white texture
+        } else if (frame_texture_ids.GetIndex(texture.id, index)) {
+            slot = static_cast<int32_t>(index);
+        } else if (uint64_t handle = bindless::GetHandle(texture)) {
+            slot = static_cast<int32_t>(frame_texture_handles.size());
+            frame_texture_ids.Add(texture.id);
+            frame_texture_handles.push_back(handle);
+        }
+        material_out.texture_indices[i] = slot;
+    }
+    material_out.parameters = material.parameters;
 }
 
 void SwapBuffers() {
+    VERNA_PROFILE_FUNCTION();
     VERNA_LOGE_IF(native_window == nullptr,
                   "SwapBuffers called with nullptr native_window");
-#if defined(VERNA_DESKTOP)
+#if defined(VERNA_NULL_BACKEND)
+    null_backend::EndFrame();
+#elif defined(VERNA_DESKTOP)
     GLFWwindow* window = static_cast<GLFWwindow*>(native_window);
     VERNA_LOGE_IF(window != glfwGetCurrentContext(),
                   "Renderer error: no access to current context window!");
@@ -255,9 +423,9 @@ void RendererError(VivernaState& state,
 }
 
 BatchId NewBatchInExistingBucket(Bucket& bucket) {
-    BatchId output = static_cast<BatchId>(render_batches.size());
+    BatchId output = static_cast<BatchId>(render_batches.Size());
     bucket.push_back(output);
-    render_batches.push_back(RenderBatch());
+    render_batches.Add();
     return output;
 }
 
@@ -266,51 +434,32 @@ BatchId NewBatchInNewBucket(ShaderId shader) {
     return NewBatchInExistingBucket(bucket);
 }
 
-void SendDataToVbo(const RenderBatch& batch) {
-    const GLsizeiptr vbo_bytes =
-        static_cast<GLsizeiptr>(batch.vertices.size() * sizeof(Vertex));
-    if (vbo_bytes > vbo_size) {
-        vbo_size = std::max(vbo_size * 3 / 2, vbo_bytes);
-        glBufferData(GL_ARRAY_BUFFER, vbo_size, nullptr, GL_DYNAMIC_DRAW);
-    }
-    glBufferSubData(GL_ARRAY_BUFFER, 0, vbo_bytes, batch.vertices.data());
-}
-
-void SendDataToEbo(const RenderBatch& batch) {
-    const GLsizeiptr ebo_bytes = static_cast<GLsizeiptr>(
-        batch.indices.size() * sizeof(decltype(RenderBatch::indices[0])));
-    if (ebo_bytes > ebo_size) {
-        ebo_size = std::max(ebo_size * 3 / 2, ebo_bytes);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, ebo_size, nullptr,
-                     GL_DYNAMIC_DRAW);
-    }
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, ebo_bytes,
-                    batch.indices.data());
-}
-
 void BindTextures(const RenderBatch& batch) {
+    // bindless batches reach their textures through the handle table
+    if (bindless::IsSupported() || batch.textures.empty())
+        return;
 #if defined(VERNA_DESKTOP)
-    const GLuint* textures = &batch.textures.front().id;
+    static_assert(sizeof(TextureId) == sizeof(GLuint));
+    const auto* textures =
+        reinterpret_cast<const GLuint*>(batch.textures.data());
     GLsizei count = static_cast<GLsizei>(batch.textures.size());
     glBindTextures(0, count, textures);
+    frame_stats.texture_binds += static_cast<uint32_t>(count);
 #else
     for (size_t i = 0; i < batch.textures.size(); i++) {
         glActiveTexture(GL_TEXTURE0 + i);
         glBindTexture(GL_TEXTURE_2D, batch.textures[i].id);
     }
+    frame_stats.texture_binds += static_cast<uint32_t>(batch.textures.size());
 #endif
 }
 
-void PrepareDraw() {
-    const Scene& scene = Scene::GetActive();
-    const DirectionLight& dirlight = scene.direction_light;
-
-    Vec3f lightdir = dirlight.direction.Normalized();
-    Mat4f view = Mat4f::LookAt(-lightdir, Vec3f(),
-                               lightdir.Cross(Vec3f::UnitX()).Normalized());
-
-    Vec3f min = render_bounds.MinPosition();
-    Vec3f max = render_bounds.MaxPosition();
+void LightSpaceBounds(const Mat4f& view,
+                      const BoundingBox& box,
+                      Vec3f& out_min,
+                      Vec3f& out_max) {
+    Vec3f min = box.MinPosition();
+    Vec3f max = box.MaxPosition();
     std::array lightview = {min,
                             Vec3f(min.x, min.y, max.z),
                             Vec3f(min.x, max.y, min.z),
@@ -323,25 +472,157 @@ void PrepareDraw() {
         Vec4f temp = view * Vec4f(p, 1.0f);
         p = (1.0f / temp.w) * temp.Xyz();
     }
-    min = lightview[0];
-    max = min;
+    out_min = lightview[0];
+    out_max = out_min;
     for (size_t i = 1; i < lightview.size(); i++) {
-        min = Vec3f::Min(min, lightview[i]);
-        max = Vec3f::Max(max, lightview[i]);
+        out_min = Vec3f::Min(out_min, lightview[i]);
+        out_max = Vec3f::Max(out_max, lightview[i]);
+    }
+}
+
+void CullForCamera() {
+    VERNA_PROFILE_FUNCTION();
+    const Frustum frustum =
+        Frustum::FromMatrix(frame_data.camera_data.pv_matrix);
+    submission_visible.resize(submissions.size());
+    culling_stats.submitted = static_cast<uint32_t>(submissions.size());
+    culling_stats.culled = static_cast<uint32_t>(
+        submission_bounds.Cull(frustum, submission_visible.data()));
+    culling_stats.occluded = CullOccluded();
+    receiver_bounds = BoundingBox();
+    bool first = true;
+    for (size_t i = 0; i < submissions.size(); i++) {
+        if (!submission_visible[i])
+            continue;
+        if (first)
+            receiver_bounds = submissions[i].bounds;
+        else
+            receiver_bounds.Encapsulate(submissions[i].bounds);
+        first = false;
+    }
+}
+
+uint32_t CullOccluded() {
+    VERNA_PROFILE_FUNCTION();
+    if (!occlusion_culling || occluders.empty())
+        return 0;
+    occlusion_buffer.Begin(frame_data.camera_data.pv_matrix);
+    for (const Occluder& occluder : occluders)
+        occlusion_buffer.AddOccluder(*occluder.mesh, occluder.model_matrix);
+    occlusion_buffer.Finish();
+    ThreadPool::Get().ParallelFor(
+        0, submissions.size(), OCCLUSION_GRAIN, [](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (submission_visible[i]
+                    && !occlusion_buffer.IsVisible(submissions[i].bounds))
+                    submission_visible[i] = 0;
+            }
+        });
+    auto hidden = static_cast<uint32_t>(std::count(
+        submission_visible.begin(), submission_visible.end(), uint8_t{0}));
+    return hidden - culling_stats.culled;
+}
+
+void CullForLight() {
+    VERNA_PROFILE_FUNCTION();
+    const DirectionLight& dirlight = Scene::GetActive().direction_light;
+    Vec3f lightdir = dirlight.direction.Normalized();
+    Mat4f view = Mat4f::LookAt(-lightdir, Vec3f(),
+                               lightdir.Cross(Vec3f::UnitX()).Normalized());
+
+    caster_visible.assign(submissions.size(), 0);
+    culling_stats.casters = 0;
+    shadow_map_reused = false;
+    if (culling_stats.culled + culling_stats.occluded
+        == culling_stats.submitted) {
+        // no receivers: no shadows to draw, DepthPass just clears the map
+        shadow_map_dirty = true;
+        return;
+    }
+
+    // the shadow volume covers the visible receivers, extended toward the
+    // light up to the farthest submitted mesh, so that casters out of sight
+    // still shadow what's visible. A cached shadow map covers the whole
+    // scene instead, so that it stays valid when the camera moves
+    Vec3f min, max, scene_min, scene_max;
+    LightSpaceBounds(view, shadow_caching ? render_bounds : receiver_bounds,
+                     min, max);
+    LightSpaceBounds(view, render_bounds, scene_min, scene_max);
+    Mat4f cull_proj =
+        Mat4f::Ortho(min.x, max.x, max.y, min.y, scene_min.z, max.z);
+    const Frustum frustum = Frustum::FromMatrix(cull_proj * view);
+    submission_bounds.Cull(frustum, caster_visible.data());
+
+    // tighten the depth range to the casters actually drawn
+    float near = min.z;
+    shadow_casters.clear();
+    for (size_t i = 0; i < submissions.size(); i++) {
+        const RenderQueue::Command& cmd = submissions[i];
+        if (!caster_visible[i])
+            continue;
+        if (!cmd.material.CastsShadow()) {
+            caster_visible[i] = 0;
+            continue;
+        }
+        Vec3f caster_min, caster_max;
+        LightSpaceBounds(view, cmd.bounds, caster_min, caster_max);
+        near = std::min(near, caster_min.z);
+        culling_stats.casters++;
+        if (shadow_caching)
+            shadow_casters.push_back(
+                {cmd.mesh->id, SelectLod(cmd), cmd.model_matrix});
     }
-    Mat4f proj = Mat4f::Ortho(min.x, max.x, max.y, min.y, min.z, max.z);
+    Mat4f proj = Mat4f::Ortho(min.x, max.x, max.y, min.y, near, max.z);
+    frame_data.direction_light.pv_matrix = proj * view;
+
+    shadow_map_reused = CanReuseShadowMap();
+    if (shadow_map_reused) {
+        // no shadow batches to build
+        caster_visible.assign(submissions.size(), 0);
+        culling_stats.casters = 0;
+    }
+}
+
+bool CanReuseShadowMap() {
+    if (!shadow_caching)
+        return false;
+    const Mat4f& pv = frame_data.direction_light.pv_matrix;
+    bool same = !shadow_map_dirty && pv.raw == last_shadow_pv_matrix.raw
+                && shadow_casters.size() == last_shadow_casters.size();
+    for (size_t i = 0; same && i < shadow_casters.size(); i++) {
+        const ShadowCasterKey& a = shadow_casters[i];
+        const ShadowCasterKey& b = last_shadow_casters[i];
+        // id 0 meshes are rebuilt every frame: can't tell if they changed
+        same = a.mesh_id != 0 && a.mesh_id == b.mesh_id && a.lod == b.lod
+               && a.model_matrix.raw == b.model_matrix.raw;
+    }
+    if (same)
+        return true;
+    std::swap(shadow_casters, last_shadow_casters);
+    last_shadow_pv_matrix = pv;
+    shadow_map_dirty = false;
+    return false;
+}
+
+void PrepareDraw() {
+    VERNA_PROFILE_FUNCTION();
+    const Scene& scene = Scene::GetActive();
+    const DirectionLight& dirlight = scene.direction_light;
 
     frame_data.direction_light.ambient = Vec4f(dirlight.ambient, 0.0f);
     frame_data.direction_light.diffuse = Vec4f(dirlight.diffuse, 0.0f);
     frame_data.direction_light.specular = Vec4f(dirlight.specular, 0.0f);
     frame_data.direction_light.direction = Vec4f(dirlight.direction, 0.0f);
-    frame_data.direction_light.pv_matrix = proj * view;
     frame_data.camera_data = gpu::CameraData(scene.camera);
+    CullForCamera();
+    CullForLight();
 
     ubo::SendData(gpu::FrameData::BLOCK_BINDING, &frame_data);
 }
 
 void DepthPass() {
+    VERNA_PROFILE_FUNCTION();
+    VERNA_PROFILE_GPU_SCOPE("DepthPass");
     glViewport(0, 0, SHADOW_MAP_WIDTH, SHADOW_MAP_HEIGHT);
     glBindFramebuffer(GL_FRAMEBUFFER, dirlight_fbo);
     glDepthFunc(GL_LESS);
@@ -350,17 +631,12 @@ void DepthPass() {
     glClear(GL_DEPTH_BUFFER_BIT);
     glActiveTexture(GL_TEXTURE0 + DirectionLightTUIndex());
     glBindTexture(GL_TEXTURE_2D, dirlight_depthmap);
+    frame_stats.texture_binds++;
 
     glUseProgram(dirlight_shader.id);
-    ShaderId dontcare;
-    Bucket bucket;
-    for (size_t i = 0; i < shader_to_bucket.Size(); i++) {
-        shader_to_bucket.Get(i, dontcare, bucket);
-        for (BatchId batch_id : bucket) {
-            const RenderBatch& batch = render_batches[batch_id];
-            DrawBatchIgnoreTextures(batch);
-        }
-    }
+    frame_stats.program_binds++;
+    for (const RenderBatch& batch : shadow_batches)
+        DrawBatchIgnoreTextures(batch);
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDepthFunc(GL_GEQUAL);
@@ -386,7 +662,9 @@ void InitializeRenderer(VivernaState& state) {
     }
 
     GenBuffers();
+    gpu_profiler::Initialize();
     LoadPrivateShaders();
+    LoadPrivateMeshes();
     glClearColor(0.1f, 0.2f, 0.2f, 1.0f);
     glClearDepthf(0.0f);
     glEnable(GL_CULL_FACE);
@@ -396,6 +674,7 @@ void InitializeRenderer(VivernaState& state) {
     glCullFace(GL_BACK);
 
     InitLights();
+    occlusion_buffer.Resize(OCCLUSION_BUFFER_WIDTH, OCCLUSION_BUFFER_HEIGHT);
 
     state.SetFlag(VivernaState::RENDERER_INITIALIZED_FLAG, true);
     native_window = state.native_window;
@@ -408,6 +687,7 @@ void TerminateRenderer(VivernaState& state) {
 
     TermLights();
     FreePrivateShaders();
+    gpu_profiler::Terminate();
     DeleteBuffers();
 
     state.SetFlag(VivernaState::RENDERER_INITIALIZED_FLAG, false);
@@ -415,90 +695,263 @@ void TerminateRenderer(VivernaState& state) {
     VERNA_LOGI("Renderer terminated!");
 }
 
-static void Render(const Mesh& mesh,
-                   const Material& material,
-                   const Mat4f& model_matrix,
-                   ShaderId shader_id) {
-    VERNA_LOGE_IF(!shader_id.IsValid(), "Called Render() with invalid shader!");
-    VERNA_LOGE_IF(mesh.vertices.empty() || mesh.indices.empty(),
-                  "Called Render() on empty Mesh!");
+void Submit(const RenderQueue::Command& cmd) {
+    submissions.push_back(cmd);
+    submission_bounds.Add(cmd.bounds);
+}
+
+uint32_t SelectLod(const RenderQueue::Command& cmd) {
+    if (cmd.mesh->lods.empty())
+        return 0;
+    const gpu::CameraData& camera = frame_data.camera_data;
+    Vec4f center = camera.view_matrix * Vec4f(cmd.bounds.Center(), 1.0f);
+    float distance = Vec3f(center.x, center.y, center.z).Magnitude();
+    float radius = cmd.bounds.HalfSize().Magnitude();
+    if (distance <= radius)
+        return 0;
+    // projection_matrix[5] is 1 / tan(fovy / 2), the inverse of the half
+    // screen height at distance 1: radius over half height gives the
+    // diameter over the screen height
+    float screen_size = radius * camera.projection_matrix[5] / distance;
+    uint32_t lod = 0;
+    while (lod < cmd.mesh->lods.size() && screen_size < LOD_SCREEN_SIZES[lod])
+        lod++;
+    return lod;
+}
 
-    auto bucket = shader_to_bucket.FindBucket(shader_id);
+void BuildBatches() {
+    VERNA_PROFILE_FUNCTION();
+    const size_t n = submissions.size();
+    submission_locations.resize(n);
+    submission_fetched.assign(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        if (submission_visible[i] || caster_visible[i])
+            submission_fetched[i] =
+                mesh_pool.Fetch(*submissions[i].mesh, SelectLod(submissions[i]),
+                                submission_locations[i]);
+    }
+
+    // color pass: sorted to minimize state changes, front to back
+    const gpu::CameraData& camera = frame_data.camera_data;
+    const float inverse_depth = 1.0f / (camera.far - camera.near);
+    sort_items.clear();
+    for (size_t i = 0; i < n; i++) {
+        if (!submission_visible[i] || !submission_fetched[i])
+            continue;
+        const RenderQueue::Command& cmd = submissions[i];
+        Vec4f center = camera.view_matrix * Vec4f(cmd.bounds.Center(), 1.0f);
+        float depth = (center.z - camera.near) * inverse_depth;
+        uint64_t key =
+            SortKey::Make(SortKey::PASS_OPAQUE, cmd.shader, cmd.material,
+                          *cmd.mesh, submission_locations[i].lod, depth);
+        sort_items.push_back({key, static_cast<uint32_t>(i)});
+    }
+    RadixSort(sort_items, sort_scratch);
+    for (const SortItem& item : sort_items)
+        AddToBatch(submissions[item.index], submission_locations[item.index]);
+
+    // depth pass: no state to change, submission order
+    for (size_t i = 0; i < n; i++) {
+        if (caster_visible[i] && submission_fetched[i])
+            AddToShadowBatch(submissions[i], submission_locations[i]);
+    }
+}
 
-    BatchId last_batch_id;
+void AddToBatch(const RenderQueue::Command& cmd, const MeshLocation& location) {
+    auto bucket = shader_to_bucket.FindBucket(cmd.shader);
+    BatchId batch_id;
     if (shader_to_bucket.NotFound(bucket)) {
-        last_batch_id = NewBatchInNewBucket(shader_id);
+        batch_id = NewBatchInNewBucket(cmd.shader);
+        bucket = shader_to_bucket.FindBucket(cmd.shader);
     } else {
-        last_batch_id = bucket->back();
+        batch_id = bucket->back();
     }
-    RenderBatch* last_batch = &render_batches[last_batch_id];
-    if (!last_batch->CanContain(mesh)) {
-        last_batch_id = NewBatchInExistingBucket(*bucket);
-        last_batch = &render_batches[last_batch_id];
-    }
-    if (!last_batch->TryAddUniformData(material, model_matrix)) {
-        last_batch_id = NewBatchInExistingBucket(*bucket);
-        last_batch = &render_batches[last_batch_id];
-        [[maybe_unused]] bool added =
-            last_batch->TryAddUniformData(material, model_matrix);
-        VERNA_LOGE_IF(!added,
-                      "Renderer error: failed to material/transform data");
+    gpu::MeshData instance{};
+    if (bindless::IsSupported()) {
+        if (!render_batches[batch_id].CanContain(*cmd.mesh, location.lod))
+            batch_id = NewBatchInExistingBucket(*bucket);
+        AddBindlessMaterial(cmd.material, instance.material);
+    } else if (!render_batches[batch_id].CanContain(*cmd.mesh, location.lod)
+               || !render_batches[batch_id].TryAddMaterial(
+                   cmd.material, instance.material)) {
+        batch_id = NewBatchInExistingBucket(*bucket);
+        [[maybe_unused]] bool added = render_batches[batch_id].TryAddMaterial(
+            cmd.material, instance.material);
+        VERNA_LOGE_IF(!added, "Renderer error: failed to add material data");
     }
+    instance.model_matrix = cmd.model_matrix;
+    instance.transpose_inverse_model_matrix =
+        cmd.transpose_inverse_model_matrix;
+    render_batches[batch_id].AddInstance(*cmd.mesh, location, instance);
+}
 
-    RenderBatch& batch = *last_batch;
-    batch.vertices_count[batch.num_meshes] =
-        static_cast<int32_t>(mesh.vertices.size());
-    batch.indices_count[batch.num_meshes] = mesh.indices.size();
-    batch.vertices.insert(batch.vertices.end(), mesh.vertices.begin(),
-                          mesh.vertices.end());
-    batch.indices.insert(batch.indices.end(), mesh.indices.begin(),
-                         mesh.indices.end());
-    batch.num_meshes++;
+void AddToShadowBatch(const RenderQueue::Command& cmd,
+                      const MeshLocation& location) {
+    // the depth shader only reads matrices and material parameters
+    if (shadow_batches.Empty()
+        || !shadow_batches.Back().CanContain(*cmd.mesh, location.lod))
+        shadow_batches.Add();
+    gpu::MeshData instance{};
+    instance.material.parameters = cmd.material.parameters;
+    instance.model_matrix = cmd.model_matrix;
+    instance.transpose_inverse_model_matrix =
+        cmd.transpose_inverse_model_matrix;
+    shadow_batches.Back().AddInstance(*cmd.mesh, location, instance);
 }
 
 void Render(const Mesh& mesh,
             const Material& material,
             const Transform& transform,
             ShaderId shader_id) {
-    BoundingBox box = mesh.bounds;
-    box.ApplyTransform(transform);
-    if (render_bounds.Size().SquaredMagnitude() > 0.0f)
-        render_bounds.Encapsulate(box);
-    else
-        render_bounds = box;
-    Render(mesh, material, transform.GetMatrix(), shader_id);
+    VERNA_PROFILE_FUNCTION();
+    RenderQueue::Command cmd =
+        RenderQueue::Command::From(mesh, material, transform, shader_id);
+    EncapsulateRenderBounds(cmd.bounds);
+    Submit(cmd);
+}
+
+void Render(const RenderQueue& queue) {
+    VERNA_PROFILE_FUNCTION();
+    if (queue.Empty())
+        return;
+    EncapsulateRenderBounds(queue.Bounds());
+    submissions.reserve(submissions.size() + queue.Size());
+    submission_bounds.Reserve(submission_bounds.Size() + queue.Size());
+    for (const auto& cmd : queue.Commands())
+        Submit(cmd);
+}
+
+void EvictMesh(Mesh::id_type mesh_id) {
+    mesh_pool.Evict(mesh_id);
+    // the mesh may have been a shadow caster
+    shadow_map_dirty = true;
+}
+
+void SetShadowCaching(bool enabled) {
+    shadow_caching = enabled;
+    shadow_map_dirty = true;
+}
+
+void RenderOccluder(const Mesh& mesh, const Transform& transform) {
+    VERNA_LOGE_IF(mesh.vertices.empty() || mesh.indices.empty(),
+                  "Called RenderOccluder() on empty Mesh!");
+    occluders.push_back({&mesh, transform.GetMatrix()});
+}
+
+void SetOcclusionCulling(bool enabled) {
+    occlusion_culling = enabled;
 }
 
-void DrawGlCommand(const GlDrawCommand& cmd) {
+void DrawBatchIgnoreTextures(const RenderBatch& batch) {
+    if (batch.draws.empty())
+        return;
 #if defined(VERNA_ANDROID)
-    constexpr GLint draw_id_uniloc = 0;
-    for (size_t j = 0; j < cmd.drawcount; j++) {
-        glUniform1i(draw_id_uniloc, j);
-        glDrawElementsBaseVertex(GL_TRIANGLES, cmd.count[j], GL_UNSIGNED_INT,
-                                 cmd.indices[j], cmd.basevertex[j]);
+    // no multi draw nor base instance: one call per command, split when its
+    // instances don't fit in the uniform block at once
+    constexpr GLint base_instance_uniloc = 0;
+    constexpr uint32_t max_instances = gpu::DrawData::MAX_UNIFORM_INSTANCES;
+    const gpu::DrawCommand* cmd = commands_begin + batch.first_command;
+    for (size_t i = 0; i < batch.draws.size(); i++, cmd++) {
+        auto indices_offset =
+            static_cast<size_t>(cmd->first_index) * sizeof(Mesh::index_t);
+        uint32_t first = cmd->base_instance;
+        const uint32_t end = first + cmd->instance_count;
+        while (first < end) {
+            if (first < uniform_instances_begin
+                || std::min(end, first + max_instances)
+                       > uniform_instances_end)
+                SendUniformInstances(first);
+            uint32_t count = std::min(end, uniform_instances_end) - first;
+            glUniform1i(base_instance_uniloc,
+                        static_cast<GLint>(first - uniform_instances_begin));
+            frame_stats.draw_calls++;
+            glDrawElementsInstancedBaseVertex(
+                GL_TRIANGLES, static_cast<GLsizei>(cmd->count),
+                GL_UNSIGNED_INT,
+                reinterpret_cast<const GLvoid*>(indices_offset),
+                static_cast<GLsizei>(count), cmd->base_vertex);
+            first += count;
+        }
     }
 #elif defined(VERNA_DESKTOP)
-    glMultiDrawElementsBaseVertex(GL_TRIANGLES, cmd.count, GL_UNSIGNED_INT,
-                                  cmd.indices, cmd.drawcount, cmd.basevertex);
+    // commands_begin is an offset in the bound GL_DRAW_INDIRECT_BUFFER
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                commands_begin + batch.first_command,
+                                static_cast<GLsizei>(batch.draws.size()), 0);
+    frame_stats.multi_draw_calls++;
 #endif
 }
 
-void DrawBatchIgnoreTextures(const RenderBatch& batch) {
-    static std::array<const GLvoid*, RenderBatch::MAX_MESHES> indices_offsets;
-    static std::array<GLint, RenderBatch::MAX_MESHES> vertices_offsets;
-
-    SendDataToVbo(batch);
-    SendDataToEbo(batch);
-    ubo::SendData(gpu::DrawData::BLOCK_BINDING, &batch.draw_data);
+void SendDrawData() {
+    VERNA_PROFILE_FUNCTION();
+    size_t num_instances = 0;
+    size_t num_commands = 0;
+    for (const auto* batches : {&render_batches, &shadow_batches}) {
+        for (const RenderBatch& batch : *batches) {
+            num_instances += batch.instances.size();
+            num_commands += batch.draws.size();
+        }
+    }
+    frame_stats.instances = static_cast<uint32_t>(num_instances);
+    frame_stats.draw_commands = static_cast<uint32_t>(num_commands);
+#if defined(VERNA_DESKTOP)
+    frame_stats.streamed_bytes = static_cast<uint32_t>(
+        num_instances * sizeof(gpu::MeshData)
+        + num_commands * sizeof(gpu::DrawCommand));
+    auto* instances_out = static_cast<gpu::MeshData*>(
+        instance_ring.Map(num_instances * sizeof(gpu::MeshData)));
+    auto* commands_out = static_cast<gpu::DrawCommand*>(
+        command_ring.Map(num_commands * sizeof(gpu::DrawCommand)));
+#elif defined(VERNA_ANDROID)
+    // instances are counted in uniform_bytes when they're drawn
+    frame_instances.resize(num_instances);
+    gpu::MeshData* instances_out = frame_instances.data();
+    uniform_instances_begin = 0;
+    uniform_instances_end = 0;
+    frame_commands.resize(num_commands);
+    gpu::DrawCommand* commands_out = frame_commands.data();
+#endif
+    uint32_t first_instance = 0;
+    uint32_t first_command = 0;
+    for (auto* batches : {&render_batches, &shadow_batches}) {
+        for (RenderBatch& batch : *batches) {
+            batch.SortInstances(instances_out + first_instance,
+                                first_instance);
+            batch.first_command = first_command;
+            batch.WriteCommands(commands_out + first_command);
+            first_instance += static_cast<uint32_t>(batch.instances.size());
+            first_command += static_cast<uint32_t>(batch.draws.size());
+        }
+    }
+#if defined(VERNA_DESKTOP)
+    instance_ring.Unmap();
+    if (bindless::IsSupported()) {
+        const size_t bytes = frame_texture_handles.size() * sizeof(uint64_t);
+        frame_stats.streamed_bytes += static_cast<uint32_t>(bytes);
+        auto* handles_out = static_cast<uint64_t*>(texture_ring.Map(bytes));
+        std::copy(frame_texture_handles.begin(), frame_texture_handles.end(),
+                  handles_out);
+        texture_ring.Unmap();
+    }
+    command_ring.Unmap();
+    commands_begin =
+        reinterpret_cast<const gpu::DrawCommand*>(command_ring.Offset());
+#elif defined(VERNA_ANDROID)
+    commands_begin = frame_commands.data();
+#endif
+}
 
-    GlDrawCommand draw_command;
-    batch.GenerateOffsets(indices_offsets, vertices_offsets);
-    draw_command.basevertex = vertices_offsets.data();
-    draw_command.drawcount = batch.num_meshes;
-    draw_command.indices = indices_offsets.data();
-    draw_command.count = batch.indices_count.data();
-    DrawGlCommand(draw_command);
+#if defined(VERNA_ANDROID)
+void SendUniformInstances(uint32_t first) {
+    uniform_instances_begin = first;
+    uniform_instances_end =
+        std::min(first + gpu::DrawData::MAX_UNIFORM_INSTANCES,
+                 static_cast<uint32_t>(frame_instances.size()));
+    const size_t count = uniform_instances_end - uniform_instances_begin;
+    ubo::SendData(gpu::DrawData::BLOCK_BINDING, &frame_instances[first],
+                  count * sizeof(gpu::MeshData));
 }
+#endif
 
 void DrawBatch(const RenderBatch& batch) {
     BindTextures(batch);
@@ -506,35 +959,44 @@ void DrawBatch(const RenderBatch& batch) {
 }
 
 void Draw() {
+    VERNA_PROFILE_FUNCTION();
     if (native_window == nullptr) {
         VERNA_LOGE(
             "Called Draw() before Renderer could access current context!");
         return;
     }
+    frame_stats = RendererStats();
+    DrawSubmissions();
+    FinishStats();
+}
+
+void DrawSubmissions() {
 #ifndef NDEBUG
     [[maybe_unused]] GLenum glerr;
     while ((glerr = glGetError()) != GL_NO_ERROR)
-        VERNA_LOGE("Caught OpenGL error in Draw(): " + std::to_string(glerr));
+        VERNA_LOGE("Caught OpenGL error in Draw(): ", glerr);
 #endif
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    if (shader_to_bucket.Empty()) {
+    if (submissions.empty()) {
 #ifdef VERNA_WARN_EMPTY_SCENE
         VERNA_LOGW("Nothing to draw!");
 #endif
+        culling_stats = CullingStats();
         return;
     }
-    VERNA_LOGE_IF(render_batches.empty(),
-                  "There are render buckets but no render batches!");
 
     PrepareDraw();
-    DepthPass();
+    BuildBatches();
+    SendDrawData();
+    if (!shadow_map_reused)
+        DepthPass();
 
-    ShaderId shader;
-    Bucket bucket;
+    VERNA_PROFILE_SCOPE("ColorPass");
+    VERNA_PROFILE_GPU_SCOPE("ColorPass");
     for (size_t i = 0; i < shader_to_bucket.Size(); i++) {
-        shader_to_bucket.Get(i, shader, bucket);
-        glUseProgram(shader.id);
-        for (BatchId batch_id : bucket) {
+        glUseProgram(shader_to_bucket.GetShader(i).id);
+        frame_stats.program_binds++;
+        for (BatchId batch_id : shader_to_bucket.GetBucket(i)) {
             const RenderBatch& batch = render_batches[batch_id];
             DrawBatch(batch);
         }
@@ -542,9 +1004,18 @@ void Draw() {
 }
 
 void NextFrame() {
+    VERNA_PROFILE_FUNCTION();
+#if defined(VERNA_DESKTOP)
+    instance_ring.NextFrame();
+    command_ring.NextFrame();
+    if (bindless::IsSupported())
+        texture_ring.NextFrame();
+#endif
     SwapBuffers();
+    gpu_profiler::NextFrame();
     ClearBatches();
     ResetRenderBounds();
+    mesh_pool.NextFrame();
 }
 
 void Render(const BoundingBox& box) {
@@ -553,8 +1024,7 @@ void Render(const BoundingBox& box) {
     t.scale = box.Size();
     Material mat;
     mat.SetCastsShadow(false);
-    Mesh cube = LoadPrimitiveMesh(PrimitiveMeshType::Cube);
-    Render(cube, mat, t, wireframe_shader);
+    Render(wireframe_cube, mat, t, wireframe_shader);
 }
 
 void Render(const BoundingSphere& sphere) {
@@ -563,14 +1033,78 @@ void Render(const BoundingSphere& sphere) {
     t.scale = Vec3f(sphere.Radius());
     Material mat;
     mat.SetCastsShadow(false);
-    Mesh mesh = LoadPrimitiveMesh(PrimitiveMeshType::Sphere);
-    Render(mesh, mat, t, wireframe_shader);
+    Render(wireframe_sphere, mat, t, wireframe_shader);
+}
+
+CullingStats GetCullingStats() {
+    CullingStats stats = culling_stats;
+    stats.shadow_map_reused = shadow_map_reused;
+    return stats;
+}
+
+void FinishStats() {
+    frame_stats.culling = GetCullingStats();
+    frame_stats.buckets = static_cast<uint32_t>(shader_to_bucket.Size());
+    frame_stats.batches = static_cast<uint32_t>(render_batches.Size());
+    frame_stats.shadow_batches = static_cast<uint32_t>(shadow_batches.Size());
+    for (size_t i = 0; i < shader_to_bucket.Size(); i++) {
+        auto size = static_cast<uint32_t>(shader_to_bucket.GetBucket(i).size());
+        frame_stats.max_bucket_batches =
+            std::max(frame_stats.max_bucket_batches, size);
+    }
+    MeshPool::Stats pool_stats = mesh_pool.TakeStats();
+    frame_stats.vertices_uploaded = pool_stats.vertices_uploaded;
+    frame_stats.indices_uploaded = pool_stats.indices_uploaded;
+    frame_stats.mesh_buffer_growths = pool_stats.growths;
+    frame_stats.uniform_bytes = static_cast<uint32_t>(ubo::TakeBytesSent());
+#if defined(VERNA_DESKTOP)
+    frame_stats.storage_growths = instance_ring.TakeGrowths()
+                                  + command_ring.TakeGrowths()
+                                  + texture_ring.TakeGrowths();
+#endif
+
+    if (stats_history_size == 0)
+        return;
+    if (stats_history.size() < stats_history_size) {
+        stats_history.push_back(frame_stats);
+        return;
+    }
+    stats_history[stats_history_next] = frame_stats;
+    stats_history_next = (stats_history_next + 1) % stats_history_size;
+}
+
+RendererStats GetRendererStats() {
+    return frame_stats;
+}
+
+void SetRendererStatsHistory(size_t frames) {
+    stats_history_size = frames;
+    stats_history_next = 0;
+    stats_history.clear();
+    stats_history.reserve(frames);
+}
+
+std::vector<RendererStats> GetRendererStatsHistory() {
+    std::vector<RendererStats> history;
+    history.reserve(stats_history.size());
+    history.insert(history.end(), stats_history.begin() + stats_history_next,
+                   stats_history.end());
+    history.insert(history.end(), stats_history.begin(),
+                   stats_history.begin() + stats_history_next);
+    return history;
 }
 
 void ResetRenderBounds() {
     render_bounds = BoundingBox();
 }
 
+void EncapsulateRenderBounds(const BoundingBox& box) {
+    if (render_bounds.Size().SquaredMagnitude() > 0.0f)
+        render_bounds.Encapsulate(box);
+    else
+        render_bounds = box;
+}
+
 namespace RendererInfo {
 int MaxTextureUnits() {
     static GLint max_frag_tus = [] {
@@ -15,7 +15,7 @@ class ResourceTracker {
         resource_name(resource_name_) {}
     ~ResourceTracker() {
         for (ID_TYPE id : loaded_ids) {
-            VERNA_LOGE(resource_name + " not freed! ID: " + std::to_string(id));
+            VERNA_LOGE(resource_name, " not freed! ID: ", id);
         }
     }
     void Push(ID_TYPE id) { loaded_ids.push_back(id); }
@@ -1,6 +1,7 @@
 #include <viverna/core/Scene.hpp>
 #include <viverna/core/Assets.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
 #include <viverna/serialization/SceneSerializer.hpp>
 
 #include <fstream>
@@ -21,6 +22,7 @@ bool Scene::LoadFile(const std::filesystem::path& scene_file) {
 
 bool Scene::LoadFile(const std::filesystem::path& scene_file,
                      std::vector<Entity>& out_entities) {
+    VERNA_PROFILE_FUNCTION();
     ReleaseResources();
     world.ClearData();
     const std::filesystem::path folder = "scenes";
@@ -28,7 +30,7 @@ bool Scene::LoadFile(const std::filesystem::path& scene_file,
     if (!ValidFileName(name))
         name += ".viv";
     auto path = folder / name;
-    VERNA_LOGI("Loading " + path.string());
+    VERNA_LOGI("Loading ", path.string());
     auto raw = LoadRawAsset(path);
     auto yaml_string = std::string(raw.data(), raw.size());
     YAML::Node node = YAML::Load(yaml_string);
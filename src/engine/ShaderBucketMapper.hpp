@@ -21,36 +21,43 @@ class ShaderBucketMapper {
     Bucket& NewBucket(ShaderId shader);
     size_t Size() const;
     bool Empty() const;
-    void Get(size_t index, ShaderId& shader, Bucket& bucket) const;
+    ShaderId GetShader(size_t index) const;
+    const Bucket& GetBucket(size_t index) const;
     void Clear();
 
    private:
     std::vector<ShaderId> shaders;
+    // Buckets after shaders.size() are left from previous frames and get
+    // reused by NewBucket(), keeping their capacity
     std::vector<Bucket> buckets;
 };
 
+// Searches from the most recent bucket: sorted submissions always hit it
 inline std::vector<Bucket>::iterator ShaderBucketMapper::FindBucket(
     ShaderId shader) {
-    for (size_t i = 0; i < shaders.size(); i++)
+    for (size_t i = shaders.size(); i-- > 0;)
         if (shaders[i] == shader)
             return buckets.begin() + i;
-    return buckets.end();
+    return buckets.begin() + shaders.size();
 }
 inline std::vector<Bucket>::const_iterator ShaderBucketMapper::FindBucket(
     ShaderId shader) const {
-    for (size_t i = 0; i < shaders.size(); i++)
+    for (size_t i = shaders.size(); i-- > 0;)
         if (shaders[i] == shader)
             return buckets.begin() + i;
-    return buckets.end();
+    return buckets.begin() + shaders.size();
 }
 inline bool ShaderBucketMapper::NotFound(
     std::vector<Bucket>::iterator it) const {
-    return it == buckets.end();
+    return it == buckets.begin() + shaders.size();
 }
 inline Bucket& ShaderBucketMapper::NewBucket(ShaderId shader) {
+    size_t index = shaders.size();
     shaders.push_back(shader);
-    buckets.push_back(Bucket());
-    return buckets.back();
+    if (index == buckets.size())
+        return buckets.emplace_back();
+    buckets[index].clear();
+    return buckets[index];
 }
 inline size_t ShaderBucketMapper::Size() const {
     return shaders.size();
@@ -58,16 +65,16 @@ inline size_t ShaderBucketMapper::Size() const {
 inline bool ShaderBucketMapper::Empty() const {
     return Size() == 0;
 }
-inline void ShaderBucketMapper::Get(size_t index,
-                                    ShaderId& shader,
-                                    Bucket& bucket) const {
+inline ShaderId ShaderBucketMapper::GetShader(size_t index) const {
     VERNA_ASSERT(index < Size());
-    shader = shaders[index];
-    bucket = buckets[index];
+    return shaders[index];
+}
+inline const Bucket& ShaderBucketMapper::GetBucket(size_t index) const {
+    VERNA_ASSERT(index < Size());
+    return buckets[index];
 }
 inline void ShaderBucketMapper::Clear() {
     shaders.clear();
-    buckets.clear();
 }
 }  // namespace verna
 
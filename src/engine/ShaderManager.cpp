@@ -1,11 +1,15 @@
 #include <viverna/graphics/ShaderManager.hpp>
 #include <viverna/core/Assets.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
 #include <viverna/graphics/gpu/DrawData.hpp>
 #include <viverna/graphics/gpu/FrameData.hpp>
 #include <viverna/graphics/Renderer.hpp>
+#include "BindlessTextures.hpp"
 
-#if defined(VERNA_DESKTOP)
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
 #include <glad/gl.h>
 #elif defined(VERNA_ANDROID)
 #include <GLES3/gl32.h>
@@ -33,11 +37,11 @@ static ShaderId MakeProgramFromSource(
 
 ShaderManager::~ShaderManager() {
     for (size_t i = 0; i < shaders.size(); i++)
-        VERNA_LOGE("Shader not freed: " + names[i] + " ("
-                   + std::to_string(shaders[i].id) + ')');
+        VERNA_LOGE("Shader not freed: ", names[i], " (", shaders[i].id, ')');
 }
 
 ShaderId ShaderManager::LoadShader(std::string_view shader_name) {
+    VERNA_PROFILE_FUNCTION();
     for (size_t i = 0; i < names.size(); i++)
         if (names[i] == shader_name)
             return shaders[i];
@@ -52,24 +56,24 @@ ShaderId ShaderManager::LoadShader(std::string_view shader_name) {
     shader_types.reserve(3);
 
     if (!AssetExists(vertex_path)) {
-        VERNA_LOGE("LoadShader failed: can't find " + vertex_path.string());
+        VERNA_LOGE("LoadShader failed: can't find ", vertex_path.string());
         return ShaderId();
     }
     if (!AssetExists(fragment_path)) {
-        VERNA_LOGE("LoadShader failed: can't find " + fragment_path.string());
+        VERNA_LOGE("LoadShader failed: can't find ", fragment_path.string());
         return ShaderId();
     }
 
     auto vertex_raw = LoadRawAsset(vertex_path);
     if (vertex_raw.empty()) {
-        VERNA_LOGE("LoadShader failed: can't load " + vertex_path.string());
+        VERNA_LOGE("LoadShader failed: can't load ", vertex_path.string());
         return ShaderId();
     }
     sources.push_back(std::string_view(vertex_raw.data(), vertex_raw.size()));
     shader_types.push_back(GL_VERTEX_SHADER);
     auto fragment_raw = LoadRawAsset(fragment_path);
     if (fragment_raw.empty()) {
-        VERNA_LOGE("LoadShader failed: can't load " + fragment_path.string());
+        VERNA_LOGE("LoadShader failed: can't load ", fragment_path.string());
         return ShaderId();
     }
     sources.push_back(
@@ -80,8 +84,8 @@ ShaderId ShaderManager::LoadShader(std::string_view shader_name) {
     if (AssetExists(geometry_path)) {
         geometry_raw = LoadRawAsset(geometry_path);
         if (geometry_raw.empty()) {
-            VERNA_LOGW(geometry_path.string()
-                       + " found, but empty (or failed to load)");
+            VERNA_LOGW(geometry_path.string(),
+                       " found, but empty (or failed to load)");
         } else {
             sources.push_back(
                 std::string_view(geometry_raw.data(), geometry_raw.size()));
@@ -136,8 +140,7 @@ void ShaderManager::FreeShader(ShaderId shader_program) {
             return;
         }
     }
-    VERNA_LOGI("Called FreeShader on missing shader: "
-               + std::to_string(shader_program.id));
+    VERNA_LOGI("Called FreeShader on missing shader: ", shader_program.id);
 }
 
 void ShaderManager::FreeLoadedShaders() {
@@ -159,23 +162,37 @@ std::string ShaderManager::GetShaderName(ShaderId shader_program) const {
 
 std::string ShaderPreface() {
     std::string max_meshes = std::to_string(gpu::DrawData::MAX_MESHES);
+    std::string max_uniform_instances =
+        std::to_string(gpu::DrawData::MAX_UNIFORM_INSTANCES);
+    std::string draw_data_binding =
+        std::to_string(gpu::DrawData::BLOCK_BINDING);
+    std::string texture_table_binding =
+        std::to_string(gpu::DrawData::TEXTURE_TABLE_BINDING);
     std::string max_material_textures =
         std::to_string(RendererInfo::MaxMaterialTextures());
     auto common_glsl_raw = LoadRawAsset("shaders/common.glsl");
     std::string common_glsl(common_glsl_raw.data(), common_glsl_raw.size());
-    return
+    std::string version =
 #if defined(VERNA_DESKTOP)
-        "#version 460 core\n"
-        "#define VERNA_DESKTOP 1\n\n"
+        "#version 460 core\n";
+    // extensions must precede any other code
+    if (bindless::IsSupported())
+        version +=
+            "#extension GL_ARB_bindless_texture : require\n"
+            "#define VERNA_BINDLESS 1\n";
+    version += "#define VERNA_DESKTOP 1\n\n";
 #elif defined(VERNA_ANDROID)
         "#version 320 es\n"
-        "#define VERNA_ANDROID 1\n\n"
+        "#define VERNA_ANDROID 1\n\n";
 #else
 #error Platform not supported!
 #endif
-        "#define MAX_MESHES "
-        + max_meshes + "\n#define MAX_MATERIAL_TEXTURES "
-        + max_material_textures + "\n\n" + common_glsl + "\n\n";
+    return version + "#define MAX_MESHES " + max_meshes
+           + "\n#define MAX_UNIFORM_INSTANCES " + max_uniform_instances
+           + "\n#define DRAW_DATA_BINDING " + draw_data_binding
+           + "\n#define TEXTURE_TABLE_BINDING " + texture_table_binding
+           + "\n#define MAX_MATERIAL_TEXTURES " + max_material_textures
+           + "\n\n" + common_glsl + "\n\n";
 }
 
 std::string ShaderCommonCode(GLenum shader_type) {
@@ -197,7 +214,7 @@ std::string ShaderCommonCode(GLenum shader_type) {
     auto path = std::filesystem::path(temp_path).make_preferred();
     auto common_code_raw = LoadRawAsset(path);
     if (common_code_raw.empty()) {
-        VERNA_LOGE("ShaderCommonCode failed: can't load " + path.string());
+        VERNA_LOGE("ShaderCommonCode failed: can't load ", path.string());
         return std::string();
     }
     return std::string(common_code_raw.data(), common_code_raw.size());
@@ -219,7 +236,7 @@ bool CompileShaderSources(const std::vector<std::string_view>& sources,
 #ifdef VERNA_PRINT_SHADER_COMMON_CODE
         static bool printed = false;
         if (!printed) {
-            VERNA_LOGI(gl_sources[0] + gl_sources[1]);
+            VERNA_LOGI(gl_sources[0], gl_sources[1]);
             printed = true;
         }
 #endif
@@ -256,8 +273,8 @@ bool CompileShaderSources(const std::vector<std::string_view>& sources,
                 shader_type_str = "Unsupported";
                 break;
         }
-        VERNA_LOGE(shader_type_str + " shader compilation failed: "
-                   + std::string(log.data(), loglen));
+        VERNA_LOGE(shader_type_str, " shader compilation failed: ",
+                   std::string_view(log.data(), loglen));
         return false;
     }
     return true;
@@ -275,8 +292,8 @@ bool LinkShaders(const std::vector<GLuint>& shaders, GLuint& output_program) {
     if (success == GL_TRUE)
         return true;
     glGetProgramInfoLog(output_program, log.size(), &loglen, log.data());
-    VERNA_LOGE("Shader program linking failed: "
-               + std::string(log.data(), loglen));
+    VERNA_LOGE("Shader program linking failed: ",
+               std::string_view(log.data(), loglen));
     glDeleteProgram(output_program);
     return false;
 }
@@ -286,8 +303,6 @@ void UniformInit(GLuint program) {
     GLuint block_loc =
         glGetUniformBlockIndex(program, gpu::FrameData::BLOCK_NAME);
     glUniformBlockBinding(program, block_loc, gpu::FrameData::BLOCK_BINDING);
-    block_loc = glGetUniformBlockIndex(program, gpu::DrawData::BLOCK_NAME);
-    glUniformBlockBinding(program, block_loc, gpu::DrawData::BLOCK_BINDING);
 
     GLint textures_loc = glGetUniformLocation(program, "material_textures[0]");
     std::vector<GLint> texture_slots;
@@ -355,8 +370,7 @@ void CheckForGLErrors(std::string_view origin) {
                 error_string = std::to_string(glerr);
                 break;
         }
-        VERNA_LOGE(std::string(origin)
-                   + " detected OpenGL error: " + error_string);
+        VERNA_LOGE(origin, " detected OpenGL error: ", error_string);
     }
 }
 
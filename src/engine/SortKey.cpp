@@ -0,0 +1,65 @@
+#include "SortKey.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace verna {
+
+static_assert(Mesh::MAX_LODS <= 4, "SortKey has 2 bits for the lod");
+
+uint64_t SortKey::Make(Pass pass,
+                       ShaderId shader,
+                       const Material& material,
+                       const Mesh& mesh,
+                       uint32_t lod,
+                       float depth) {
+    // FNV-1a of the texture ids: equal sets get equal hashes
+    uint32_t texture_hash = 2166136261u;
+    for (TextureId texture : material.textures) {
+        texture_hash ^= texture.id;
+        texture_hash *= 16777619u;
+    }
+    texture_hash ^= texture_hash >> 16;
+
+    constexpr float MAX_DEPTH = 65535.0f;
+    auto quantized_depth = static_cast<uint64_t>(
+        std::clamp(depth, 0.0f, 1.0f) * MAX_DEPTH);
+
+    return (static_cast<uint64_t>(pass) << 62)
+           | (static_cast<uint64_t>(shader.id & 0x3FFFu) << 48)
+           | (static_cast<uint64_t>(texture_hash & 0xFFFFu) << 32)
+           | (static_cast<uint64_t>(mesh.id & 0x3FFFu) << 18)
+           | (static_cast<uint64_t>(lod & 0x3u) << 16)
+           | quantized_depth;
+}
+
+void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch) {
+    if (items.empty())
+        return;
+    constexpr size_t RADIX = 256;
+    constexpr size_t PASSES = sizeof(uint64_t);
+    // histograms of every pass in a single read of the keys
+    std::array<std::array<uint32_t, RADIX>, PASSES> counts{};
+    for (const SortItem& item : items)
+        for (size_t pass = 0; pass < PASSES; pass++)
+            counts[pass][(item.key >> (8 * pass)) & 0xFF]++;
+
+    scratch.resize(items.size());
+    for (size_t pass = 0; pass < PASSES; pass++) {
+        std::array<uint32_t, RADIX>& count = counts[pass];
+        const uint8_t first_byte = (items.front().key >> (8 * pass)) & 0xFF;
+        if (count[first_byte] == items.size())
+            continue;
+        uint32_t offset = 0;
+        for (uint32_t& c : count) {
+            uint32_t n = c;
+            c = offset;
+            offset += n;
+        }
+        for (const SortItem& item : items)
+            scratch[count[(item.key >> (8 * pass)) & 0xFF]++] = item;
+        items.swap(scratch);
+    }
+}
+
+}  // namespace verna
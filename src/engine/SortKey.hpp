@@ -0,0 +1,57 @@
+#ifndef VERNA_SORT_KEY_HPP
+#define VERNA_SORT_KEY_HPP
+
+#include <viverna/graphics/Material.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/graphics/Shader.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace verna {
+
+// 64-bit draw ordering key, most significant fields first:
+// | pass (2) | shader (14) | texture set (16) | mesh (14) | lod (2) |
+// | depth (16) |
+// so that sorting by key minimizes program and texture binds, keeps equal
+// meshes (and levels of detail) together and draws front to back
+struct SortKey {
+    enum Pass : uint64_t { PASS_OPAQUE = 0 };
+
+    /**
+     * @brief Builds the key of a draw
+     *
+     * @param pass The render pass
+     * @param shader The shader program
+     * @param material Its textures select the texture set
+     * @param mesh The mesh drawn
+     * @param lod Level of detail of the mesh
+     * @param depth Normalized view distance in [0, 1], clamped
+     * @return The key
+     */
+    static uint64_t Make(Pass pass,
+                         ShaderId shader,
+                         const Material& material,
+                         const Mesh& mesh,
+                         uint32_t lod,
+                         float depth);
+};
+
+struct SortItem {
+    uint64_t key;
+    // index of the sorted element
+    uint32_t index;
+};
+
+/**
+ * @brief Stable LSD radix sort on SortItem::key, one byte per pass. Passes
+ * where every key has the same byte are skipped
+ *
+ * @param items Items to sort
+ * @param scratch Temporary storage, resized to items.size()
+ */
+void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+
+}  // namespace verna
+
+#endif
@@ -0,0 +1,130 @@
+#include "StorageRing.hpp"
+
+#if defined(VERNA_DESKTOP)
+#include <viverna/core/Debug.hpp>
+
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#else
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#endif
+
+#include <algorithm>
+
+namespace verna {
+
+namespace {
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+void StorageRing::Initialize(uint32_t target_,
+                             uint32_t binding_point,
+                             size_t region_size_) {
+    target = target_;
+    binding = binding_point;
+    glGenBuffers(1, &buffer);
+    GLint offset_alignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offset_alignment);
+    alignment = std::max(static_cast<size_t>(std::max(offset_alignment, 1)),
+                         MIN_ALIGNMENT);
+    current = 0;
+    written = false;
+    Allocate(region_size_);
+}
+
+uint32_t StorageRing::TakeGrowths() {
+    uint32_t taken = growths;
+    growths = 0;
+    return taken;
+}
+
+void StorageRing::Terminate() {
+    for (uint32_t i = 0; i < NUM_REGIONS; i++)
+        WaitRegion(i);
+    if (mapped != nullptr) {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+        mapped = nullptr;
+    }
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    region_size = 0;
+}
+
+void StorageRing::Allocate(size_t region_size_) {
+    region_size = AlignUp(region_size_, alignment);
+    if (mapped != nullptr) {
+        // buffer storage is immutable: a bigger ring needs a new buffer
+        for (uint32_t i = 0; i < NUM_REGIONS; i++)
+            WaitRegion(i);
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+        glDeleteBuffers(1, &buffer);
+        glGenBuffers(1, &buffer);
+    }
+    constexpr GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto total = static_cast<GLsizeiptr>(region_size * NUM_REGIONS);
+    glBindBuffer(target, buffer);
+    glBufferStorage(target, total, nullptr, flags);
+    mapped = static_cast<std::byte*>(
+        glMapBufferRange(target, 0, total, flags));
+    VERNA_LOGE_IF(mapped == nullptr, "Failed to map StorageRing buffer!");
+}
+
+void StorageRing::WaitRegion(uint32_t region) {
+    auto fence = static_cast<GLsync>(fences[region]);
+    if (fence == nullptr)
+        return;
+    constexpr GLuint64 TIMEOUT_NS = 1000000000;
+    GLenum result;
+    do {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT_NS);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    VERNA_LOGE_IF(result == GL_WAIT_FAILED, "glClientWaitSync failed!");
+    glDeleteSync(fence);
+    fences[region] = nullptr;
+}
+
+void* StorageRing::Map(size_t bytes) {
+    if (bytes > region_size) {
+        Allocate(std::max(bytes, region_size * 3 / 2));
+        growths++;
+        VERNA_LOGI("StorageRing grown to ", region_size, " bytes per frame");
+    }
+    WaitRegion(current);
+    mapped_bytes = bytes;
+    written = true;
+    return mapped + Offset();
+}
+
+void StorageRing::Unmap() {
+    if (mapped_bytes == 0)
+        return;
+    // coherent mapping: no flush needed, the range just has to be bound
+    if (target == GL_SHADER_STORAGE_BUFFER)
+        glBindBufferRange(target, binding, buffer,
+                          static_cast<GLintptr>(Offset()),
+                          static_cast<GLsizeiptr>(mapped_bytes));
+    else
+        glBindBuffer(target, buffer);
+}
+
+size_t StorageRing::Offset() const {
+    return current * region_size;
+}
+
+void StorageRing::NextFrame() {
+    if (!written)
+        return;
+    fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    current = (current + 1) % NUM_REGIONS;
+    written = false;
+}
+
+}  // namespace verna
+
+#endif
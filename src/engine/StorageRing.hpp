@@ -0,0 +1,64 @@
+#ifndef VERNA_STORAGE_RING_HPP
+#define VERNA_STORAGE_RING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Desktop only: OpenGL ES has no persistent mapping, and Android sends its
+// per-instance data through the uniform buffer (see UniformBuffer.hpp)
+#if defined(VERNA_DESKTOP)
+
+namespace verna {
+
+// GPU buffer (shader storage or draw indirect) rewritten every frame.
+// It's persistently mapped and split into NUM_REGIONS regions, one per
+// frame in flight: the CPU writes straight into the region of the current
+// frame while the GPU still reads the previous ones, and a fence per region
+// makes sure it's never overwritten too early
+class StorageRing {
+   public:
+    static constexpr uint32_t NUM_REGIONS = 3;
+
+    // binding_point is only used by indexed targets (shader storage)
+    void Initialize(uint32_t target_,
+                    uint32_t binding_point,
+                    size_t region_size);
+    void Terminate();
+    // Returns at least bytes of writable memory for the current frame
+    void* Map(size_t bytes);
+    // Binds the memory returned by Map() to the target
+    void Unmap();
+    // Offset of the memory returned by Map() in the bound buffer
+    size_t Offset() const;
+    // Call after the last draw call reading the current frame
+    void NextFrame();
+    // Times the buffer had to grow since the last call
+    uint32_t TakeGrowths();
+
+   private:
+    void Allocate(size_t region_size_);
+    void WaitRegion(uint32_t region);
+
+    // the memory returned by Map() may hold 16 byte aligned matrices
+    static constexpr size_t MIN_ALIGNMENT = 16;
+
+    uint32_t buffer = 0;
+    uint32_t target = 0;
+    uint32_t binding = 0;
+    size_t region_size = 0;
+    size_t mapped_bytes = 0;
+    uint32_t growths = 0;
+    size_t alignment = 1;
+    std::byte* mapped = nullptr;
+    // GLsync of every region, nullptr if not in use
+    std::array<void*, NUM_REGIONS> fences{};
+    uint32_t current = 0;
+    bool written = false;
+};
+
+}  // namespace verna
+
+#endif
+
+#endif
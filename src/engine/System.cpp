@@ -1,6 +1,6 @@
 #include <viverna/ecs/System.hpp>
 
-#include <set>
+#include <algorithm>
 #include <utility>
 
 namespace verna {
@@ -25,6 +25,9 @@ void System::Notify(EntityEvent event) {
 
 void System::ReassignEntities(std::vector<Entity>&& new_entities) {
     entities = std::move(new_entities);
+    membership.Clear();
+    for (Entity e : entities)
+        membership.Add(e.id);
 }
 
 void System::Run(World& world) {
@@ -36,32 +39,55 @@ bool System::operator==(const System& other) const {
     return id == other.id;
 }
 
+bool System::ConflictsWith(const System& other) const {
+    if (!declared_access || !other.declared_access)
+        return true;
+    auto overlaps = [](const std::vector<TypeId>& a,
+                       const std::vector<TypeId>& b) {
+        return std::find_first_of(a.begin(), a.end(), b.begin(), b.end())
+               != a.end();
+    };
+    return overlaps(writes, other.writes) || overlaps(writes, other.reads)
+           || overlaps(reads, other.writes);
+}
+
 void System::ResolveEvents() {
-    if (entity_queue.empty())
-        return;
-    std::set<Entity> all;
-    for (size_t i = 0; i < entities.size(); i++)
-        all.insert(entities[i]);
-    std::vector<Entity> remove;
-    remove.reserve(entity_queue.size());
-    for (size_t i = 0; i < entity_queue.size(); i++) {
-        switch (entity_queue[i].event) {
+    for (const EntityEvent& ev : entity_queue) {
+        switch (ev.event) {
             case EntityEvent::ADD:
-                all.insert(entity_queue[i].entity);
+                AddEntity(ev.entity);
                 break;
             case EntityEvent::REMOVE:
-                remove.push_back(entity_queue[i].entity);
+                RemoveEntity(ev.entity);
                 break;
             case EntityEvent::CLEAR_DATA:
-                all.clear();
-                remove.clear();
+                entities.clear();
+                membership.Clear();
                 break;
         }
     }
-    for (size_t i = 0; i < remove.size(); i++)
-        all.erase(remove[i]);
-    ReassignEntities(std::vector(all.begin(), all.end()));
+    // keeps capacity: no allocations once the queue has grown
     entity_queue.clear();
 }
 
+void System::AddEntity(Entity e) {
+    SparseSet<EntityId>::index_t i;
+    if (membership.GetIndex(e.id, i)) {
+        // same id, possibly a newer generation
+        entities[i] = e;
+        return;
+    }
+    membership.Add(e.id);
+    entities.push_back(e);
+}
+
+void System::RemoveEntity(Entity e) {
+    SparseSet<EntityId>::index_t i;
+    if (!membership.GetIndex(e.id, i) || entities[i] != e)
+        return;
+    membership.Remove(e.id);
+    entities[i] = entities.back();
+    entities.pop_back();
+}
+
 }  // namespace verna
@@ -1,7 +1,11 @@
 #include <viverna/graphics/TextureManager.hpp>
 #include <viverna/core/Debug.hpp>
+#include <viverna/core/Profiler.hpp>
+#include "BindlessTextures.hpp"
 
-#if defined(VERNA_DESKTOP)
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
 #include <glad/gl.h>
 #elif defined(VERNA_ANDROID)
 #include <GLES3/gl32.h>
@@ -31,16 +35,16 @@ TextureManager::~TextureManager() {
                        + ", " + std::to_string(static_cast<unsigned>(col.alpha))
                        + ']';
             }
-            VERNA_LOGE("Texture not freed: " + name + " ("
-                       + std::to_string(tex.id) + ')');
+            VERNA_LOGE("Texture not freed: ", name, " (", tex.id, ')');
         }
     }
 }
 
 TextureId TextureManager::LoadTexture(const std::filesystem::path& texture_path,
                                       TextureLoadConfig config) {
+    VERNA_PROFILE_FUNCTION();
     std::string name = texture_path.string();
-    VERNA_LOGI("Loading texture " + name + "...");
+    VERNA_LOGI("Loading texture ", name, "...");
     const auto& ids = mapper.GetDense();
     for (size_t i = 0; i < ids.size(); i++)
         if (mapper.Contains(ids[i]) && name == names[i])
@@ -50,15 +54,15 @@ TextureId TextureManager::LoadTexture(const std::filesystem::path& texture_path,
     std::filesystem::path fullpath = "textures" / texture_path;
     Image img = Image::Load(fullpath);
     if (!img.IsValid()) {
-        VERNA_LOGE("Image::Load failed: " + fullpath.string());
+        VERNA_LOGE("Image::Load failed: ", fullpath.string());
         return result;
     }
     result = LoadTextureFromImage(img);
     if (!result.IsValid()) {
-        VERNA_LOGE("LoadTextureFromImage failed: " + fullpath.string());
+        VERNA_LOGE("LoadTextureFromImage failed: ", fullpath.string());
         return result;
     }
-    VERNA_LOGI(name + " successfully loaded!");
+    VERNA_LOGI(name, " successfully loaded!");
     if (config.flags & TextureLoadConfig::KeepInCpuMemory)
         images.back() = std::move(img);
     names.back() = std::move(name);
@@ -123,10 +127,10 @@ void TextureManager::FreeTexture(TextureId texture) {
     if (mapper.GetIndex(texture.id, index)) {
         auto id_string = std::to_string(texture.id);
         RemoveElement(texture.id);
+        bindless::Unregister(texture);
         glDeleteTextures(1, &texture.id);
     } else {
-        VERNA_LOGI("Called FreeTexture on missing texture: "
-                   + std::to_string(texture.id));
+        VERNA_LOGI("Called FreeTexture on missing texture: ", texture.id);
     }
 }
 
@@ -140,8 +144,11 @@ void TextureManager::FreeLoadedTextures() {
         }
     }
     std::vector to_free(to_free_set.begin(), to_free_set.end());
+    for (TextureId::id_type t : to_free)
+        bindless::Unregister(TextureId(t));
     glDeleteTextures(to_free.size(), to_free.data());
     mapper.Clear();
+    mapper.ShrinkToFit();
     names.clear();
     images.clear();
 }
@@ -195,10 +202,14 @@ void TextureManager::AddElement(TextureId::id_type id) {
 void TextureManager::RemoveElement(TextureId::id_type id) {
     SparseSet<TextureId::id_type>::index_t index;
     if (mapper.GetIndex(id, index)) {
+        // mirror SparseSet's swap-and-pop
         mapper.Remove(id);
-        names[index].clear();
-        names[index].shrink_to_fit();
-        images[index].Clear();
+        if (index + 1 != names.size()) {
+            names[index] = std::move(names.back());
+            images[index] = std::move(images.back());
+        }
+        names.pop_back();
+        images.pop_back();
     }
 }
 
@@ -222,6 +233,7 @@ TextureId GenTextureFromBuffer(const void* buffer, int width, int height) {
     glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA,
                     GL_UNSIGNED_BYTE, buffer);
+    bindless::Register(result);
 
     return result;
 }
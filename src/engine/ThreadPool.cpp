@@ -1,48 +1,247 @@
 #include <viverna/core/ThreadPool.hpp>
+#include <viverna/core/Profiler.hpp>
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
-#include <functional>
-#include <queue>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 namespace verna {
 
-void ThreadPool::ThreadFunction() {
-    std::function<void()> task;
-    while (true) {
-        {
-            std::unique_lock lock(tasks_mtx);
-            condition.wait(lock, [this] { return stop || !tasks.empty(); });
-            if (stop && tasks.empty())
-                return;
-            task = std::move(tasks.front());
-            tasks.pop();
+namespace {
+constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+// Index of the pool worker running on this thread
+thread_local size_t worker_index = NO_WORKER;
+
+// Per-thread stash of free task nodes (trivially destructible on purpose:
+// nodes are owned by the pool, a thread exiting just forgets them)
+struct TaskCache {
+    static constexpr uint32_t CAPACITY = 64;
+    static constexpr uint32_t BATCH = CAPACITY / 2;
+    std::array<void*, CAPACITY> items;
+    uint32_t count = 0;
+};
+thread_local TaskCache task_cache;
+
+constexpr size_t TASK_BLOCK_SIZE = 256;
+constexpr uint32_t SPINS_BEFORE_SLEEP = 64;
+}  // namespace
+
+/**
+ * @brief Chase-Lev deque with a fixed-size ring. The owner pushes and pops at
+ * the bottom, thieves steal from the top
+ *
+ */
+struct ThreadPool::Worker {
+    static constexpr int64_t CAPACITY = 4096;
+    static constexpr int64_t MASK = CAPACITY - 1;
+    std::atomic<int64_t> top = 0;
+    std::atomic<int64_t> bottom = 0;
+    std::array<std::atomic<Task*>, CAPACITY> buffer{};
+    std::thread thread;
+
+    // Owner only. Returns false if the ring is full
+    bool PushBottom(Task* task) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= CAPACITY)
+            return false;
+        buffer[b & MASK].store(task, std::memory_order_release);
+        bottom.store(b + 1);
+        return true;
+    }
+    // Owner only
+    Task* PopBottom() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b);
+        int64_t t = top.load();
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
         }
-        task();
+        Task* task = buffer[b & MASK].load(std::memory_order_acquire);
+        if (t == b) {
+            // last element: race against thieves
+            if (!top.compare_exchange_strong(t, t + 1))
+                task = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+    Task* Steal() {
+        int64_t t = top.load();
+        int64_t b = bottom.load();
+        if (t >= b)
+            return nullptr;
+        Task* task = buffer[t & MASK].load(std::memory_order_acquire);
+        if (!top.compare_exchange_strong(t, t + 1))
+            return nullptr;
+        return task;
     }
+};
+
+bool ThreadPool::IsWorkerThread() {
+    return worker_index != NO_WORKER;
 }
 
 ThreadPool& ThreadPool::Get() {
-    static ThreadPool singleton(std::thread::hardware_concurrency());
+    static ThreadPool singleton(
+        std::max(std::thread::hardware_concurrency(), 1u));
     return singleton;
 }
 
-ThreadPool::ThreadPool(size_t num_threads) : stop(false) {
-    threads.reserve(num_threads);
+ThreadPool::ThreadPool(size_t num_threads) {
+    workers.reserve(num_threads);
     for (size_t i = 0; i < num_threads; i++)
-        threads.emplace_back(&ThreadPool::ThreadFunction, this);
+        workers.push_back(std::make_unique<Worker>());
+    // deques must exist before any worker starts stealing
+    for (size_t i = 0; i < num_threads; i++)
+        workers[i]->thread = std::thread(&ThreadPool::ThreadFunction, this, i);
 }
 
 ThreadPool::~ThreadPool() {
     {
-        std::lock_guard<std::mutex> lock(tasks_mtx);
+        std::lock_guard lock(sleep_mtx);
         stop = true;
     }
     condition.notify_all();
-    for (std::thread& t : threads)
-        t.join();
+    for (auto& w : workers)
+        w->thread.join();
+}
+
+void ThreadPool::ThreadFunction(size_t index) {
+    worker_index = index;
+    profiler::SetThreadName("Worker " + std::to_string(index));
+    uint32_t idle_spins = 0;
+    while (true) {
+        Task* task = FindTask();
+        if (task != nullptr) {
+            Execute(task);
+            idle_spins = 0;
+            continue;
+        }
+        if (++idle_spins < SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+            continue;
+        }
+        idle_spins = 0;
+        std::unique_lock lock(sleep_mtx);
+        sleeping.fetch_add(1);
+        condition.wait(lock, [this] { return stop || queued.load() > 0; });
+        sleeping.fetch_sub(1);
+        if (stop && queued.load() == 0)
+            return;
+    }
+}
+
+void ThreadPool::Push(Task* task) {
+    queued.fetch_add(1);
+    size_t index = worker_index;
+    if (index == NO_WORKER || !workers[index]->PushBottom(task)) {
+        std::lock_guard lock(injection_mtx);
+        task->next = nullptr;
+        if (injection_tail != nullptr)
+            injection_tail->next = task;
+        else
+            injection_head = task;
+        injection_tail = task;
+    }
+    if (sleeping.load() > 0) {
+        std::lock_guard lock(sleep_mtx);
+        condition.notify_one();
+    }
+}
+
+ThreadPool::Task* ThreadPool::FindTask() {
+    if (queued.load() == 0)
+        return nullptr;
+    size_t index = worker_index;
+    Task* task = nullptr;
+    if (index != NO_WORKER)
+        task = workers[index]->PopBottom();
+    if (task == nullptr) {
+        std::lock_guard lock(injection_mtx);
+        task = injection_head;
+        if (task != nullptr) {
+            injection_head = task->next;
+            if (injection_head == nullptr)
+                injection_tail = nullptr;
+        }
+    }
+    if (task == nullptr) {
+        size_t n = workers.size();
+        size_t start = index == NO_WORKER ? 0 : index + 1;
+        for (size_t i = 0; i < n && task == nullptr; i++) {
+            size_t victim = (start + i) % n;
+            if (victim != index)
+                task = workers[victim]->Steal();
+        }
+    }
+    if (task != nullptr)
+        queued.fetch_sub(1);
+    return task;
+}
+
+void ThreadPool::Execute(Task* task) {
+    TaskGroup* group = task->group;
+    {
+        VERNA_PROFILE_SCOPE("Task");
+        task->run(*task);
+    }
+    FreeTask(task);
+    if (group != nullptr)
+        group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+ThreadPool::Task* ThreadPool::AllocTask() {
+    TaskCache& cache = task_cache;
+    if (cache.count == 0) {
+        std::lock_guard lock(free_mtx);
+        while (cache.count < TaskCache::BATCH) {
+            if (free_tasks == nullptr) {
+                auto& block = task_blocks.emplace_back(
+                    std::make_unique<Task[]>(TASK_BLOCK_SIZE));
+                for (size_t i = 0; i < TASK_BLOCK_SIZE; i++) {
+                    block[i].next = free_tasks;
+                    free_tasks = &block[i];
+                }
+            }
+            cache.items[cache.count++] = free_tasks;
+            free_tasks = free_tasks->next;
+        }
+    }
+    return static_cast<Task*>(cache.items[--cache.count]);
+}
+
+void ThreadPool::FreeTask(Task* task) {
+    TaskCache& cache = task_cache;
+    if (cache.count == TaskCache::CAPACITY) {
+        // give half of the stash back, so that producer threads can reuse it
+        std::lock_guard lock(free_mtx);
+        while (cache.count > TaskCache::BATCH) {
+            auto* t = static_cast<Task*>(cache.items[--cache.count]);
+            t->next = free_tasks;
+            free_tasks = t;
+        }
+    }
+    cache.items[cache.count++] = task;
+}
+
+void TaskGroup::Wait() {
+    ThreadPool& pool = ThreadPool::Get();
+    while (pending.load(std::memory_order_acquire) > 0) {
+        ThreadPool::Task* task = pool.FindTask();
+        if (task != nullptr)
+            pool.Execute(task);
+        else
+            std::this_thread::yield();
+    }
 }
 
 }  // namespace verna
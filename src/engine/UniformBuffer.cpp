@@ -2,7 +2,9 @@
 #include <viverna/graphics/gpu/CameraData.hpp>
 #include <viverna/graphics/gpu/MeshData.hpp>
 
-#if defined(VERNA_DESKTOP)
+#if defined(VERNA_NULL_BACKEND)
+#include "null/NullGL.hpp"
+#elif defined(VERNA_DESKTOP)
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 #elif defined(VERNA_ANDROID)
@@ -26,6 +28,7 @@ struct BlockInfo {
 static GLuint id;
 static std::vector<BlockInfo> bindings;
 static size_t base_offset_alignment;
+static size_t bytes_sent = 0;
 
 void GenerateUBO() {
     GLint64 buffer_size;
@@ -68,9 +71,8 @@ void AddBlock(uint32_t binding_point, size_t size) {
     new_block.offset = offset;
     new_block.size = size;
     new_block.binding_point = binding_point;
-    VERNA_LOGI("Uniform Block | offset: " + std::to_string(offset)
-               + ", size: " + std::to_string(size)
-               + ", binding point: " + std::to_string(binding_point));
+    VERNA_LOGI("Uniform Block | offset: ", offset, ", size: ", size,
+               ", binding point: ", binding_point);
     bindings.push_back(new_block);
 }
 
@@ -78,9 +80,27 @@ void SendData(uint32_t binding_point, const void* data) {
     for (const BlockInfo& block : bindings) {
         if (block.binding_point == binding_point) {
             glBufferSubData(GL_UNIFORM_BUFFER, block.offset, block.size, data);
+            bytes_sent += block.size;
+            return;
+        }
+    }
+}
+
+void SendData(uint32_t binding_point, const void* data, size_t size) {
+    for (const BlockInfo& block : bindings) {
+        if (block.binding_point == binding_point) {
+            VERNA_ASSERT(size <= block.size);
+            glBufferSubData(GL_UNIFORM_BUFFER, block.offset, size, data);
+            bytes_sent += size;
             return;
         }
     }
 }
 
+size_t TakeBytesSent() {
+    size_t taken = bytes_sent;
+    bytes_sent = 0;
+    return taken;
+}
+
 }  // namespace verna::ubo
\ No newline at end of file
@@ -9,6 +9,10 @@ void GenerateUBO();
 void TerminateUBO();
 void AddBlock(uint32_t binding_point, size_t size);
 void SendData(uint32_t binding_point, const void* data);
+// Sends only the first size bytes of the block
+void SendData(uint32_t binding_point, const void* data, size_t size);
+// Bytes sent with SendData() since the last call
+size_t TakeBytesSent();
 }  // namespace verna::ubo
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <viverna/core/Assets.hpp>
 #include <viverna/core/Debug.hpp>
 #include <viverna/core/Input.hpp>
+#include <viverna/core/Profiler.hpp>
 #include <viverna/core/Scene.hpp>
 #include <viverna/graphics/Renderer.hpp>
 #include <viverna/graphics/RendererAPI.hpp>
@@ -34,6 +35,7 @@ void InitializeViverna(VivernaState& state) {
         VERNA_LOGE("Could not initialize the engine");
         return;
     }
+    profiler::SetThreadName("Main");
 
     constexpr int num_systems = static_cast<int>(initializers.size());
     for (int i = 0; i < num_systems; i++) {
@@ -59,6 +61,7 @@ void TerminateViverna(VivernaState& state) {
         state.SetFlag(VivernaState::ERROR_FLAG, false);
     }
     Terminate(terminators.size() - 1, state);
+    FlushLog();
 
     state.SetFlag(VivernaState::RUNNING_FLAG, false);
 }
@@ -1,21 +1,56 @@
 #include <viverna/ecs/World.hpp>
+#include <viverna/core/Profiler.hpp>
+#include <viverna/core/ThreadPool.hpp>
 
 #include <algorithm>
-#include <iterator>
-#include <set>
 
 namespace verna {
 
+World::World(WorldStorage storage_) : storage(storage_) {}
+
+WorldStorage World::GetStorage() const {
+    return storage;
+}
+
+void World::SetStorage(WorldStorage new_storage) {
+    ClearData();
+    storage = new_storage;
+}
+
 void World::ClearData() {
+    VERNA_ASSERT(!in_parallel_stage);
     for (auto& b : buffers)
         b->Clear();
+    archetypes.Clear();
     for (auto& s : systems)
         s.Notify(EntityEvent(Entity(), EntityEvent::CLEAR_DATA));
+    generations.clear();
+    free_ids.clear();
     next_id = 0;
 }
 
+Entity World::CreateEntity() {
+    VERNA_ASSERT(!in_parallel_stage);
+    EntityId id;
+    if (!free_ids.empty()) {
+        id = free_ids.back();
+        free_ids.pop_back();
+    } else {
+        id = ++next_id;
+        if (id >= generations.size())
+            generations.resize(id + 1, 0);
+    }
+    return Entity(id, generations[id]);
+}
+
+bool World::IsAlive(Entity e) const {
+    return e.id != 0 && e.id <= next_id && generations[e.id] == e.generation;
+}
+
 void World::ClearSystems() {
+    VERNA_ASSERT(!in_parallel_stage);
     systems.clear();
+    stages_dirty = true;
 }
 
 void World::ClearAll() {
@@ -24,51 +59,84 @@ void World::ClearAll() {
 }
 
 void World::AddSystem(const System& system) {
-    systems.push_back(system);
-    std::set<Entity> set;
-    const auto& family = system.GetFamily();
-    for (TypeId type : family) {
-        uint32_t index;
-        if (!component_types.GetIndex(type, index))
-            return;
-        auto entities = buffers[index]->GetEntities();
-        for (size_t i = 0; i < entities.size(); i++)
-            set.insert(entities[i]);
-    }
-    systems.back().ReassignEntities(std::vector(set.begin(), set.end()));
+    VERNA_ASSERT(!in_parallel_stage);
+    System& added = systems.emplace_back(system);
+    stages_dirty = true;
+    added.ReassignEntities(GetEntitiesInFamily(added.GetFamily()));
 }
 
 SystemId World::AddSystem(const Family& family, SystemUpdate update_func) {
+    VERNA_ASSERT(!in_parallel_stage);
     System& system = systems.emplace_back(family, update_func);
-    std::set<Entity> set;
-    for (TypeId type : family) {
-        uint32_t index;
-        if (!component_types.GetIndex(type, index))
-            return System::InvalidId();
-        auto entities = buffers[index]->GetEntities();
-        for (size_t i = 0; i < entities.size(); i++)
-            set.insert(entities[i]);
-    }
-    system.ReassignEntities(std::vector(set.begin(), set.end()));
+    stages_dirty = true;
+    system.ReassignEntities(GetEntitiesInFamily(family));
     return system.Id();
 }
 
 void World::RemoveSystem(SystemId system_id) {
+    VERNA_ASSERT(!in_parallel_stage);
     for (size_t i = 0; i < systems.size(); i++) {
         if (systems[i].Id() == system_id) {
             systems.erase(systems.begin() + i);
+            stages_dirty = true;
             return;
         }
     }
 }
 
 void World::RunSystems(DeltaTime<float, Seconds> dt) {
+    VERNA_PROFILE_FUNCTION();
     delta_time = dt;
-    for (System& s : systems)
-        s.Run(*this);
+    if (stages_dirty)
+        BuildStages();
+    ThreadPool& pool = ThreadPool::Get();
+    for (const auto& stage : stages) {
+        if (stage.size() == 1) {
+            VERNA_PROFILE_SCOPE("System");
+            systems[stage[0]].Run(*this);
+            continue;
+        }
+        // structural changes assert until the whole stage is done
+        in_parallel_stage = true;
+        pool.ParallelFor(0, stage.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                VERNA_PROFILE_SCOPE("System");
+                systems[stage[i]].Run(*this);
+            }
+        });
+        in_parallel_stage = false;
+    }
+}
+
+std::vector<std::vector<SystemId>> World::GetStages() {
+    if (stages_dirty)
+        BuildStages();
+    std::vector<std::vector<SystemId>> result(stages.size());
+    for (size_t i = 0; i < stages.size(); i++)
+        for (size_t system : stages[i])
+            result[i].push_back(systems[system].Id());
+    return result;
+}
+
+void World::BuildStages() {
+    // a system goes right after the last earlier system it conflicts with
+    std::vector<size_t> stage_of(systems.size(), 0);
+    size_t num_stages = 0;
+    for (size_t i = 0; i < systems.size(); i++) {
+        for (size_t j = 0; j < i; j++)
+            if (systems[i].ConflictsWith(systems[j]))
+                stage_of[i] = std::max(stage_of[i], stage_of[j] + 1);
+        num_stages = std::max(num_stages, stage_of[i] + 1);
+    }
+    stages.assign(num_stages, {});
+    for (size_t i = 0; i < systems.size(); i++)
+        stages[stage_of[i]].push_back(i);
+    stages_dirty = false;
 }
 
 bool World::HasComponent(Entity e, TypeId comp_type) const {
+    if (storage == WorldStorage::Archetype)
+        return archetypes.HasComponent(e, comp_type);
     uint32_t i;
     if (!component_types.GetIndex(comp_type, i))
         return false;
@@ -76,6 +144,8 @@ bool World::HasComponent(Entity e, TypeId comp_type) const {
 }
 
 bool World::Matches(Entity e, const Family& family) const {
+    if (storage == WorldStorage::Archetype)
+        return archetypes.Matches(e, family);
     for (TypeId type : family)
         if (!HasComponent(e, type))
             return false;
@@ -87,12 +157,47 @@ DeltaTime<float, Seconds> World::GetDeltaTime() const {
 }
 
 void World::RemoveEntity(Entity e) {
+    VERNA_ASSERT(!in_parallel_stage);
+    if (!IsAlive(e)) {
+        VERNA_LOGW("RemoveEntity called on stale Entity ", e.id);
+        return;
+    }
     EntityEvent event(e, EntityEvent::REMOVE);
     for (System& s : systems)
-        s.Notify(event);
+        if (Matches(e, s.GetFamily()))
+            s.Notify(event);
+    if (storage == WorldStorage::Archetype) {
+        archetypes.RemoveEntity(e);
+    } else {
+        for (auto& b : buffers)
+            b->Remove(e);
+    }
+    generations[e.id]++;
+    free_ids.push_back(e.id);
+}
+
+void World::RemoveComponent(Entity e, TypeId comp_type) {
+    VERNA_ASSERT(!in_parallel_stage);
+    if (!HasComponent(e, comp_type))
+        return;
+    EntityEvent event(e, EntityEvent::REMOVE);
+    for (System& s : systems) {
+        const Family& family = s.GetFamily();
+        if (family.Contains(comp_type) && Matches(e, family))
+            s.Notify(event);
+    }
+    if (storage == WorldStorage::Archetype) {
+        archetypes.RemoveComponent(e, comp_type);
+    } else {
+        SparseSet<TypeId>::index_t i;
+        if (component_types.GetIndex(comp_type, i))
+            buffers[i]->Remove(e);
+    }
 }
 
 std::vector<Entity> World::GetEntitiesWithComponent(TypeId comp_type) const {
+    if (storage == WorldStorage::Archetype)
+        return GetEntitiesInFamily(Family({comp_type}));
     SparseSet<TypeId>::index_t i;
     if (component_types.GetIndex(comp_type, i)) {
         const auto& buffer = buffers[i];
@@ -104,16 +209,27 @@ std::vector<Entity> World::GetEntitiesWithComponent(TypeId comp_type) const {
 std::vector<Entity> World::GetEntitiesInFamily(const Family& family) const {
     if (family.Empty())
         return {};
-    constexpr auto entity_comp = [](Entity a, Entity b) { return a.id < b.id; };
-    auto result = GetEntitiesWithComponent(*family.begin());
-    for (auto it = family.begin() + 1; it != family.end(); ++it) {
-        auto entities = GetEntitiesWithComponent(*it);
-        std::vector<Entity> temp;
-        std::set_intersection(result.begin(), result.end(), entities.begin(),
-                              entities.end(), std::back_inserter(temp),
-                              entity_comp);
-        result = std::move(temp);
+    if (storage == WorldStorage::Archetype) {
+        std::vector<Entity> result;
+        archetypes.GetEntitiesInFamily(family, result);
+        return result;
+    }
+    // dense arrays are unordered: probe the others from the smallest buffer
+    const BaseComponentBuffer* smallest = nullptr;
+    for (TypeId type : family) {
+        SparseSet<TypeId>::index_t i;
+        if (!component_types.GetIndex(type, i))
+            return {};
+        const BaseComponentBuffer* b = buffers[i].get();
+        if (smallest == nullptr
+            || b->Entities().size() < smallest->Entities().size())
+            smallest = b;
     }
+    std::vector<Entity> result;
+    result.reserve(smallest->Entities().size());
+    for (Entity e : smallest->Entities())
+        if (Matches(e, family))
+            result.push_back(e);
     return result;
 }
 
@@ -39,6 +39,8 @@ YAML::Emitter& SerializeWorld(YAML::Emitter& emitter,
         emitter << YAML::Value << YAML::BeginMap;
         emitter << YAML::Key << "material" << YAML::Value << mat_serializer;
         emitter << YAML::Key << "mesh" << YAML::Value << GetMeshName(mesh.id);
+        if (!mesh.lods.empty())
+            emitter << YAML::Key << "lods" << YAML::Value << true;
         emitter << YAML::Key << "shader" << YAML::Value << shader_serializer;
         emitter << YAML::Key << "transform" << YAML::Value << transform;
         emitter << YAML::EndMap;
@@ -65,7 +67,7 @@ bool DeserializeWorld(const YAML::Node& node,
         name.str = it->first.as<std::string>(std::string());
         YAML::Node map = it->second;
         if (!map.IsMap()) {
-            VERNA_LOGE(name.str + " node is not a map!");
+            VERNA_LOGE(name.str, " node is not a map!");
             return false;
         }
 
@@ -89,6 +91,8 @@ bool DeserializeWorld(const YAML::Node& node,
             VERNA_LOGE("Transform node not found!");
             return false;
         }
+        // optional, levels of detail are only generated on request
+        bool generate_lods = map["lods"].as<bool>(false);
         bool success;
         success = YAML::convert<MaterialSerializer>::decode(material_node,
                                                             mat_serializer);
@@ -111,7 +115,7 @@ bool DeserializeWorld(const YAML::Node& node,
                 index = mesh_name.rfind(".OBJ##");
             if (index != std::string::npos) {
                 std::string obj_name = mesh_name.substr(0, index + 4);
-                auto meshes = LoadMeshesOBJ(obj_name);
+                auto meshes = LoadMeshesOBJ(obj_name, generate_lods);
                 for (const Mesh& m : meshes) {
                     if (GetMeshName(m.id) == mesh_name) {
                         mesh = m;
@@ -120,8 +124,7 @@ bool DeserializeWorld(const YAML::Node& node,
                 }
             }
         } else {
-            VERNA_LOGE("Failed to deserialize the following mesh: "
-                       + mesh_name);
+            VERNA_LOGE("Failed to deserialize the following mesh: ", mesh_name);
         }
         success = YAML::convert<ShaderSerializer>::decode(shader_node,
                                                           shader_serializer);
@@ -52,7 +52,7 @@ std::vector<char> LoadRawAsset(const std::filesystem::path& path) {
     AAsset* asset =
         AAssetManager_open(asset_manager, path.c_str(), AASSET_MODE_BUFFER);
     if (asset == nullptr) {
-        VERNA_LOGE("LoadRawAsset failed: failed to load " + path.string());
+        VERNA_LOGE("LoadRawAsset failed: failed to load ", path.string());
         return {};
     }
     off_t size = AAsset_getLength(asset);
@@ -93,7 +93,7 @@ std::vector<std::filesystem::path> GetAssetsInDirectory(
         AAssetDir* asset_dir =
             AAssetManager_openDir(asset_manager, current_dir.c_str());
         if (asset_dir == nullptr) {
-            VERNA_LOGW("Failed to open directory " + current_dir.string());
+            VERNA_LOGW("Failed to open directory ", current_dir.string());
             continue;
         }
 
@@ -1,4 +1,4 @@
-#include <viverna/core/Debug.hpp>
+#include "../Log.hpp"
 
 #include <android/log.h>
 
@@ -6,16 +6,17 @@ namespace verna::detail {
 
 static constexpr auto TAG = "Viverna";
 
-void LogInfo(std::string_view message) {
-    __android_log_print(ANDROID_LOG_INFO, TAG, "%s", message.data());
+void WriteLogMessage(LogLevel level, std::string_view message) {
+    int priority = ANDROID_LOG_INFO;
+    if (level == LogLevel::Warning)
+        priority = ANDROID_LOG_WARN;
+    else if (level == LogLevel::Error)
+        priority = ANDROID_LOG_ERROR;
+    __android_log_print(priority, TAG, "%.*s",
+                        static_cast<int>(message.size()), message.data());
 }
 
-void LogWarning(std::string_view message) {
-    __android_log_print(ANDROID_LOG_WARN, TAG, "%s", message.data());
-}
-
-void LogError(std::string_view message) {
-    __android_log_print(ANDROID_LOG_ERROR, TAG, "%s", message.data());
-}
+// logcat is not buffered
+void FlushLogOutput() {}
 
 }  // namespace verna::detail
\ No newline at end of file
@@ -24,9 +24,9 @@ void InitializeRendererAPI(VivernaState& state) {
         reinterpret_cast<const char*>(glGetString(GL_VENDOR))
         + std::to_string(' ')
         + reinterpret_cast<const char*>(glGetString(GL_RENDERER));
-    VERNA_LOGI("GPU: " + info);
+    VERNA_LOGI("GPU: ", info);
     info.assign(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
-    VERNA_LOGI("API: " + info);
+    VERNA_LOGI("API: ", info);
 
     state.SetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG, true);
     VERNA_LOGI("Renderer API initialized!");
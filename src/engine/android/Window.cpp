@@ -103,8 +103,7 @@ void InitializeWindow(VivernaState& state) {
         EglFailure(state, "eglInitialize failed: " + error);
         return;
     }
-    VERNA_LOGI("eglInitialize succeeded: version " + std::to_string(egl_major)
-               + '.' + std::to_string(egl_minor));
+    VERNA_LOGI("eglInitialize succeeded: version ", egl_major, '.', egl_minor);
 
     constexpr EGLint BITS_PER_CHANNEL = 8;
     constexpr EGLint BITS_PER_DEPTH = 24;
@@ -198,8 +197,8 @@ void InitializeWindow(VivernaState& state) {
         EglFailure(state, "eglQuerySurface failed: " + error);
         return;
     }
-    VERNA_LOGI("Display width:  " + std::to_string(width));
-    VERNA_LOGI("Display height: " + std::to_string(height));
+    VERNA_LOGI("Display width:  ", width);
+    VERNA_LOGI("Display height: ", height);
     VERNA_LOGI("Window initialized!");
 }
 
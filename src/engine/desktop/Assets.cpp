@@ -57,7 +57,7 @@ std::vector<char> LoadRawAsset(const std::filesystem::path& path) {
     auto fullpath = assets_folder_path / path;
     std::ifstream file(fullpath, std::ios::binary);
     if (!file.is_open()) {
-        VERNA_LOGE("LoadRawAsset failed: can't find " + fullpath.string());
+        VERNA_LOGE("LoadRawAsset failed: can't find ", fullpath.string());
         return {};
     }
     file.seekg(0, file.end);
@@ -66,8 +66,7 @@ std::vector<char> LoadRawAsset(const std::filesystem::path& path) {
     std::vector<char> output(size);
     file.read(output.data(), size);
     if (file.fail()) {
-        VERNA_LOGE("LoadRawAsset failed: read failure for "
-                   + fullpath.string());
+        VERNA_LOGE("LoadRawAsset failed: read failure for ", fullpath.string());
         output.clear();
     }
     return output;
@@ -86,7 +85,7 @@ std::vector<std::filesystem::path> GetAssetsInDirectory(
     auto in_path = assets_folder_path / path;
     auto in_path_str = in_path.string();
     if (!std::filesystem::exists(in_path)) {
-        VERNA_LOGW("Failed to open directory " + in_path_str);
+        VERNA_LOGW("Failed to open directory ", in_path_str);
         return result;
     }
     if (fullpath) {
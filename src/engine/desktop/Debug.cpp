@@ -1,23 +1,26 @@
-#include <viverna/core/Debug.hpp>
+#include "../Log.hpp"
 
 #include <iostream>
 
 namespace verna::detail {
 
-static void Log(std::string_view priority, std::string_view msg) {
-    std::cout << '[' << priority << "] " << msg << std::endl;
+static std::string_view PriorityName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Warning:
+            return "WARN";
+        case LogLevel::Error:
+            return "ERROR";
+        default:
+            return "INFO";
+    }
 }
 
-void LogInfo(std::string_view message) {
-    Log("INFO", message);
+void WriteLogMessage(LogLevel level, std::string_view message) {
+    std::cout << '[' << PriorityName(level) << "] " << message << '\n';
 }
 
-void LogWarning(std::string_view message) {
-    Log("WARN", message);
-}
-
-void LogError(std::string_view message) {
-    Log("ERROR", message);
+void FlushLogOutput() {
+    std::cout.flush();
 }
 
 }  // namespace verna::detail
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <viverna/graphics/RendererAPI.hpp>
 #include <viverna/core/Debug.hpp>
+#include "../BindlessTextures.hpp"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -39,6 +40,7 @@ void InitializeRendererAPI(VivernaState& state) {
         RendererAPIError(state, "gladLoadGL(glfwGetProcAddress) failed!");
         return;
     }
+    bindless::Initialize();
 #ifndef NDEBUG
     glEnable(GL_DEBUG_OUTPUT);
     glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
@@ -46,9 +48,8 @@ void InitializeRendererAPI(VivernaState& state) {
 #endif
 
     state.SetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG, true);
-    VERNA_LOGI("Renderer API initialized!\t\t\tOpenGL "
-               + std::to_string(GLAD_VERSION_MAJOR(version)) + '.'
-               + std::to_string(GLAD_VERSION_MINOR(version)));
+    VERNA_LOGI("Renderer API initialized!\t\t\tOpenGL ",
+               GLAD_VERSION_MAJOR(version), '.', GLAD_VERSION_MINOR(version));
 }
 
 [[maybe_unused]] static void OpenGLDebugOutputFunc(GLenum source,
@@ -61,13 +62,13 @@ void InitializeRendererAPI(VivernaState& state) {
     // TODO better OpenGL error handling
     switch (severity) {
         case GL_DEBUG_SEVERITY_HIGH:
-            VERNA_LOGE("OpenGL error " + std::to_string(id) + ": " + message);
+            VERNA_LOGE("OpenGL error ", id, ": ", message);
             break;
         case GL_DEBUG_SEVERITY_MEDIUM:
-            VERNA_LOGW("OpenGL warning " + std::to_string(id) + ": " + message);
+            VERNA_LOGW("OpenGL warning ", id, ": ", message);
             break;
         case GL_DEBUG_SEVERITY_LOW:
-            VERNA_LOGI("OpenGL info " + std::to_string(id) + ": " + message);
+            VERNA_LOGI("OpenGL info ", id, ": ", message);
             break;
         default:
             break;
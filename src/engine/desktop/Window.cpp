@@ -76,7 +76,7 @@ void InitializeWindow(VivernaState& state) {
                 err_string = "<Unknown GLFW error>";
                 break;
         }
-        VERNA_LOGE("GLFW error " + err_string + ":\n" + description);
+        VERNA_LOGE("GLFW error ", err_string, ":\n", description);
     });
 #endif
 
@@ -0,0 +1,41 @@
+#include <viverna/core/Input.hpp>
+#include <viverna/core/Debug.hpp>
+
+namespace verna {
+
+// no window, no input: nothing is ever pressed
+
+void InitializeInput(VivernaState& state) {
+    if (state.GetFlag(VivernaState::INPUT_INITIALIZED_FLAG))
+        return;
+    if (state.native_window == nullptr) {
+        VERNA_LOGE("InitializeInput must be called after InitializeWindow!");
+        state.SetFlag(VivernaState::ERROR_FLAG, true);
+        return;
+    }
+    state.SetFlag(VivernaState::INPUT_INITIALIZED_FLAG, true);
+    VERNA_LOGI("Input initialized!");
+}
+
+void TerminateInput(VivernaState& state) {
+    if (!state.GetFlag(VivernaState::INPUT_INITIALIZED_FLAG))
+        return;
+    state.SetFlag(VivernaState::INPUT_INITIALIZED_FLAG, false);
+    VERNA_LOGI("Input terminated!");
+}
+
+void MouseListener::Position(unsigned& pos_x, unsigned& pos_y) const {
+    pos_x = 0;
+    pos_y = 0;
+}
+
+bool MouseListener::Pressed(unsigned& pos_x, unsigned& pos_y) const {
+    Position(pos_x, pos_y);
+    return false;
+}
+
+bool KeyListener::Pressed() const {
+    return false;
+}
+
+}  // namespace verna
@@ -0,0 +1,577 @@
+#include "NullGL.hpp"
+#include <viverna/graphics/NullBackend.hpp>
+#include <viverna/graphics/gpu/DrawCommand.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+struct NullGLsync {};
+
+namespace {
+using verna::NullBackendCommand;
+using CommandType = NullBackendCommand::Type;
+
+// Limits reported to the engine, the minimum guaranteed by OpenGL 4.6 or
+// the common desktop value
+constexpr GLint MAX_TEXTURE_IMAGE_UNITS = 16;
+constexpr GLint BUFFER_OFFSET_ALIGNMENT = 256;
+constexpr GLint64 MAX_UNIFORM_BLOCK_SIZE = 65536;
+
+verna::NullBackendCounters counters;
+std::vector<NullBackendCommand> commands;
+bool recording = false;
+
+GLenum error = GL_NO_ERROR;
+GLuint next_name = 1;
+// buffers live in system memory, so that mapped pointers can be written and
+// indirect commands can be read back
+std::unordered_map<GLuint, std::vector<std::byte>> buffers;
+std::unordered_map<GLenum, GLuint> bound_buffers;
+// every fence is already signaled
+NullGLsync fence;
+
+void Record(CommandType type, uint32_t object, uint64_t amount) {
+    if (recording)
+        commands.push_back({type, object, amount});
+}
+
+void SetError(GLenum e) {
+    // like the driver, keep the first error until glGetError()
+    if (error == GL_NO_ERROR)
+        error = e;
+    counters.errors++;
+}
+
+void StateChange(GLenum state) {
+    counters.state_changes++;
+    Record(CommandType::StateChange, state, 0);
+}
+
+void GenNames(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; i++)
+        names[i] = next_name++;
+}
+
+std::vector<std::byte>* BoundBuffer(GLenum target) {
+    auto it = bound_buffers.find(target);
+    if (it == bound_buffers.end() || it->second == 0) {
+        SetError(GL_INVALID_OPERATION);
+        return nullptr;
+    }
+    return &buffers[it->second];
+}
+
+bool InRange(const std::vector<std::byte>& buffer,
+             GLintptr offset,
+             GLsizeiptr size) {
+    if (offset >= 0 && size >= 0
+        && static_cast<size_t>(offset + size) <= buffer.size())
+        return true;
+    SetError(GL_INVALID_VALUE);
+    return false;
+}
+
+void Upload(GLuint object, uint64_t bytes) {
+    counters.bytes_uploaded += bytes;
+    Record(CommandType::Upload, object, bytes);
+}
+
+uint64_t PixelSize(GLenum format, GLenum type) {
+    const uint64_t components = format == GL_RGBA ? 4 : 1;
+    const uint64_t component_size = type == GL_UNSIGNED_BYTE ? 1 : 4;
+    return components * component_size;
+}
+
+void AllocateBuffer(GLenum target, GLsizeiptr size, const void* data) {
+    auto* buffer = BoundBuffer(target);
+    if (buffer == nullptr)
+        return;
+    if (size < 0) {
+        SetError(GL_INVALID_VALUE);
+        return;
+    }
+    buffer->assign(static_cast<size_t>(size), std::byte{0});
+    if (data != nullptr) {
+        std::memcpy(buffer->data(), data, buffer->size());
+        Upload(bound_buffers[target], buffer->size());
+    }
+}
+
+void CountDraws(GLenum mode,
+                GLsizei count,
+                uint64_t instance_count,
+                uint64_t& triangles) {
+    if (mode == GL_TRIANGLES)
+        triangles += static_cast<uint64_t>(count / 3) * instance_count;
+}
+}  // namespace
+
+namespace verna {
+const NullBackendCounters& GetNullBackendCounters() {
+    return counters;
+}
+
+void ResetNullBackendCounters() {
+    counters = NullBackendCounters();
+}
+
+void SetNullBackendRecording(bool enabled) {
+    recording = enabled;
+}
+
+const std::vector<NullBackendCommand>& GetNullBackendCommands() {
+    return commands;
+}
+
+void ClearNullBackendCommands() {
+    commands.clear();
+}
+
+namespace null_backend {
+void EndFrame() {
+    counters.frames++;
+    Record(CommandType::SwapBuffers, 0, 0);
+}
+}  // namespace null_backend
+}  // namespace verna
+
+void glActiveTexture(GLenum texture) {}
+
+void glAttachShader(GLuint program, GLuint shader) {}
+
+void glBeginQuery(GLenum target, GLuint id) {}
+
+void glBindBuffer(GLenum target, GLuint buffer) {
+    bound_buffers[target] = buffer;
+    counters.buffer_binds++;
+    Record(CommandType::BindBuffer, buffer, 0);
+}
+
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // also binds the generic target, like the driver
+    glBindBuffer(target, buffer);
+}
+
+void glBindBufferRange(GLenum target,
+                       GLuint index,
+                       GLuint buffer,
+                       GLintptr offset,
+                       GLsizeiptr size) {
+    glBindBuffer(target, buffer);
+    counters.bytes_bound += static_cast<uint64_t>(size);
+}
+
+void glBindFramebuffer(GLenum target, GLuint framebuffer) {
+    counters.framebuffer_binds++;
+    Record(CommandType::BindFramebuffer, framebuffer, 0);
+}
+
+void glBindTexture(GLenum target, GLuint texture) {
+    counters.texture_binds++;
+    Record(CommandType::BindTexture, texture, 0);
+}
+
+void glBindTextures(GLuint first, GLsizei count, const GLuint* textures) {
+    counters.texture_binds += static_cast<uint64_t>(count);
+    Record(CommandType::BindTexture, first, static_cast<uint64_t>(count));
+}
+
+void glBindVertexArray(GLuint array) {
+    counters.vertex_array_binds++;
+    Record(CommandType::BindVertexArray, array, 0);
+}
+
+void glBufferData(GLenum target,
+                  GLsizeiptr size,
+                  const void* data,
+                  GLenum usage) {
+    AllocateBuffer(target, size, data);
+}
+
+void glBufferStorage(GLenum target,
+                     GLsizeiptr size,
+                     const void* data,
+                     GLbitfield flags) {
+    AllocateBuffer(target, size, data);
+}
+
+void glBufferSubData(GLenum target,
+                     GLintptr offset,
+                     GLsizeiptr size,
+                     const void* data) {
+    auto* buffer = BoundBuffer(target);
+    if (buffer == nullptr || !InRange(*buffer, offset, size))
+        return;
+    std::memcpy(buffer->data() + offset, data, static_cast<size_t>(size));
+    Upload(bound_buffers[target], static_cast<uint64_t>(size));
+}
+
+GLenum glCheckFramebufferStatus(GLenum target) {
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void glClear(GLbitfield mask) {
+    counters.clears++;
+    Record(CommandType::Clear, mask, 0);
+}
+
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    StateChange(GL_COLOR_BUFFER_BIT);
+}
+
+void glClearDepthf(GLfloat d) {
+    StateChange(GL_DEPTH_BUFFER_BIT);
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    return GL_ALREADY_SIGNALED;
+}
+
+void glCompileShader(GLuint shader) {}
+
+void glCopyBufferSubData(GLenum readTarget,
+                         GLenum writeTarget,
+                         GLintptr readOffset,
+                         GLintptr writeOffset,
+                         GLsizeiptr size) {
+    // copies stay on the GPU: not counted as uploads
+    auto* src = BoundBuffer(readTarget);
+    auto* dst = BoundBuffer(writeTarget);
+    if (src == nullptr || dst == nullptr || !InRange(*src, readOffset, size)
+        || !InRange(*dst, writeOffset, size))
+        return;
+    std::memmove(dst->data() + writeOffset, src->data() + readOffset,
+                 static_cast<size_t>(size));
+}
+
+GLuint glCreateProgram() {
+    return next_name++;
+}
+
+GLuint glCreateShader(GLenum type) {
+    return next_name++;
+}
+
+void glCullFace(GLenum mode) {
+    StateChange(GL_CULL_FACE);
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* names) {
+    for (GLsizei i = 0; i < n; i++) {
+        buffers.erase(names[i]);
+        for (auto& binding : bound_buffers)
+            if (binding.second == names[i])
+                binding.second = 0;
+    }
+}
+
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {}
+
+void glDeleteProgram(GLuint program) {}
+
+void glDeleteQueries(GLsizei n, const GLuint* ids) {}
+
+void glDeleteShader(GLuint shader) {}
+
+void glDeleteSync(GLsync sync) {}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures) {}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays) {}
+
+void glDepthFunc(GLenum func) {
+    StateChange(GL_DEPTH_TEST);
+}
+
+void glDepthMask(GLboolean flag) {
+    StateChange(GL_DEPTH_TEST);
+}
+
+void glDrawBuffers(GLsizei n, const GLenum* bufs) {
+    StateChange(GL_FRAMEBUFFER);
+}
+
+void glDrawElementsInstancedBaseVertex(GLenum mode,
+                                       GLsizei count,
+                                       GLenum type,
+                                       const void* indices,
+                                       GLsizei instancecount,
+                                       GLint basevertex) {
+    const auto instances = static_cast<uint64_t>(instancecount);
+    counters.draw_calls++;
+    counters.instances += instances;
+    CountDraws(mode, count, instances, counters.triangles);
+    Record(CommandType::Draw, mode, instances);
+}
+
+void glEnable(GLenum cap) {
+    StateChange(cap);
+}
+
+void glEnableVertexAttribArray(GLuint index) {}
+
+void glEndQuery(GLenum target) {}
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags) {
+    return &fence;
+}
+
+void glFramebufferTexture2D(GLenum target,
+                            GLenum attachment,
+                            GLenum textarget,
+                            GLuint texture,
+                            GLint level) {}
+
+void glGenBuffers(GLsizei n, GLuint* names) {
+    GenNames(n, names);
+    for (GLsizei i = 0; i < n; i++)
+        buffers[names[i]];
+}
+
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+    GenNames(n, framebuffers);
+}
+
+void glGenQueries(GLsizei n, GLuint* ids) {
+    GenNames(n, ids);
+}
+
+void glGenTextures(GLsizei n, GLuint* textures) {
+    GenNames(n, textures);
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays) {
+    GenNames(n, arrays);
+}
+
+GLenum glGetError() {
+    GLenum e = error;
+    error = GL_NO_ERROR;
+    return e;
+}
+
+void glGetInteger64v(GLenum pname, GLint64* data) {
+    if (pname == GL_MAX_UNIFORM_BLOCK_SIZE) {
+        *data = MAX_UNIFORM_BLOCK_SIZE;
+        return;
+    }
+    GLint value = 0;
+    glGetIntegerv(pname, &value);
+    *data = value;
+}
+
+void glGetIntegerv(GLenum pname, GLint* data) {
+    switch (pname) {
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+            *data = MAX_TEXTURE_IMAGE_UNITS;
+            break;
+        case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT:
+        case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+            *data = BUFFER_OFFSET_ALIGNMENT;
+            break;
+        case GL_MAX_UNIFORM_BLOCK_SIZE:
+            *data = static_cast<GLint>(MAX_UNIFORM_BLOCK_SIZE);
+            break;
+        default:
+            SetError(GL_INVALID_ENUM);
+            break;
+    }
+}
+
+void glGetProgramInfoLog(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLchar* infoLog) {
+    glGetShaderInfoLog(program, bufSize, length, infoLog);
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+}
+
+// queries are always ready and measure no GPU time
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+    *params = 0;
+}
+
+void glGetShaderInfoLog(GLuint shader,
+                        GLsizei bufSize,
+                        GLsizei* length,
+                        GLchar* infoLog) {
+    if (length != nullptr)
+        *length = 0;
+    if (bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+const GLubyte* glGetString(GLenum name) {
+    const char* str = "";
+    switch (name) {
+        case GL_VENDOR:
+            str = "Viverna";
+            break;
+        case GL_RENDERER:
+            str = "Viverna null backend";
+            break;
+        case GL_VERSION:
+            str = "4.6 null";
+            break;
+        default:
+            SetError(GL_INVALID_ENUM);
+            break;
+    }
+    return reinterpret_cast<const GLubyte*>(str);
+}
+
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName) {
+    return 0;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name) {
+    return 0;
+}
+
+void glLinkProgram(GLuint program) {}
+
+void* glMapBufferRange(GLenum target,
+                       GLintptr offset,
+                       GLsizeiptr length,
+                       GLbitfield access) {
+    auto* buffer = BoundBuffer(target);
+    if (buffer == nullptr || !InRange(*buffer, offset, length))
+        return nullptr;
+    return buffer->data() + offset;
+}
+
+void glMultiDrawElementsIndirect(GLenum mode,
+                                 GLenum type,
+                                 const void* indirect,
+                                 GLsizei drawcount,
+                                 GLsizei stride) {
+    // indirect is an offset in the bound GL_DRAW_INDIRECT_BUFFER
+    auto* buffer = BoundBuffer(GL_DRAW_INDIRECT_BUFFER);
+    if (buffer == nullptr)
+        return;
+    using verna::gpu::DrawCommand;
+    const auto offset = reinterpret_cast<uintptr_t>(indirect);
+    const size_t step = stride == 0 ? sizeof(DrawCommand) : stride;
+    const auto size = static_cast<GLsizeiptr>(
+        drawcount > 0 ? step * (drawcount - 1) + sizeof(DrawCommand) : 0);
+    if (!InRange(*buffer, static_cast<GLintptr>(offset), size))
+        return;
+    uint64_t instances = 0;
+    for (GLsizei i = 0; i < drawcount; i++) {
+        DrawCommand cmd;
+        std::memcpy(&cmd, buffer->data() + offset + i * step, sizeof(cmd));
+        instances += cmd.instance_count;
+        CountDraws(mode, static_cast<GLsizei>(cmd.count), cmd.instance_count,
+                   counters.triangles);
+    }
+    counters.multi_draw_calls++;
+    counters.draw_commands += static_cast<uint64_t>(drawcount);
+    counters.instances += instances;
+    Record(CommandType::MultiDraw, mode, static_cast<uint64_t>(drawcount));
+}
+
+void glReadBuffer(GLenum src) {
+    StateChange(GL_FRAMEBUFFER);
+}
+
+void glReadPixels(GLint x,
+                  GLint y,
+                  GLsizei width,
+                  GLsizei height,
+                  GLenum format,
+                  GLenum type,
+                  void* pixels) {
+    std::memset(pixels, 0,
+                static_cast<size_t>(width) * static_cast<size_t>(height)
+                    * PixelSize(format, type));
+}
+
+void glShaderSource(GLuint shader,
+                    GLsizei count,
+                    const GLchar* const* string,
+                    const GLint* length) {}
+
+void glTexImage2D(GLenum target,
+                  GLint level,
+                  GLint internalformat,
+                  GLsizei width,
+                  GLsizei height,
+                  GLint border,
+                  GLenum format,
+                  GLenum type,
+                  const void* pixels) {
+    if (pixels != nullptr)
+        glTexSubImage2D(target, level, 0, 0, width, height, format, type,
+                        pixels);
+}
+
+void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params) {}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+
+void glTexStorage2D(GLenum target,
+                    GLsizei levels,
+                    GLenum internalformat,
+                    GLsizei width,
+                    GLsizei height) {}
+
+void glTexSubImage2D(GLenum target,
+                     GLint level,
+                     GLint xoffset,
+                     GLint yoffset,
+                     GLsizei width,
+                     GLsizei height,
+                     GLenum format,
+                     GLenum type,
+                     const void* pixels) {
+    Upload(0, static_cast<uint64_t>(width) * static_cast<uint64_t>(height)
+                  * PixelSize(format, type));
+}
+
+void glUniform1i(GLint location, GLint v0) {
+    counters.uniform_updates++;
+    Record(CommandType::Uniform, static_cast<uint32_t>(location), 1);
+}
+
+void glUniform1iv(GLint location, GLsizei count, const GLint* value) {
+    counters.uniform_updates++;
+    Record(CommandType::Uniform, static_cast<uint32_t>(location),
+           static_cast<uint64_t>(count));
+}
+
+void glUniformBlockBinding(GLuint program,
+                           GLuint uniformBlockIndex,
+                           GLuint uniformBlockBinding) {}
+
+GLboolean glUnmapBuffer(GLenum target) {
+    return GL_TRUE;
+}
+
+void glUseProgram(GLuint program) {
+    counters.program_binds++;
+    Record(CommandType::BindProgram, program, 0);
+}
+
+void glVertexAttribPointer(GLuint index,
+                           GLint size,
+                           GLenum type,
+                           GLboolean normalized,
+                           GLsizei stride,
+                           const void* pointer) {}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    StateChange(GL_VIEWPORT);
+}
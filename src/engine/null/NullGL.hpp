@@ -0,0 +1,260 @@
+#ifndef VERNA_NULL_GL_HPP
+#define VERNA_NULL_GL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Subset of the OpenGL 4.6 API used by the engine, implemented by NullGL.cpp
+// without a driver: buffers live in system memory and every call updates the
+// NullBackend counters. Values match the Khronos headers
+
+using GLenum = unsigned int;
+using GLboolean = unsigned char;
+using GLbitfield = unsigned int;
+using GLvoid = void;
+using GLint = int;
+using GLuint = unsigned int;
+using GLsizei = int;
+using GLfloat = float;
+using GLchar = char;
+using GLubyte = unsigned char;
+using GLint64 = int64_t;
+using GLuint64 = uint64_t;
+using GLintptr = ptrdiff_t;
+using GLsizeiptr = ptrdiff_t;
+struct NullGLsync;
+using GLsync = NullGLsync*;
+
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_BACK 0x0405
+#define GL_CLAMP_TO_BORDER 0x812D
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_COLOR_BUFFER_BIT 0x00004000
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_COPY_READ_BUFFER 0x8F36
+#define GL_COPY_WRITE_BUFFER 0x8F37
+#define GL_CULL_FACE 0x0B44
+#define GL_DEPTH_ATTACHMENT 0x8D00
+#define GL_DEPTH_BUFFER_BIT 0x00000100
+#define GL_DEPTH_COMPONENT 0x1902
+#define GL_DEPTH_TEST 0x0B71
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#define GL_DYNAMIC_DRAW 0x88E8
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_FALSE 0
+#define GL_FLOAT 0x1406
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#define GL_FRONT 0x0404
+#define GL_GEOMETRY_SHADER 0x8DD9
+#define GL_GEQUAL 0x0206
+#define GL_INVALID_ENUM 0x0500
+#define GL_INVALID_FRAMEBUFFER_OPERATION 0x0506
+#define GL_INVALID_OPERATION 0x0502
+#define GL_INVALID_VALUE 0x0501
+#define GL_LESS 0x0201
+#define GL_LINEAR 0x2601
+#define GL_LINK_STATUS 0x8B82
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAX_TEXTURE_IMAGE_UNITS 0x8872
+#define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+#define GL_NEAREST 0x2600
+#define GL_NONE 0
+#define GL_NO_ERROR 0
+#define GL_OUT_OF_MEMORY 0x0505
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_RENDERER 0x1F01
+#define GL_REPEAT 0x2901
+#define GL_RGBA 0x1908
+#define GL_RGBA8 0x8058
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
+#define GL_STACK_OVERFLOW 0x0503
+#define GL_STACK_UNDERFLOW 0x0504
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_TEXTURE0 0x84C0
+#define GL_TEXTURE_2D 0x0DE1
+#define GL_TEXTURE_BORDER_COLOR 0x1004
+#define GL_TEXTURE_MAG_FILTER 0x2800
+#define GL_TEXTURE_MIN_FILTER 0x2801
+#define GL_TEXTURE_WRAP_S 0x2802
+#define GL_TEXTURE_WRAP_T 0x2803
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_TRIANGLES 0x0004
+#define GL_TRUE 1
+#define GL_UNIFORM_BUFFER 0x8A11
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_UNSIGNED_INT 0x1405
+#define GL_VENDOR 0x1F00
+#define GL_VERSION 0x1F02
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_VIEWPORT 0x0BA2
+#define GL_WAIT_FAILED 0x911D
+
+void glActiveTexture(GLenum texture);
+void glAttachShader(GLuint program, GLuint shader);
+void glBeginQuery(GLenum target, GLuint id);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void glBindBufferRange(GLenum target,
+                       GLuint index,
+                       GLuint buffer,
+                       GLintptr offset,
+                       GLsizeiptr size);
+void glBindFramebuffer(GLenum target, GLuint framebuffer);
+void glBindTexture(GLenum target, GLuint texture);
+void glBindTextures(GLuint first, GLsizei count, const GLuint* textures);
+void glBindVertexArray(GLuint array);
+void glBufferData(GLenum target,
+                  GLsizeiptr size,
+                  const void* data,
+                  GLenum usage);
+void glBufferStorage(GLenum target,
+                     GLsizeiptr size,
+                     const void* data,
+                     GLbitfield flags);
+void glBufferSubData(GLenum target,
+                     GLintptr offset,
+                     GLsizeiptr size,
+                     const void* data);
+GLenum glCheckFramebufferStatus(GLenum target);
+void glClear(GLbitfield mask);
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void glClearDepthf(GLfloat d);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glCompileShader(GLuint shader);
+void glCopyBufferSubData(GLenum readTarget,
+                         GLenum writeTarget,
+                         GLintptr readOffset,
+                         GLintptr writeOffset,
+                         GLsizeiptr size);
+GLuint glCreateProgram();
+GLuint glCreateShader(GLenum type);
+void glCullFace(GLenum mode);
+void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void glDeleteProgram(GLuint program);
+void glDeleteQueries(GLsizei n, const GLuint* ids);
+void glDeleteShader(GLuint shader);
+void glDeleteSync(GLsync sync);
+void glDeleteTextures(GLsizei n, const GLuint* textures);
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glDepthFunc(GLenum func);
+void glDepthMask(GLboolean flag);
+void glDrawBuffers(GLsizei n, const GLenum* bufs);
+void glDrawElementsInstancedBaseVertex(GLenum mode,
+                                       GLsizei count,
+                                       GLenum type,
+                                       const void* indices,
+                                       GLsizei instancecount,
+                                       GLint basevertex);
+void glEnable(GLenum cap);
+void glEnableVertexAttribArray(GLuint index);
+void glEndQuery(GLenum target);
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+void glFramebufferTexture2D(GLenum target,
+                            GLenum attachment,
+                            GLenum textarget,
+                            GLuint texture,
+                            GLint level);
+void glGenBuffers(GLsizei n, GLuint* buffers);
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers);
+void glGenQueries(GLsizei n, GLuint* ids);
+void glGenTextures(GLsizei n, GLuint* textures);
+void glGenVertexArrays(GLsizei n, GLuint* arrays);
+GLenum glGetError();
+void glGetInteger64v(GLenum pname, GLint64* data);
+void glGetIntegerv(GLenum pname, GLint* data);
+void glGetProgramInfoLog(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLchar* infoLog);
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params);
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void glGetShaderInfoLog(GLuint shader,
+                        GLsizei bufSize,
+                        GLsizei* length,
+                        GLchar* infoLog);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+const GLubyte* glGetString(GLenum name);
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName);
+GLint glGetUniformLocation(GLuint program, const GLchar* name);
+void glLinkProgram(GLuint program);
+void* glMapBufferRange(GLenum target,
+                       GLintptr offset,
+                       GLsizeiptr length,
+                       GLbitfield access);
+void glMultiDrawElementsIndirect(GLenum mode,
+                                 GLenum type,
+                                 const void* indirect,
+                                 GLsizei drawcount,
+                                 GLsizei stride);
+void glReadBuffer(GLenum src);
+void glReadPixels(GLint x,
+                  GLint y,
+                  GLsizei width,
+                  GLsizei height,
+                  GLenum format,
+                  GLenum type,
+                  void* pixels);
+void glShaderSource(GLuint shader,
+                    GLsizei count,
+                    const GLchar* const* string,
+                    const GLint* length);
+void glTexImage2D(GLenum target,
+                  GLint level,
+                  GLint internalformat,
+                  GLsizei width,
+                  GLsizei height,
+                  GLint border,
+                  GLenum format,
+                  GLenum type,
+                  const void* pixels);
+void glTexParameterfv(GLenum target, GLenum pname, const GLfloat* params);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexStorage2D(GLenum target,
+                    GLsizei levels,
+                    GLenum internalformat,
+                    GLsizei width,
+                    GLsizei height);
+void glTexSubImage2D(GLenum target,
+                     GLint level,
+                     GLint xoffset,
+                     GLint yoffset,
+                     GLsizei width,
+                     GLsizei height,
+                     GLenum format,
+                     GLenum type,
+                     const void* pixels);
+void glUniform1i(GLint location, GLint v0);
+void glUniform1iv(GLint location, GLsizei count, const GLint* value);
+void glUniformBlockBinding(GLuint program,
+                           GLuint uniformBlockIndex,
+                           GLuint uniformBlockBinding);
+GLboolean glUnmapBuffer(GLenum target);
+void glUseProgram(GLuint program);
+void glVertexAttribPointer(GLuint index,
+                           GLint size,
+                           GLenum type,
+                           GLboolean normalized,
+                           GLsizei stride,
+                           const void* pointer);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+namespace verna::null_backend {
+// Called by SwapBuffers() at the end of every frame
+void EndFrame();
+}  // namespace verna::null_backend
+
+#endif
@@ -0,0 +1,41 @@
+#include <viverna/graphics/RendererAPI.hpp>
+#include <viverna/core/Debug.hpp>
+#include "../BindlessTextures.hpp"
+#include "NullGL.hpp"
+
+#include <string>
+
+namespace verna {
+
+void InitializeRendererAPI(VivernaState& state) {
+    if (state.GetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG)) {
+        return;
+    }
+    if (state.native_window == nullptr) {
+        VERNA_LOGE(
+            "InitializeWindow() should be called before "
+            "InitializeRendererAPI()!");
+        state.SetFlag(VivernaState::ERROR_FLAG, true);
+        return;
+    }
+    bindless::Initialize();
+
+    state.SetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG, true);
+    VERNA_LOGI("Renderer API initialized!\t\t\t",
+               reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+}
+
+void TerminateRendererAPI(VivernaState& state) {
+    if (!state.GetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG))
+        return;
+    if (state.GetFlag(VivernaState::RENDERER_INITIALIZED_FLAG)) {
+        VERNA_LOGE(
+            "TerminateRenderer() should be called before "
+            "TerminateRendererAPI()");
+        state.SetFlag(VivernaState::ERROR_FLAG, true);
+        return;
+    }
+    state.SetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG, false);
+    VERNA_LOGI("Renderer API terminated!");
+}
+}  // namespace verna
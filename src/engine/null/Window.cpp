@@ -0,0 +1,49 @@
+#include <viverna/graphics/Window.hpp>
+#include <viverna/core/Debug.hpp>
+
+namespace verna {
+
+// no window: the null backend only needs a valid native_window and a size
+static constexpr int WIDTH = 1920;
+static constexpr int HEIGHT = 1080;
+static int headless_window = 0;
+static int width = 0;
+static int height = 0;
+
+void InitializeWindow(VivernaState& state) {
+    if (state.native_window != nullptr) {
+        VERNA_LOGI("InitializeWindow called on initialized window! (NOP)");
+        return;
+    }
+    width = WIDTH;
+    height = HEIGHT;
+    state.native_window = &headless_window;
+    VERNA_LOGI("Window initialized! (null backend)");
+}
+
+void TerminateWindow(VivernaState& state) {
+    if (state.native_window == nullptr) {
+        VERNA_LOGW("Tried to terminate Window before initialization!");
+        return;
+    }
+    if (state.GetFlag(VivernaState::RENDERER_API_INITIALIZED_FLAG)) {
+        VERNA_LOGE(
+            "TerminateRendererAPI() should be called before TerminateWindow()");
+        state.SetFlag(VivernaState::ERROR_FLAG, true);
+        return;
+    }
+    state.native_window = nullptr;
+    width = 0;
+    height = 0;
+    VERNA_LOGI("Window terminated!");
+}
+
+int WindowWidth() {
+    VERNA_LOGE_IF(width <= 0, "Window was not initialized successfully!");
+    return width;
+}
+int WindowHeight() {
+    VERNA_LOGE_IF(height <= 0, "Window was not initialized successfully!");
+    return height;
+}
+}  // namespace verna
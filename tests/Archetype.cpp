@@ -0,0 +1,214 @@
+#include "Test.hpp"
+#include <viverna/ecs/Family.hpp>
+#include <viverna/ecs/World.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Archetype storage under churn: entities created and removed, components
+// added and removed (moving rows between archetypes and across chunks), must
+// read the same as the sparse set storage doing the same operations
+
+namespace {
+using namespace verna;
+
+constexpr uint32_t OPERATIONS = 20000;
+constexpr size_t INITIAL_ENTITIES = 3000;
+
+struct Position {
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+struct Velocity {
+    uint32_t value = 0;
+};
+// a few dozen rows per chunk, so that chunk boundaries are crossed often
+struct Payload {
+    std::array<uint32_t, 128> values{};
+};
+
+bool operator==(const Position& a, const Position& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+bool operator==(const Velocity& a, const Velocity& b) {
+    return a.value == b.value;
+}
+bool operator==(const Payload& a, const Payload& b) {
+    return a.values == b.values;
+}
+
+Payload MakePayload(uint32_t value) {
+    Payload payload;
+    for (uint32_t i = 0; i < payload.values.size(); i++)
+        payload.values[i] = value + i;
+    return payload;
+}
+
+// Both worlds get the same operations, and hand out the same handles
+struct Worlds {
+    World sparse{WorldStorage::SparseSet};
+    World archetype{WorldStorage::Archetype};
+    std::vector<Entity> alive;
+
+    Entity NewEntity() {
+        Entity e = sparse.NewEntity<>();
+        VERNA_CHECK(archetype.NewEntity<>() == e);
+        alive.push_back(e);
+        return e;
+    }
+    void RemoveEntity(size_t index) {
+        sparse.RemoveEntity(alive[index]);
+        archetype.RemoveEntity(alive[index]);
+        alive[index] = alive.back();
+        alive.pop_back();
+    }
+    template <typename C>
+    void SetComponent(Entity e, const C& component) {
+        sparse.SetComponent(e, component);
+        archetype.SetComponent(e, component);
+    }
+    template <typename C>
+    void RemoveComponent(Entity e) {
+        sparse.RemoveComponent<C>(e);
+        archetype.RemoveComponent<C>(e);
+    }
+};
+
+template <typename C>
+void CheckComponent(const Worlds& worlds, Entity e) {
+    bool has = worlds.sparse.HasComponent<C>(e);
+    VERNA_CHECK(worlds.archetype.HasComponent<C>(e) == has);
+    if (has)
+        VERNA_CHECK(worlds.archetype.GetComponent<C>(e)
+                    == worlds.sparse.GetComponent<C>(e));
+}
+
+std::vector<Entity> Sorted(std::vector<Entity> entities) {
+    std::sort(entities.begin(), entities.end());
+    return entities;
+}
+
+template <typename... Comps>
+void CheckFamily(const Worlds& worlds) {
+    Family family = Family::From<Comps...>();
+    std::vector<Entity> sparse =
+        Sorted(worlds.sparse.GetEntitiesInFamily(family));
+    std::vector<Entity> archetype =
+        Sorted(worlds.archetype.GetEntitiesInFamily(family));
+    VERNA_CHECK(archetype == sparse);
+    // every entity appears once
+    VERNA_CHECK(std::adjacent_find(archetype.begin(), archetype.end())
+                == archetype.end());
+}
+
+// (entity, velocity, first payload value) of every entity with both
+std::vector<std::tuple<Entity, uint32_t, uint32_t>> VisitMoving(
+    const World& world) {
+    std::vector<std::tuple<Entity, uint32_t, uint32_t>> visited;
+    world.ForEach<Velocity, Payload>(
+        [&](Entity e, const Velocity& velocity, const Payload& payload) {
+            visited.emplace_back(e, velocity.value, payload.values[0]);
+        });
+    std::sort(visited.begin(), visited.end());
+    return visited;
+}
+
+void Check(Worlds& worlds) {
+    for (Entity e : worlds.alive) {
+        VERNA_CHECK(worlds.archetype.IsAlive(e));
+        CheckComponent<Position>(worlds, e);
+        CheckComponent<Velocity>(worlds, e);
+        CheckComponent<Payload>(worlds, e);
+    }
+    CheckFamily<Position>(worlds);
+    CheckFamily<Velocity>(worlds);
+    CheckFamily<Payload>(worlds);
+    CheckFamily<Position, Velocity>(worlds);
+    CheckFamily<Position, Velocity, Payload>(worlds);
+    VERNA_CHECK(VisitMoving(worlds.archetype) == VisitMoving(worlds.sparse));
+
+    // writes through the view land in the same entities
+    auto move = [](Entity e, Position& position, const Velocity& velocity) {
+        position.x += static_cast<float>(velocity.value);
+        position.y = static_cast<float>(e.id);
+    };
+    worlds.sparse.ForEach<Position, const Velocity>(move);
+    worlds.archetype.ForEach<Position, const Velocity>(move);
+    size_t visited = 0;
+    worlds.archetype.View<Position>().ForEach([&](Entity e, Position& p) {
+        VERNA_CHECK(p == worlds.sparse.GetComponent<Position>(e));
+        visited++;
+    });
+    VERNA_CHECK(visited
+                == worlds.sparse.GetEntitiesWithComponent<Position>().size());
+}
+
+void Churn(Worlds& worlds, std::mt19937& rng) {
+    for (uint32_t op = 0; op < OPERATIONS; op++) {
+        uint32_t value = op * 7 + 1;
+        size_t index = worlds.alive.empty() ? 0 : rng() % worlds.alive.size();
+        switch (rng() % 8) {
+            case 0: {
+                Entity e = worlds.NewEntity();
+                worlds.SetComponent(e, Position{1.0f * value, 0.0f, 0.0f});
+                if (rng() % 2 == 0)
+                    worlds.SetComponent(e, MakePayload(value));
+                break;
+            }
+            case 1:
+            case 2:
+                if (!worlds.alive.empty())
+                    worlds.RemoveEntity(index);
+                break;
+            case 3:
+                if (!worlds.alive.empty())
+                    worlds.SetComponent(worlds.alive[index], Velocity{value});
+                break;
+            case 4:
+                if (!worlds.alive.empty())
+                    worlds.SetComponent(worlds.alive[index],
+                                        MakePayload(value));
+                break;
+            case 5:
+                if (!worlds.alive.empty())
+                    worlds.RemoveComponent<Velocity>(worlds.alive[index]);
+                break;
+            case 6:
+                if (!worlds.alive.empty())
+                    worlds.RemoveComponent<Payload>(worlds.alive[index]);
+                break;
+            default:
+                if (!worlds.alive.empty())
+                    worlds.RemoveComponent<Position>(worlds.alive[index]);
+                break;
+        }
+        if (op % 2000 == 0)
+            Check(worlds);
+    }
+}
+}  // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    Worlds worlds;
+    for (size_t i = 0; i < INITIAL_ENTITIES; i++) {
+        Entity e = worlds.NewEntity();
+        worlds.SetComponent(e, Position{static_cast<float>(i), 0.0f, 0.0f});
+        if (i % 2 == 0)
+            worlds.SetComponent(e, Velocity{static_cast<uint32_t>(i)});
+        if (i % 3 == 0)
+            worlds.SetComponent(e, MakePayload(static_cast<uint32_t>(i)));
+    }
+    Check(worlds);
+    Churn(worlds, rng);
+    Check(worlds);
+    // empty the worlds from the front, moving the last rows every time
+    while (!worlds.alive.empty())
+        worlds.RemoveEntity(0);
+    Check(worlds);
+    VERNA_CHECK(worlds.archetype.GetEntitiesWithComponent<Position>().empty());
+    return test::Result();
+}
@@ -0,0 +1,95 @@
+#include "Test.hpp"
+#include <viverna/ecs/ComponentBuffer.hpp>
+#include <viverna/ecs/World.hpp>
+
+#include <cstdint>
+
+// Removed entities give their id back with a new generation: the old handle
+// becomes stale, and must neither see nor modify the new entity's data
+
+namespace {
+using namespace verna;
+
+struct Health {
+    int32_t value = 0;
+};
+struct Armor {
+    int32_t value = 0;
+};
+
+void CheckWorld(WorldStorage storage) {
+    World world(storage);
+    Entity old = world.NewEntity<>();
+    world.SetComponent(old, Health{1});
+    world.RemoveEntity(old);
+    VERNA_CHECK(!world.IsAlive(old));
+
+    Entity recycled = world.NewEntity<>();
+    VERNA_CHECK(recycled.id == old.id);
+    VERNA_CHECK(recycled.generation == old.generation + 1);
+    VERNA_CHECK(recycled != old);
+    VERNA_CHECK(world.IsAlive(recycled));
+    // the removed entity's components are gone with it
+    VERNA_CHECK(!world.HasComponent<Health>(recycled));
+    world.SetComponent(recycled, Health{2});
+
+    VERNA_CHECK(!world.HasComponent<Health>(old));
+    VERNA_CHECK(world.GetComponent<Health>(old).value == 0);
+    // writes through the stale handle are dropped, existing component or not
+    world.SetComponent(old, Health{3});
+    world.SetComponent(old, Armor{3});
+    VERNA_CHECK(world.GetComponent<Health>(recycled).value == 2);
+    VERNA_CHECK(!world.HasComponent<Armor>(recycled));
+    VERNA_CHECK(world.GetEntitiesWithComponent<Armor>().empty());
+    // and so are removals
+    world.RemoveComponent<Health>(old);
+    VERNA_CHECK(world.HasComponent<Health>(recycled));
+    world.RemoveEntity(old);
+    VERNA_CHECK(world.IsAlive(recycled));
+    VERNA_CHECK(world.GetComponent<Health>(recycled).value == 2);
+
+    // every recycling bumps the generation once
+    Entity e = recycled;
+    for (int i = 0; i < 4; i++) {
+        world.RemoveEntity(e);
+        Entity next = world.NewEntity<Health>();
+        VERNA_CHECK(next.id == e.id);
+        VERNA_CHECK(next.generation == e.generation + 1);
+        VERNA_CHECK(!world.IsAlive(e));
+        VERNA_CHECK(!world.HasComponent<Health>(e));
+        e = next;
+    }
+    VERNA_CHECK(!world.IsAlive(old));
+    VERNA_CHECK(world.GetEntitiesWithComponent<Health>().size() == 1);
+
+    // never created entities aren't alive either
+    VERNA_CHECK(!world.IsAlive(Entity()));
+    VERNA_CHECK(!world.IsAlive(Entity(e.id + 1)));
+}
+
+void CheckBuffer() {
+    ComponentBuffer<Health> buffer;
+    Entity old(1, 0);
+    Entity recycled(1, 1);
+    VERNA_CHECK(!buffer.SetComponent(old, Health{1}));
+    VERNA_CHECK(buffer.Remove(old));
+    VERNA_CHECK(!buffer.SetComponent(recycled, Health{2}));
+
+    VERNA_CHECK(!buffer.Contains(old));
+    VERNA_CHECK(buffer.Contains(recycled));
+    VERNA_CHECK(buffer.GetComponent(old).value == 0);
+    // the id is taken by the recycled entity: nothing is written
+    VERNA_CHECK(!buffer.SetComponent(old, Health{3}));
+    VERNA_CHECK(buffer.GetComponent(recycled).value == 2);
+    VERNA_CHECK(buffer.GetComponents().size() == 1);
+    VERNA_CHECK(!buffer.Remove(old));
+    VERNA_CHECK(buffer.Contains(recycled));
+}
+}  // namespace
+
+int main() {
+    CheckWorld(WorldStorage::SparseSet);
+    CheckWorld(WorldStorage::Archetype);
+    CheckBuffer();
+    return test::Result();
+}
@@ -0,0 +1,162 @@
+#include "Test.hpp"
+#include "FrustumCulling.hpp"
+#include <viverna/core/BoundingBox.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include <viverna/maths/Vec3f.hpp>
+#include <viverna/maths/Vec4f.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// CullingBoxes::Cull against a box-by-box reference: box counts that don't
+// fill the last SIMD vector, boxes crossing each plane of the frustum at
+// every lane position, and boxes around a random camera
+
+namespace {
+using namespace verna;
+
+constexpr size_t RANDOM_BOXES = 1001;
+constexpr uint8_t UNTOUCHED = 0xAA;
+
+enum class Expected { Visible, Culled, Either };
+
+double Distance(const Vec4f& plane, double x, double y, double z) {
+    return plane.x * x + plane.y * y + plane.z * z + plane.w;
+}
+
+// Culled if all eight corners are outside the same plane. Boxes touching a
+// plane may go either way, the kernel rounds differently
+Expected Reference(const Frustum& frustum, const BoundingBox& box) {
+    Vec3f min = box.MinPosition();
+    Vec3f max = box.MaxPosition();
+    bool either = false;
+    for (const Vec4f& plane : frustum.planes) {
+        double farthest = -INFINITY;
+        double scale = std::abs(plane.w);
+        for (int corner = 0; corner < 8; corner++) {
+            double x = (corner & 1) ? max.x : min.x;
+            double y = (corner & 2) ? max.y : min.y;
+            double z = (corner & 4) ? max.z : min.z;
+            farthest = std::max(farthest, Distance(plane, x, y, z));
+            scale += std::abs(plane.x * x) + std::abs(plane.y * y)
+                     + std::abs(plane.z * z);
+        }
+        if (std::abs(farthest) <= 1e-5 * scale)
+            either = true;
+        else if (farthest < 0.0)
+            return Expected::Culled;
+    }
+    return either ? Expected::Either : Expected::Visible;
+}
+
+void CheckCull(const Frustum& frustum, const std::vector<BoundingBox>& boxes) {
+    CullingBoxes culling;
+    for (const BoundingBox& box : boxes)
+        culling.Add(box);
+    VERNA_CHECK(culling.Size() == boxes.size());
+    // one more, to catch writes past Size()
+    std::vector<uint8_t> visible(boxes.size() + 1, UNTOUCHED);
+    size_t culled = culling.Cull(frustum, visible.data());
+    size_t zeros = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        VERNA_CHECK(visible[i] <= 1);
+        zeros += visible[i] == 0;
+        Expected expected = Reference(frustum, boxes[i]);
+        if (expected != Expected::Either)
+            VERNA_CHECK(visible[i] == (expected == Expected::Visible));
+    }
+    VERNA_CHECK(culled == zeros);
+    VERNA_CHECK(visible.back() == UNTOUCHED);
+}
+
+// Cubes centered at the projection of inside onto each plane, then moved
+// along its normal: from well outside to well inside
+std::vector<BoundingBox> StraddlingBoxes(const Frustum& frustum,
+                                         const Vec3f& inside,
+                                         float half_size) {
+    std::vector<BoundingBox> boxes;
+    for (const Vec4f& plane : frustum.planes) {
+        Vec3f normal(plane.x, plane.y, plane.z);
+        float length = normal.Magnitude();
+        normal = normal.Normalized();
+        float distance = normal.Dot(inside) + plane.w / length;
+        Vec3f on_plane = inside - distance * normal;
+        for (float offset : {-3.0f, -1.5f, -0.5f, 0.0f, 0.5f, 1.5f, 3.0f}) {
+            Vec3f center = on_plane + offset * half_size * normal;
+            boxes.emplace_back(center, half_size, half_size, half_size);
+        }
+    }
+    return boxes;
+}
+
+// Every count from 0 to a few vectors, starting at every box, so that each
+// box falls in every lane and in the scalar tail
+void CheckCounts(const Frustum& frustum, const std::vector<BoundingBox>& pool) {
+    for (size_t count = 0; count <= 3 * CullingBoxes::LANES + 1; count++) {
+        for (size_t start = 0; start < pool.size(); start++) {
+            std::vector<BoundingBox> boxes;
+            for (size_t i = 0; i < count; i++)
+                boxes.push_back(pool[(start + i) % pool.size()]);
+            CheckCull(frustum, boxes);
+        }
+    }
+}
+
+// Box-shaped view volume, so the expected results are known exactly
+void CheckOrtho() {
+    Mat4f pv = Mat4f::Ortho(-4.0f, 6.0f, 3.0f, -2.0f, 1.0f, 9.0f);
+    Frustum frustum = Frustum::FromMatrix(pv);
+    Vec3f inside(1.0f, 0.5f, 5.0f);
+    std::vector<BoundingBox> boxes = StraddlingBoxes(frustum, inside, 0.25f);
+    CullingBoxes culling;
+    for (const BoundingBox& box : boxes)
+        culling.Add(box);
+    std::vector<uint8_t> visible(boxes.size());
+    culling.Cull(frustum, visible.data());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        // only the offsets that leave the whole cube outside
+        size_t offset = i % 7;
+        bool outside = offset < 2;
+        VERNA_CHECK(visible[i] == !outside);
+        VERNA_CHECK(Reference(frustum, boxes[i])
+                    == (outside ? Expected::Culled : Expected::Visible));
+    }
+    CheckCounts(frustum, boxes);
+}
+
+void CheckPerspective() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+    std::uniform_real_distribution<float> extent(0.01f, 4.0f);
+    Vec3f eye(position(rng), position(rng), position(rng));
+    Vec3f target(position(rng), position(rng), position(rng));
+    Mat4f view = Mat4f::LookAt(eye, target, Vec3f(0.0f, 1.0f, 0.0f));
+    Mat4f pv = Mat4f::Perspective(1.1f, 1.6f, 0.5f, 50.0f) * view;
+    Frustum frustum = Frustum::FromMatrix(pv);
+
+    Vec3f forward = (target - eye).Normalized();
+    std::vector<BoundingBox> pool =
+        StraddlingBoxes(frustum, eye + 10.0f * forward, 0.2f);
+    CheckCounts(frustum, pool);
+    while (pool.size() < RANDOM_BOXES) {
+        Vec3f min(position(rng), position(rng), position(rng));
+        Vec3f size(extent(rng), extent(rng), extent(rng));
+        pool.emplace_back(min, size);
+    }
+    CheckCull(frustum, pool);
+    // and without a scalar tail
+    pool.pop_back();
+    VERNA_CHECK(pool.size() % CullingBoxes::LANES == 0);
+    CheckCull(frustum, pool);
+}
+}  // namespace
+
+int main() {
+    CheckOrtho();
+    CheckPerspective();
+    return test::Result();
+}
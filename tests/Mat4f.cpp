@@ -0,0 +1,165 @@
+#include "Test.hpp"
+#include <viverna/core/Transform.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include <viverna/maths/Quaternion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// The runtime kernels (SSE/NEON unless VIVERNA_SIMD=OFF) against the scalar
+// code, which constant expressions always use: Mat4f inversion,
+// transposition and product, Transform::GetMatrix and Quaternion::AsMatrix
+
+namespace {
+using namespace verna;
+
+constexpr size_t COUNT = 32;
+// largest element of M * M.Inverted() - I
+constexpr float MAX_RESIDUAL = 2e-4f;
+
+// well conditioned random matrices: elements in [-1, 1], plus 2 on the
+// diagonal
+constexpr std::array<Mat4f, COUNT> RandomMatrices() {
+    std::array<Mat4f, COUNT> result{};
+    uint32_t state = 12345;
+    for (size_t i = 0; i < COUNT; i++) {
+        for (size_t j = 0; j < 16; j++) {
+            state = state * 1664525u + 1013904223u;
+            float unit = static_cast<float>(state >> 8) / 16777216.0f;
+            result[i][j] = 2.0f * unit - 1.0f + (j % 5 == 0 ? 2.0f : 0.0f);
+        }
+    }
+    return result;
+}
+
+constexpr std::array<Mat4f, COUNT> MATRICES = RandomMatrices();
+
+// random transforms: unit rotations ((2v, 1 - |v|^2) / (1 + |v|^2) for v
+// in [-1, 1]^3, which needs no square root), positions in [-10, 10], scales
+// in [0.5, 2]
+constexpr std::array<Transform, COUNT> RandomTransforms() {
+    std::array<Transform, COUNT> result{};
+    uint32_t state = 67890;
+    auto random = [&state](float min, float max) {
+        state = state * 1664525u + 1013904223u;
+        float unit = static_cast<float>(state >> 8) / 16777216.0f;
+        return min + (max - min) * unit;
+    };
+    for (Transform& t : result) {
+        float a = random(-1.0f, 1.0f);
+        float b = random(-1.0f, 1.0f);
+        float c = random(-1.0f, 1.0f);
+        float squared = a * a + b * b + c * c;
+        float inverse = 1.0f / (1.0f + squared);
+        t.rotation = Quaternion(2.0f * a * inverse, 2.0f * b * inverse,
+                                2.0f * c * inverse, (1.0f - squared) * inverse);
+        t.position = Vec3f(random(-10.0f, 10.0f), random(-10.0f, 10.0f),
+                           random(-10.0f, 10.0f));
+        t.scale = Vec3f(random(0.5f, 2.0f), random(0.5f, 2.0f),
+                        random(0.5f, 2.0f));
+    }
+    return result;
+}
+
+constexpr std::array<Transform, COUNT> TRANSFORMS = RandomTransforms();
+
+constexpr std::array<Mat4f, COUNT> ScalarInverses() {
+    std::array<Mat4f, COUNT> result{};
+    for (size_t i = 0; i < COUNT; i++)
+        result[i] = MATRICES[i].Inverted();
+    return result;
+}
+
+constexpr std::array<Mat4f, COUNT> ScalarTransposes() {
+    std::array<Mat4f, COUNT> result{};
+    for (size_t i = 0; i < COUNT; i++)
+        result[i] = MATRICES[i].Transposed();
+    return result;
+}
+
+constexpr std::array<Mat4f, COUNT> ScalarProducts() {
+    std::array<Mat4f, COUNT> result{};
+    for (size_t i = 0; i < COUNT; i++)
+        result[i] = MATRICES[i] * MATRICES[(i + 1) % COUNT];
+    return result;
+}
+
+constexpr std::array<Mat4f, COUNT> ScalarTransformMatrices() {
+    std::array<Mat4f, COUNT> result{};
+    for (size_t i = 0; i < COUNT; i++)
+        result[i] = TRANSFORMS[i].GetMatrix();
+    return result;
+}
+
+constexpr std::array<Mat4f, COUNT> ScalarRotationMatrices() {
+    std::array<Mat4f, COUNT> result{};
+    for (size_t i = 0; i < COUNT; i++)
+        result[i] = TRANSFORMS[i].rotation.AsMatrix();
+    return result;
+}
+
+// evaluated at compile time, so by the scalar code
+constexpr std::array<Mat4f, COUNT> SCALAR_INVERSES = ScalarInverses();
+constexpr std::array<Mat4f, COUNT> SCALAR_TRANSPOSES = ScalarTransposes();
+constexpr std::array<Mat4f, COUNT> SCALAR_PRODUCTS = ScalarProducts();
+constexpr std::array<Mat4f, COUNT> SCALAR_TRANSFORM_MATRICES =
+    ScalarTransformMatrices();
+constexpr std::array<Mat4f, COUNT> SCALAR_ROTATION_MATRICES =
+    ScalarRotationMatrices();
+
+bool Same(const Mat4f& a, const Mat4f& b) {
+    return a.raw == b.raw;
+}
+
+float MaxDifference(const Mat4f& a, const Mat4f& b) {
+    float result = 0.0f;
+    for (size_t i = 0; i < 16; i++)
+        result = std::max(result, std::abs(a[i] - b[i]));
+    return result;
+}
+
+float Residual(const Mat4f& matrix, const Mat4f& inverse) {
+    return MaxDifference(matrix * inverse, Mat4f::Identity());
+}
+}  // namespace
+
+int main() {
+    std::array<Mat4f, COUNT> inverses;
+    Mat4f::InvertMany(MATRICES.data(), inverses.data(), COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        const Mat4f& m = MATRICES[i];
+        Mat4f inverse = m.Inverted();
+        VERNA_CHECK(Residual(m, inverse) <= MAX_RESIDUAL);
+        VERNA_CHECK(Residual(m, SCALAR_INVERSES[i]) <= MAX_RESIDUAL);
+        VERNA_CHECK(MaxDifference(inverse, SCALAR_INVERSES[i]) <= MAX_RESIDUAL);
+        // the transposed inverse only skips the transposition
+        VERNA_CHECK(Same(m.InvertedTransposed().Transposed(), inverse));
+        VERNA_CHECK(Same(inverses[i], inverse));
+
+        VERNA_CHECK(Same(m.Transposed(), SCALAR_TRANSPOSES[i]));
+        Mat4f product = m * MATRICES[(i + 1) % COUNT];
+#if defined(__FMA__)
+        VERNA_CHECK(MaxDifference(product, SCALAR_PRODUCTS[i]) <= 1e-5f);
+#else
+        // same operations in the same order
+        VERNA_CHECK(Same(product, SCALAR_PRODUCTS[i]));
+#endif
+
+        const Transform& t = TRANSFORMS[i];
+        Mat4f transform_matrix = t.GetMatrix();
+        Mat4f rotation_matrix = t.rotation.AsMatrix();
+#if defined(__FMA__)
+        VERNA_CHECK(MaxDifference(transform_matrix,
+                                  SCALAR_TRANSFORM_MATRICES[i])
+                    <= 1e-5f);
+        VERNA_CHECK(MaxDifference(rotation_matrix, SCALAR_ROTATION_MATRICES[i])
+                    <= 1e-5f);
+#else
+        VERNA_CHECK(Same(transform_matrix, SCALAR_TRANSFORM_MATRICES[i]));
+        VERNA_CHECK(Same(rotation_matrix, SCALAR_ROTATION_MATRICES[i]));
+#endif
+    }
+    return test::Result();
+}
@@ -0,0 +1,167 @@
+#include "Test.hpp"
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/maths/Vec3f.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+// Levels of detail of open grids, flat and bumpy: the simplified index lists
+// must stay valid triangle lists of the same surface, with the same border
+
+namespace {
+using namespace verna;
+
+constexpr int SIZE = 48;
+// neighbours of a position, see MeshSimplifier.cpp
+constexpr size_t MAX_VALENCE = 12;
+// allowed distance from the original surface, in max errors: the error
+// bound is a mean over planes, not a maximum
+constexpr float ERROR_TOLERANCE = 3.0f;
+
+float Height(float bump, int x, int y) {
+    return bump * std::sin(0.3f * x) * std::cos(0.2f * y);
+}
+
+// SIZE * SIZE quads on the xz plane, facing up
+Mesh Grid(float bump) {
+    Mesh mesh;
+    for (int y = 0; y <= SIZE; y++) {
+        for (int x = 0; x <= SIZE; x++) {
+            Vertex v;
+            v.position = Vec3f(x, Height(bump, x, y), y);
+            v.normal = Vec3f(0.0f, 1.0f, 0.0f);
+            mesh.vertices.push_back(v);
+        }
+    }
+    const Mesh::index_t row = SIZE + 1;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            Mesh::index_t i = y * row + x;
+            mesh.indices.insert(mesh.indices.end(), {i, i + row, i + row + 1,
+                                                     i, i + row + 1, i + 1});
+        }
+    }
+    mesh.RecalculateBounds();
+    return mesh;
+}
+
+bool OnBorder(const Vec3f& p) {
+    return p.x == 0.0f || p.x == SIZE || p.z == 0.0f || p.z == SIZE;
+}
+
+bool SameBorder(const Vec3f& a, const Vec3f& b) {
+    return (a.x == b.x && (a.x == 0.0f || a.x == SIZE))
+           || (a.z == b.z && (a.z == 0.0f || a.z == SIZE));
+}
+
+void CheckTriangles(const Mesh& mesh, const std::vector<Mesh::index_t>& lod) {
+    VERNA_CHECK(lod.size() % 3 == 0);
+    std::set<std::array<Mesh::index_t, 3>> triangles;
+    std::map<std::pair<Mesh::index_t, Mesh::index_t>, int> edge_uses;
+    std::map<Mesh::index_t, std::set<Mesh::index_t>> neighbours;
+    for (size_t i = 0; i + 2 < lod.size(); i += 3) {
+        std::array<Mesh::index_t, 3> t = {lod[i], lod[i + 1], lod[i + 2]};
+        bool in_range = true;
+        for (Mesh::index_t index : t)
+            in_range = in_range && index < mesh.vertices.size();
+        if (!VERNA_CHECK(in_range))
+            return;
+        const Vec3f& a = mesh.vertices[t[0]].position;
+        const Vec3f& b = mesh.vertices[t[1]].position;
+        const Vec3f& c = mesh.vertices[t[2]].position;
+        // up, as the original ones: not degenerate nor flipped
+        VERNA_CHECK((b - a).Cross(c - a).y > 0.0f);
+        std::array<Mesh::index_t, 3> sorted = t;
+        std::sort(sorted.begin(), sorted.end());
+        VERNA_CHECK(triangles.insert(sorted).second);
+        for (size_t k = 0; k < 3; k++) {
+            Mesh::index_t u = t[k];
+            Mesh::index_t v = t[(k + 1) % 3];
+            edge_uses[{std::min(u, v), std::max(u, v)}]++;
+            neighbours[u].insert(v);
+            neighbours[v].insert(u);
+        }
+    }
+    for (const auto& [edge, uses] : edge_uses) {
+        // manifold, and border edges run along the border of the grid
+        VERNA_CHECK(uses <= 2);
+        if (uses == 1)
+            VERNA_CHECK(SameBorder(mesh.vertices[edge.first].position,
+                                   mesh.vertices[edge.second].position));
+    }
+    for (const auto& [vertex, others] : neighbours)
+        VERNA_CHECK(others.size() <= MAX_VALENCE
+                    || OnBorder(mesh.vertices[vertex].position));
+}
+
+// Vertical distance of the original vertices from the simplified surface,
+// which stays a height field
+float MaxDistance(const Mesh& mesh, const std::vector<Mesh::index_t>& lod) {
+    float result = 0.0f;
+    for (const Vertex& vertex : mesh.vertices) {
+        const Vec3f& p = vertex.position;
+        float distance = INFINITY;
+        for (size_t i = 0; i + 2 < lod.size(); i += 3) {
+            const Vec3f& a = mesh.vertices[lod[i]].position;
+            const Vec3f& b = mesh.vertices[lod[i + 1]].position;
+            const Vec3f& c = mesh.vertices[lod[i + 2]].position;
+            // barycentric coordinates on the xz plane
+            float det = (b.x - a.x) * (c.z - a.z) - (c.x - a.x) * (b.z - a.z);
+            float u = ((p.x - a.x) * (c.z - a.z) - (c.x - a.x) * (p.z - a.z))
+                      / det;
+            float v = ((b.x - a.x) * (p.z - a.z) - (p.x - a.x) * (b.z - a.z))
+                      / det;
+            if (u < -1e-4f || v < -1e-4f || u + v > 1.0f + 1e-4f)
+                continue;
+            float height = a.y + u * (b.y - a.y) + v * (c.y - a.y);
+            distance = std::min(distance, std::abs(height - p.y));
+        }
+        result = std::max(result, distance);
+    }
+    return result;
+}
+
+void CheckLods(float bump) {
+    Mesh mesh = Grid(bump);
+    mesh.GenerateLods();
+    VERNA_CHECK(mesh.LodCount() == Mesh::MAX_LODS);
+    for (uint32_t lod = 1; lod < mesh.LodCount(); lod++) {
+        size_t previous = mesh.LodIndices(lod - 1).size();
+        size_t current = mesh.LodIndices(lod).size();
+        // about half: the target is half, rounded down to a triangle
+        VERNA_CHECK(current <= previous / 2);
+        VERNA_CHECK(current * 5 >= previous * 2);
+        CheckTriangles(mesh, mesh.LodIndices(lod));
+    }
+}
+
+void CheckMaxError() {
+    Mesh mesh = Grid(1.0f);
+    const float diagonal = mesh.bounds.Size().Magnitude();
+    float previous_size = mesh.indices.size();
+    for (float relative_error : {0.001f, 0.01f, 0.03f}) {
+        float max_error = relative_error * diagonal;
+        std::vector<Mesh::index_t> lod =
+            SimplifyIndices(mesh.vertices, mesh.indices, 0, max_error);
+        CheckTriangles(mesh, lod);
+        VERNA_CHECK(MaxDistance(mesh, lod) <= ERROR_TOLERANCE * max_error);
+        // stopped by the error, not by the target, yet simplified more
+        // with a larger error
+        VERNA_CHECK(!lod.empty());
+        VERNA_CHECK(lod.size() < previous_size);
+        previous_size = lod.size();
+    }
+}
+}  // namespace
+
+int main() {
+    CheckLods(0.0f);
+    CheckLods(1.0f);
+    CheckMaxError();
+    return test::Result();
+}
@@ -0,0 +1,89 @@
+#include "Test.hpp"
+#include "OcclusionCulling.hpp"
+#include <viverna/core/BoundingBox.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/maths/Mat4f.hpp>
+#include <viverna/maths/Vec3f.hpp>
+
+// One quad occluder in front of boxes placed from pixel coordinates, close
+// to its edges: only boxes entirely behind it may be culled
+
+namespace {
+using namespace verna;
+
+constexpr uint32_t WIDTH = 256;
+constexpr uint32_t HEIGHT = 128;
+constexpr float QUAD_Z = 10.0f;
+// silhouette of the quad, in texels: the edges cross texels 20, 152, 40
+// and 90 in the middle
+constexpr float QUAD_LEFT = 20.3f;
+constexpr float QUAD_RIGHT = 152.8f;
+constexpr float QUAD_BOTTOM = 40.3f;
+constexpr float QUAD_TOP = 90.7f;
+
+// the camera looks towards +z from the origin, so w is z
+const Mat4f PV = Mat4f::Perspective(1.0f, 2.0f, 0.1f, 100.0f);
+
+float WorldX(float pixel, float z) {
+    return (pixel / (0.5f * WIDTH) - 1.0f) * z / PV[0];
+}
+
+float WorldY(float pixel, float z) {
+    return (pixel / (0.5f * HEIGHT) - 1.0f) * z / PV[5];
+}
+
+Mesh Quad() {
+    Mesh quad;
+    quad.vertices.resize(4);
+    quad.vertices[0].position =
+        Vec3f(WorldX(QUAD_LEFT, QUAD_Z), WorldY(QUAD_BOTTOM, QUAD_Z), QUAD_Z);
+    quad.vertices[1].position =
+        Vec3f(WorldX(QUAD_RIGHT, QUAD_Z), WorldY(QUAD_BOTTOM, QUAD_Z), QUAD_Z);
+    quad.vertices[2].position =
+        Vec3f(WorldX(QUAD_RIGHT, QUAD_Z), WorldY(QUAD_TOP, QUAD_Z), QUAD_Z);
+    quad.vertices[3].position =
+        Vec3f(WorldX(QUAD_LEFT, QUAD_Z), WorldY(QUAD_TOP, QUAD_Z), QUAD_Z);
+    quad.indices = {0, 1, 2, 0, 2, 3};
+    return quad;
+}
+
+// Box from z_near to z_far whose nearest face spans the given pixels
+BoundingBox Box(float x0,
+                float x1,
+                float y0,
+                float y1,
+                float z_near,
+                float z_far) {
+    Vec3f min(WorldX(x0, z_near), WorldY(y0, z_near), z_near);
+    Vec3f max(WorldX(x1, z_near), WorldY(y1, z_near), z_far);
+    return BoundingBox(min, max - min);
+}
+}  // namespace
+
+int main() {
+    OcclusionBuffer buffer;
+    buffer.Resize(WIDTH, HEIGHT);
+    Mesh quad = Quad();
+
+    // nothing is occluded before the first frame
+    VERNA_CHECK(buffer.IsVisible(Box(130.0f, 140.0f, 64.0f, 70.0f, 20, 21)));
+
+    buffer.Begin(PV);
+    buffer.AddOccluder(quad, Mat4f::Identity());
+    buffer.Finish();
+
+    // behind the quad, inside its fully covered texels
+    VERNA_CHECK(!buffer.IsVisible(Box(144.0f, 151.5f, 64.0f, 71.0f, 20, 21)));
+    // same, in front of it
+    VERNA_CHECK(buffer.IsVisible(Box(144.0f, 151.5f, 64.0f, 71.0f, 5, 6)));
+    // just past the right edge, in the texel it partly covers: the center of
+    // texel 152 is inside the quad, the box isn't
+    VERNA_CHECK(
+        buffer.IsVisible(Box(152.85f, 152.95f, 64.2f, 64.8f, 20.0f, 20.1f)));
+    // just past the top edge
+    VERNA_CHECK(
+        buffer.IsVisible(Box(100.2f, 100.8f, 90.75f, 90.95f, 20.0f, 20.1f)));
+    // well outside
+    VERNA_CHECK(buffer.IsVisible(Box(160.0f, 170.0f, 64.0f, 70.0f, 20, 21)));
+    return test::Result();
+}
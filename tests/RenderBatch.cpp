@@ -0,0 +1,93 @@
+#include "Test.hpp"
+#include "RenderBatch.hpp"
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/graphics/gpu/DrawCommand.hpp>
+#include <viverna/graphics/gpu/MeshData.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Indirect commands built on the CPU: instances of the same mesh and level
+// of detail share a draw, and every draw reads a contiguous instance range
+
+namespace {
+using namespace verna;
+
+struct Submission {
+    const Mesh* mesh;
+    MeshLocation location;
+};
+
+bool SameCommand(const gpu::DrawCommand& cmd,
+                 uint32_t count,
+                 uint32_t instance_count,
+                 uint32_t first_index,
+                 int32_t base_vertex,
+                 uint32_t base_instance) {
+    return cmd.count == count && cmd.instance_count == instance_count
+           && cmd.first_index == first_index && cmd.base_vertex == base_vertex
+           && cmd.base_instance == base_instance;
+}
+
+void CheckBatch(RenderBatch& batch, const std::vector<Submission>& frame) {
+    for (size_t i = 0; i < frame.size(); i++) {
+        // tagged with the submission index
+        gpu::MeshData instance{};
+        instance.material.parameters[0] = static_cast<float>(i);
+        batch.AddInstance(*frame[i].mesh, frame[i].location, instance);
+    }
+
+    // instances of an earlier batch come first in the frame's buffer
+    constexpr uint32_t FIRST_INSTANCE = 100;
+    std::vector<gpu::MeshData> sorted(batch.instances.size());
+    batch.SortInstances(sorted.data(), FIRST_INSTANCE);
+    std::vector<gpu::DrawCommand> commands(batch.draws.size());
+    batch.WriteCommands(commands.data());
+
+    // cube lod 0, quad, cube lod 1, then one draw per transient mesh
+    if (!VERNA_CHECK(commands.size() == 5))
+        return;
+    VERNA_CHECK(SameCommand(commands[0], 36, 3, 0, 0, 100));
+    VERNA_CHECK(SameCommand(commands[1], 6, 2, 48, 30, 103));
+    VERNA_CHECK(SameCommand(commands[2], 12, 1, 36, 0, 105));
+    VERNA_CHECK(SameCommand(commands[3], 3, 1, 54, 34, 106));
+    VERNA_CHECK(SameCommand(commands[4], 3, 1, 57, 37, 107));
+
+    // grouped by draw, submission order kept within a draw
+    constexpr std::array<float, 8> expected = {0, 2, 6, 1, 5, 3, 4, 7};
+    if (!VERNA_CHECK(sorted.size() == expected.size()))
+        return;
+    for (size_t i = 0; i < expected.size(); i++)
+        VERNA_CHECK(sorted[i].material.parameters[0] == expected[i]);
+}
+}  // namespace
+
+int main() {
+    Mesh cube;
+    cube.id = 1;
+    Mesh quad;
+    quad.id = 2;
+    // id 0: uploaded again on every use, never instanced
+    Mesh transient;
+
+    // cube has two levels of detail, one index list after the other
+    const MeshLocation cube_lod0 = {0, 0, 36, 0};
+    const MeshLocation cube_lod1 = {0, 36, 12, 1};
+    const MeshLocation quad_lod0 = {30, 48, 6, 0};
+    const MeshLocation transient0 = {34, 54, 3, 0};
+    const MeshLocation transient1 = {37, 57, 3, 0};
+    const std::vector<Submission> frame = {
+        {&cube, cube_lod0}, {&quad, quad_lod0}, {&cube, cube_lod0},
+        {&cube, cube_lod1}, {&transient, transient0}, {&quad, quad_lod0},
+        {&cube, cube_lod0}, {&transient, transient1}};
+
+    RenderBatch batch;
+    CheckBatch(batch, frame);
+    // reused by the next frame
+    batch.Clear();
+    VERNA_CHECK(batch.draws.empty() && batch.instances.empty());
+    VERNA_CHECK(batch.FindDraw(cube, 0) == -1);
+    CheckBatch(batch, frame);
+    return test::Result();
+}
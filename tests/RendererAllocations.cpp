@@ -0,0 +1,119 @@
+#include "Test.hpp"
+#include <viverna/core/Scene.hpp>
+#include <viverna/core/Transform.hpp>
+#include <viverna/core/VivernaInitializer.hpp>
+#include <viverna/graphics/Material.hpp>
+#include <viverna/graphics/Mesh.hpp>
+#include <viverna/graphics/NullBackend.hpp>
+#include <viverna/graphics/Renderer.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Steady state frames must not allocate: batches, buckets, submissions and
+// the per-frame sets keep their capacity between frames
+
+namespace {
+std::atomic<bool> counting = false;
+std::atomic<uint64_t> allocations = 0;
+
+void* Allocate(std::size_t size) noexcept {
+    if (counting.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}  // namespace
+
+// the over-aligned forms keep their default implementation
+void* operator new(std::size_t size) {
+    if (void* ptr = Allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+int main() {
+    using namespace verna;
+    constexpr size_t COUNT = 1000;
+    constexpr int WARM_UP_FRAMES = 5;
+    constexpr int FRAMES = 100;
+
+    VivernaState viverna_state;
+    InitializeViverna(viverna_state);
+    if (!VERNA_CHECK(!viverna_state.GetFlag(VivernaState::ERROR_FLAG)))
+        return test::Result();
+
+    ShaderId shader = Scene::GetActive().shader_manager.LoadShader("unlit");
+    VERNA_CHECK(shader.IsValid());
+    std::array meshes = {LoadPrimitiveMesh(PrimitiveMeshType::Cube),
+                         LoadPrimitiveMesh(PrimitiveMeshType::Pyramid),
+                         LoadPrimitiveMesh(PrimitiveMeshType::Sphere)};
+    std::array<Material, 4> materials;
+    for (size_t i = 0; i < materials.size(); i++)
+        materials[i].parameters[0] = static_cast<float>(i);
+    // grid in front of the default camera
+    constexpr size_t columns = 100;
+    std::vector<Transform> transforms(COUNT);
+    for (size_t i = 0; i < COUNT; i++) {
+        transforms[i].position =
+            Vec3f(static_cast<float>(i % columns) - 0.5f * columns,
+                  static_cast<float>(i / columns) - 0.5f * COUNT / columns,
+                  120.0f);
+    }
+
+    auto frame = [&]() {
+        NextFrame();
+        for (size_t i = 0; i < COUNT; i++) {
+            Render(meshes[i % meshes.size()], materials[i % materials.size()],
+                   transforms[i], shader);
+        }
+        Draw();
+    };
+    for (int i = 0; i < WARM_UP_FRAMES; i++)
+        frame();
+    counting = true;
+    for (int i = 0; i < FRAMES; i++)
+        frame();
+    counting = false;
+
+    uint64_t counted = allocations.load();
+    if (!VERNA_CHECK(counted == 0)) {
+        std::printf("%llu allocations in %d frames\n",
+                    static_cast<unsigned long long>(counted), FRAMES);
+    }
+    VERNA_CHECK(GetNullBackendCounters().instances > 0);
+
+    Scene::GetActive().shader_manager.FreeShader(shader);
+    TerminateViverna(viverna_state);
+    return test::Result();
+}
@@ -0,0 +1,99 @@
+#include "Test.hpp"
+#include <viverna/ecs/Family.hpp>
+#include <viverna/ecs/System.hpp>
+#include <viverna/ecs/World.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// World::RunSystems stages: systems without declared access run alone,
+// readers share a stage, and a system waits for every earlier system it
+// conflicts with
+
+namespace {
+using namespace verna;
+
+struct Position {
+    float x = 0.0f;
+};
+struct Velocity {
+    float x = 0.0f;
+};
+struct Health {
+    int32_t value = 0;
+};
+
+constexpr size_t MAX_SYSTEMS = 8;
+constexpr int RUNS = 4;
+std::atomic<uint32_t> clock_ticks = 0;
+std::array<uint32_t, MAX_SYSTEMS> started{};
+std::array<uint32_t, MAX_SYSTEMS> finished{};
+
+// Records when it starts and ends on a shared clock
+template <size_t N>
+void Record(World&, std::vector<Entity>&) {
+    started[N] = clock_ticks.fetch_add(1);
+    // long enough for an overlap with a conflicting system to show
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    finished[N] = clock_ticks.fetch_add(1);
+}
+
+template <size_t N>
+System MakeSystem() {
+    return System::FromFamilyOf<Position>(Record<N>);
+}
+
+// expected holds indices into ids, the same as N in Record<N>
+void CheckOrder(World& world,
+                const std::vector<SystemId>& ids,
+                const std::vector<std::vector<size_t>>& expected) {
+    std::vector<std::vector<SystemId>> stages = world.GetStages();
+    if (!VERNA_CHECK(stages.size() == expected.size()))
+        return;
+    for (size_t s = 0; s < stages.size(); s++) {
+        std::vector<SystemId> expected_ids;
+        for (size_t label : expected[s])
+            expected_ids.push_back(ids[label]);
+        VERNA_CHECK(stages[s] == expected_ids);
+    }
+    for (int run = 0; run < RUNS; run++) {
+        started.fill(0);
+        finished.fill(0);
+        world.RunSystems(DeltaTime<float, Seconds>(0.0f));
+        for (size_t s = 0; s + 1 < expected.size(); s++)
+            for (size_t before : expected[s])
+                for (size_t after : expected[s + 1])
+                    VERNA_CHECK(finished[before] < started[after]);
+    }
+}
+}  // namespace
+
+int main() {
+    World world;
+    world.NewEntity<Position, Velocity, Health>();
+    std::vector<SystemId> ids;
+    auto add = [&](const System& system) {
+        world.AddSystem(system);
+        ids.push_back(system.Id());
+    };
+    add(MakeSystem<0>());
+    add(MakeSystem<1>().Reads<Position>());
+    add(MakeSystem<2>().Reads<Position, Velocity>());
+    add(MakeSystem<3>().Writes<Velocity>());
+    add(MakeSystem<4>().Reads<Position>().Writes<Health>());
+    add(MakeSystem<5>().Reads<Velocity>());
+    add(MakeSystem<6>());
+    add(MakeSystem<7>().Reads<Health>());
+    // 0 and 6 declare nothing: they split the others. 3 writes what 2 reads,
+    // 5 reads what 3 writes, 4 doesn't conflict with 1, 2 nor 3
+    CheckOrder(world, ids, {{0}, {1, 2, 4}, {3}, {5}, {6}, {7}});
+
+    // without 6, 7 only waits for 4 (which writes what it reads)
+    world.RemoveSystem(ids[6]);
+    CheckOrder(world, ids, {{0}, {1, 2, 4}, {3, 7}, {5}});
+    return test::Result();
+}
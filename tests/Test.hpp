@@ -0,0 +1,48 @@
+#ifndef VERNA_TEST_HPP
+#define VERNA_TEST_HPP
+
+/**
+ * @brief Checks for the viverna tests. Every test is an executable, run by
+ * ctest, that returns non-zero when one of its checks failed:
+ *
+ * int main() {
+ *     VERNA_CHECK(1 + 1 == 2);
+ *     return verna::test::Result();
+ * }
+ * Tests run on the null backend, next to the assets of the build (see
+ * tests/CMakeLists.txt).
+ *
+ */
+
+#include <cstdio>
+
+namespace verna::test {
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline bool Check(bool condition,
+                  const char* expression,
+                  const char* file,
+                  int line) {
+    if (!condition) {
+        std::printf("%s:%d: check failed: %s\n", file, line, expression);
+        Failures()++;
+    }
+    return condition;
+}
+
+// exit code of the test
+inline int Result() {
+    if (Failures() == 0)
+        return 0;
+    std::printf("%d checks failed\n", Failures());
+    return 1;
+}
+}  // namespace verna::test
+
+#define VERNA_CHECK(condition) \
+    verna::test::Check((condition), #condition, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,150 @@
+#include "Test.hpp"
+#include <viverna/core/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Lots of small jobs on the work-stealing pool, nested or not, and more tasks
+// than a worker deque can hold: every index must run exactly once, and every
+// Wait must return
+
+namespace {
+using namespace verna;
+
+// More than a worker deque holds (see ThreadPool.cpp)
+constexpr size_t OVERFLOW_TASKS = 10000;
+
+struct Hits {
+    std::vector<std::atomic<uint32_t>> counts;
+    explicit Hits(size_t n) : counts(n) {}
+    void Hit(size_t i) { counts[i].fetch_add(1, std::memory_order_relaxed); }
+    bool AllOnce() const {
+        for (const auto& count : counts)
+            if (count.load() != 1)
+                return false;
+        return true;
+    }
+};
+
+void CheckGroups() {
+    constexpr size_t GROUPS = 2000;
+    constexpr size_t TASKS = 8;
+    Hits hits(GROUPS * TASKS);
+    for (size_t g = 0; g < GROUPS; g++) {
+        TaskGroup group;
+        for (size_t t = 0; t < TASKS; t++)
+            group.Run([&hits, i = g * TASKS + t] { hits.Hit(i); });
+        group.Wait();
+    }
+    VERNA_CHECK(hits.AllOnce());
+}
+
+void CheckParallelFor() {
+    ThreadPool& pool = ThreadPool::Get();
+    for (size_t count : {0, 1, 2, 7, 100, 1001, 65536}) {
+        for (size_t grain : {0, 1, 3, 64, 100000}) {
+            Hits hits(count);
+            // checked on the calling thread, the test checks aren't atomic
+            std::atomic<bool> bad_range = false;
+            pool.ParallelFor(0, count, grain, [&](size_t begin, size_t end) {
+                if (begin >= end || end - begin > std::max<size_t>(grain, 1))
+                    bad_range.store(true);
+                for (size_t i = begin; i < end; i++)
+                    hits.Hit(i);
+            });
+            VERNA_CHECK(!bad_range.load());
+            VERNA_CHECK(hits.AllOnce());
+        }
+    }
+    // not starting at 0
+    Hits hits(100);
+    pool.ParallelFor(40, 100, 7, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            hits.Hit(i);
+    });
+    for (size_t i = 0; i < 100; i++)
+        VERNA_CHECK(hits.counts[i].load() == (i >= 40 ? 1u : 0u));
+}
+
+// Groups and ParallelFor inside tasks, waited on by pool threads
+void CheckNested() {
+    constexpr size_t OUTER = 64;
+    constexpr size_t INNER = 16;
+    constexpr size_t RANGE = 256;
+    ThreadPool& pool = ThreadPool::Get();
+    Hits group_hits(OUTER * INNER);
+    Hits range_hits(OUTER * RANGE);
+    TaskGroup outer;
+    for (size_t o = 0; o < OUTER; o++) {
+        outer.Run([&, o] {
+            TaskGroup inner;
+            for (size_t i = 0; i < INNER; i++)
+                inner.Run([&, n = o * INNER + i] { group_hits.Hit(n); });
+            pool.ParallelFor(o * RANGE, (o + 1) * RANGE, 8,
+                             [&](size_t begin, size_t end) {
+                                 for (size_t i = begin; i < end; i++)
+                                     range_hits.Hit(i);
+                             });
+            inner.Wait();
+        });
+    }
+    outer.Wait();
+    VERNA_CHECK(group_hits.AllOnce());
+    VERNA_CHECK(range_hits.AllOnce());
+
+    Hits for_hits(128 * 128);
+    pool.ParallelFor(0, 128, 1, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++)
+            pool.ParallelFor(row * 128, (row + 1) * 128, 16,
+                             [&](size_t b, size_t e) {
+                                 for (size_t i = b; i < e; i++)
+                                     for_hits.Hit(i);
+                             });
+    });
+    VERNA_CHECK(for_hits.AllOnce());
+}
+
+// A single worker pushes more tasks than its deque can hold. The tasks wait
+// for a gate, so thieves can't keep the deque from filling up: the rest goes
+// through the injection queue
+void CheckOverflow() {
+    Hits hits(OVERFLOW_TASKS);
+    std::atomic<bool> gate = false;
+    std::atomic<bool> done = false;
+    bool on_worker = false;
+    // the main thread stays out of the pool, so the producer runs on a worker
+    ThreadPool::Get().Submit([&] {
+        on_worker = ThreadPool::IsWorkerThread();
+        TaskGroup group;
+        for (size_t i = 0; i < OVERFLOW_TASKS; i++) {
+            group.Run([&, i] {
+                while (!gate.load())
+                    std::this_thread::yield();
+                hits.Hit(i);
+            });
+        }
+        gate.store(true);
+        group.Wait();
+        done.store(true);
+    });
+    while (!done.load())
+        std::this_thread::yield();
+    VERNA_CHECK(on_worker);
+    VERNA_CHECK(hits.AllOnce());
+}
+}  // namespace
+
+int main() {
+    VERNA_CHECK(ThreadPool::Get().NumThreads() > 0);
+    for (int repeat = 0; repeat < 4; repeat++) {
+        CheckGroups();
+        CheckParallelFor();
+        CheckNested();
+        CheckOverflow();
+    }
+    return test::Result();
+}